@@ -146,6 +146,14 @@ class Genode::Signal_broker
 			 * directly via the kernel.
 			 */
 		}
+
+		/*
+		 * Signals are delivered by the kernel, which leaves no room for
+		 * coalescing submissions via signal slots.
+		 */
+		bool signal_page(Capability<Dataspace>) { return false; }
+
+		unsigned signal_slot(Signal_context_capability) { return 0; }
 };
 
 #endif /* _CORE__INCLUDE__SIGNAL_BROKER_H_ */
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2011-2013 Genode Labs GmbH
+ * Copyright (C) 2011-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -51,6 +51,38 @@ inline int lx_dup(int fd)
 }
 
 
+enum { LX_MFD_CLOEXEC = 0x1U, LX_MFD_HUGETLB = 0x4U };
+
+
+/**
+ * Create anonymous file
+ *
+ * \return file descriptor, or negative error code if the kernel or the
+ *         C library used at build time lacks support for 'memfd_create'
+ */
+inline int lx_memfd_create(char const *name, unsigned flags)
+{
+#ifdef SYS_memfd_create
+	return lx_syscall(SYS_memfd_create, name, flags);
+#else
+	enum { LX_ENOSYS = 38 };
+	return -LX_ENOSYS;
+#endif
+}
+
+
+/**
+ * Allocate the backing store of a file range
+ *
+ * \return 0 on success, or negative error code, e.g., if the pool of
+ *         huge pages cannot back a range of a hugetlb file
+ */
+inline int lx_fallocate(int fd, int mode, off_t offset, off_t len)
+{
+	return lx_syscall(SYS_fallocate, fd, mode, offset, len);
+}
+
+
 /*******************************************************
  ** Functions used by core's rom-session support code **
  *******************************************************/
@@ -0,0 +1,234 @@
+/*
+ * \brief  Mechanism to deliver signals via core
+ * \author Norman Feske
+ * \date   2016-01-04
+ *
+ * On Linux, submitters may coalesce signals in a page of signal slots
+ * shared with core.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _CORE__INCLUDE__SIGNAL_BROKER_H_
+#define _CORE__INCLUDE__SIGNAL_BROKER_H_
+
+/* Genode includes */
+#include <util/bit_allocator.h>
+#include <dataspace/capability.h>
+
+/* core includes */
+#include <signal_source_component.h>
+#include <signal_source/capability.h>
+
+namespace Genode { class Signal_broker; }
+
+class Genode::Signal_broker : private Signal_slot_ref::Owner
+{
+	private:
+
+		/**
+		 * Slot of the page assigned to a signal context
+		 */
+		struct Slot : Signal_slot_ref
+		{
+			unsigned const      id;
+			List_element<Slot>  owner_le { this };
+
+			Slot(Owner &owner, Signal_context_component &context,
+			     int volatile &slot, unsigned id)
+			: Signal_slot_ref(owner, context, slot), id(id) { }
+		};
+
+		Allocator                        &_md_alloc;
+		Rpc_entrypoint                   &_source_ep;
+		Rpc_entrypoint                   &_context_ep;
+		Signal_source_component           _source;
+		Signal_source_capability          _source_cap;
+		Tslab<Signal_context_component,
+		      960*sizeof(long)>           _contexts_slab { &_md_alloc };
+
+		/*
+		 * Page of signal slots provided by the PD for the signals it
+		 * submits, protected by 'Signal_slot_ref::lock'
+		 */
+		Capability<Dataspace>             _slot_page;
+		int volatile                     *_slots = nullptr;
+		Bit_allocator<Signal_slot::NUM>   _slot_alloc;
+		unsigned                          _slot_key = 0;
+		List<List_element<Slot> >         _slot_list;
+
+		/**
+		 * Attach page of signal slots to core
+		 *
+		 * \return local address, or nullptr if 'page' is not suitable
+		 */
+		int volatile *_attach_slot_page(Capability<Dataspace> page);
+
+		void _detach_slot_page();
+
+		void _free_slot(Slot &slot)
+		{
+			Signal_slot::invalidate(slot.slot);
+			_slot_alloc.free(Signal_slot::index(slot.id));
+			_slot_list.remove(&slot.owner_le);
+			destroy(&_md_alloc, &slot);
+		}
+
+		/**
+		 * Signal_slot_ref::Owner interface
+		 */
+		void release(Signal_slot_ref &ref) override {
+			_free_slot(static_cast<Slot &>(ref)); }
+
+	public:
+
+		class Invalid_signal_source : public Exception { };
+
+		Signal_broker(Allocator      &md_alloc,
+		              Rpc_entrypoint &source_ep,
+		              Rpc_entrypoint &context_ep)
+		:
+			_md_alloc(md_alloc),
+			_source_ep(source_ep),
+			_context_ep(context_ep),
+			_source(&_context_ep),
+			_source_cap(_source_ep.manage(&_source))
+		{ }
+
+		~Signal_broker()
+		{
+			/* release the signal slots of the PD */
+			{
+				Lock::Guard guard(Signal_slot_ref::lock());
+
+				while (List_element<Slot> *le = _slot_list.first()) {
+					Slot &slot = *le->object();
+					slot.context.remove_slot_ref(slot);
+					_free_slot(slot);
+				}
+
+				_detach_slot_page();
+			}
+
+			/* remove source from entrypoint */
+			_source_ep.dissolve(&_source);
+
+			/* free all signal contexts */
+			while (Signal_context_component *r = _contexts_slab.first_object())
+				free_context(r->cap());
+		}
+
+		Signal_source_capability alloc_signal_source() { return _source_cap; }
+
+		void free_signal_source(Signal_source_capability) { }
+
+		Signal_context_capability
+		alloc_context(Signal_source_capability, unsigned long imprint)
+		{
+			/*
+			 * XXX  For now, we ignore the signal-source argument as we
+			 *      create only a single receiver for each PD.
+			 */
+			Signal_context_component *context = new (&_contexts_slab)
+				Signal_context_component(imprint, &_source);
+
+			return _context_ep.manage(context);
+		}
+
+		void free_context(Signal_context_capability context_cap)
+		{
+			Signal_context_component *context = nullptr;
+
+			_context_ep.apply(context_cap, [&] (Signal_context_component *c) {
+
+				if (!c) {
+					warning("specified signal-context capability has wrong type");
+					return;
+				}
+
+				context = c;
+
+				_context_ep.dissolve(context);
+			});
+
+			if (context)
+				destroy(&_contexts_slab, context);
+		}
+
+		void submit(Signal_context_capability cap, unsigned cnt)
+		{
+			_source_ep.apply(cap, [&] (Signal_context_component *context) {
+				if (!context) {
+					warning("invalid signal-context capability");
+					return;
+				}
+
+				context->source()->submit(context, cnt);
+			});
+		}
+
+		bool signal_page(Capability<Dataspace> page)
+		{
+			Lock::Guard guard(Signal_slot_ref::lock());
+
+			/* the page cannot be replaced while slots are assigned */
+			if (_slots)
+				return false;
+
+			_slots = _attach_slot_page(page);
+			return _slots != nullptr;
+		}
+
+		unsigned signal_slot(Signal_context_capability cap)
+		{
+			unsigned id = 0;
+
+			_source_ep.apply(cap, [&] (Signal_context_component *context) {
+
+				Lock::Guard guard(Signal_slot_ref::lock());
+
+				if (!context || !_slots)
+					return;
+
+				if (Signal_slot_ref *ref = context->slot_ref(*this)) {
+					id = static_cast<Slot *>(ref)->id;
+					return;
+				}
+
+				unsigned index = 0;
+				try { index = _slot_alloc.alloc(); }
+				catch (Bit_allocator<Signal_slot::NUM>::Out_of_indices) {
+					return; }
+
+				/* key 0 marks an unused slot */
+				_slot_key = (_slot_key + 1) & Signal_slot::INDEX_MASK;
+				if (_slot_key == 0)
+					_slot_key = 1;
+
+				Slot *slot = nullptr;
+				try {
+					slot = new (&_md_alloc)
+						Slot(*this, *context, _slots[index],
+						     Signal_slot::id(index, _slot_key));
+				} catch (...) {
+					_slot_alloc.free(index);
+					return;
+				}
+
+				Signal_slot::init(slot->slot, slot->id);
+				_slot_list.insert(&slot->owner_le);
+				context->add_slot_ref(*slot);
+
+				id = slot->id;
+			});
+
+			return id;
+		}
+};
+
+#endif /* _CORE__INCLUDE__SIGNAL_BROKER_H_ */
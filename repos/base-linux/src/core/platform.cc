@@ -242,3 +242,11 @@ bool Region_map_mmap::_dataspace_writable(Dataspace_capability ds_cap)
 	return core_env()->entrypoint()->apply(ds_cap, [] (Dataspace *ds) {
 		return ds ? ds->writable() : false; });
 }
+
+
+/**
+ * Keep core from using signal slots
+ *
+ * Core submits signals via its local PD session only.
+ */
+namespace Genode { bool signal_slots_enabled() { return false; } }
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2006-2013 Genode Labs GmbH
+ * Copyright (C) 2006-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -16,6 +16,8 @@
 
 /* Genode includes */
 #include <base/snprintf.h>
+#include <base/log.h>
+#include <util/string.h>
 
 /* local includes */
 #include <ram_session_component.h>
@@ -33,7 +35,121 @@ using namespace Genode;
 
 static int ram_ds_cnt = 0;  /* counter for creating unique dataspace IDs */
 
-void Ram_session_component::_export_ram_ds(Dataspace_component *ds)
+
+/**
+ * List of Unix environment variables, initialized by the startup code
+ */
+extern char **lx_environ;
+
+
+namespace {
+
+	/**
+	 * Policy for backing RAM dataspaces by huge pages
+	 *
+	 * The policy is selected via core's 'GENODE_HUGE_PAGES' environment
+	 * variable. If set to "hugetlb", dataspaces with a size that is a
+	 * multiple of the huge-page size are taken from the kernel's pool of
+	 * reserved huge pages (see '/proc/sys/vm/nr_hugepages'). The huge pages
+	 * are allocated when the dataspace is created. If the pool cannot back
+	 * the whole dataspace, regular pages are used instead.
+	 *
+	 * Note that the kernel refuses mappings of hugetlb dataspaces at
+	 * offsets, sizes, or local addresses that are not aligned to the
+	 * huge-page size. Hence, the policy suits scenarios where such
+	 * dataspaces are attached as a whole at addresses chosen by the
+	 * region map, which are aligned by the kernel.
+	 *
+	 * Otherwise, dataspaces are backed by regular shared memory. Whether
+	 * large mappings of such dataspaces use transparent huge pages depends
+	 * on the kernel's 'shmem_enabled' setting. Processes advise the kernel
+	 * about the use of huge pages when attaching large dataspaces.
+	 */
+	struct Huge_page_policy
+	{
+		enum { HUGE_PAGE_SIZE = 2*1024*1024 };
+
+		bool const hugetlb;
+
+		static bool _hugetlb_configured()
+		{
+			char const *key = "GENODE_HUGE_PAGES=hugetlb";
+
+			for (char **curr = lx_environ; curr && *curr; curr++)
+				if (Genode::strcmp(*curr, key) == 0)
+					return true;
+
+			return false;
+		}
+
+		Huge_page_policy() : hugetlb(_hugetlb_configured()) { }
+
+		bool use_hugetlb(size_t size) const
+		{
+			return hugetlb && size >= HUGE_PAGE_SIZE
+			               && (size % HUGE_PAGE_SIZE) == 0;
+		}
+	};
+}
+
+
+static Huge_page_policy const &huge_page_policy()
+{
+	static Huge_page_policy policy;
+	return policy;
+}
+
+
+/**
+ * Create anonymous memory file of the given size
+ *
+ * \return file descriptor, or -1 if 'memfd_create' is not supported
+ */
+static int memfd_ram_ds(size_t size)
+{
+	static bool memfd_supported = true;
+	if (!memfd_supported)
+		return -1;
+
+	if (huge_page_policy().use_hugetlb(size)) {
+
+		int const fd = lx_memfd_create("ds", LX_MFD_CLOEXEC | LX_MFD_HUGETLB);
+		if (fd >= 0) {
+
+			/*
+			 * Truncating a hugetlb file succeeds regardless of the pool
+			 * of huge pages. A lack of huge pages would show up only when
+			 * a process maps the dataspace. Hence, allocate the huge
+			 * pages of the whole dataspace up front.
+			 */
+			if (lx_ftruncate(fd, size) == 0 && lx_fallocate(fd, 0, 0, size) == 0)
+				return fd;
+
+			lx_close(fd);
+		}
+
+		/* fall back to regular pages */
+	}
+
+	int const fd = lx_memfd_create("ds", LX_MFD_CLOEXEC);
+	if (fd < 0) {
+		warning("memfd_create not supported, using ", resource_path(),
+		        " for RAM dataspaces");
+		memfd_supported = false;
+		return -1;
+	}
+
+	lx_ftruncate(fd, size);
+	return fd;
+}
+
+
+/**
+ * Create file in the resource path as backing store of a RAM dataspace
+ *
+ * This variant is used as a fallback on kernels that lack 'memfd_create'.
+ */
+static int file_ram_ds(size_t size)
 {
 	char fname[Linux_dataspace::FNAME_LEN];
 
@@ -41,10 +157,7 @@ void Ram_session_component::_export_ram_ds(Dataspace_component *ds)
 	snprintf(fname, sizeof(fname), "%s/ds-%d", resource_path(), ram_ds_cnt++);
 	lx_unlink(fname);
 	int const fd = lx_open(fname, O_CREAT|O_RDWR|O_TRUNC|LX_O_CLOEXEC, S_IRWXU);
-	lx_ftruncate(fd, ds->size());
-
-	/* remember file descriptor in dataspace component object */
-	ds->fd(fd);
+	lx_ftruncate(fd, size);
 
 	/*
 	 * Wipe the file from the Linux file system. The kernel will still keep the
@@ -53,6 +166,19 @@ void Ram_session_component::_export_ram_ds(Dataspace_component *ds)
 	 * w/o the right file descriptor won't be able to open and access the file.
 	 */
 	lx_unlink(fname);
+
+	return fd;
+}
+
+
+void Ram_session_component::_export_ram_ds(Dataspace_component *ds)
+{
+	int fd = memfd_ram_ds(ds->size());
+	if (fd < 0)
+		fd = file_ram_ds(ds->size());
+
+	/* remember file descriptor in dataspace component object */
+	ds->fd(fd);
 }
 
 
@@ -0,0 +1,50 @@
+/*
+ * \brief  Linux-specific part of the signal broker
+ * \author Genode Labs
+ * \date   2016-09-20
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* core includes */
+#include <signal_broker.h>
+#include <core_env.h>
+#include <dataspace_component.h>
+
+using namespace Genode;
+
+
+int volatile *Signal_broker::_attach_slot_page(Capability<Dataspace> page)
+{
+	/* core accesses the page, so it must be a writable RAM dataspace */
+	bool const suitable =
+		core_env()->entrypoint()->apply(page, [] (Dataspace_component *ds) {
+			return ds && ds->writable() && ds->size() >= Signal_slot::PAGE_SIZE; });
+
+	if (!suitable)
+		return nullptr;
+
+	try {
+		int volatile * const slots =
+			core_env()->rm_session()->attach(page, Signal_slot::PAGE_SIZE);
+
+		_slot_page = page;
+		return slots;
+
+	} catch (...) { return nullptr; }
+}
+
+
+void Signal_broker::_detach_slot_page()
+{
+	if (_slots)
+		core_env()->rm_session()->detach((void *)_slots);
+
+	_slots     = nullptr;
+	_slot_page = Capability<Dataspace>();
+}
@@ -24,6 +24,7 @@ SRC_CC        = main.cc \
                 core_rpc_cap_alloc.cc \
                 io_mem_session_component.cc \
                 signal_source_component.cc \
+                signal_broker.cc \
                 trace_session_component.cc \
                 thread_linux.cc \
                 stack_area.cc \
@@ -61,7 +61,11 @@ void Thread::_thread_start()
 void Thread::_init_platform_thread(size_t, Type) { }
 
 
-void Thread::_deinit_platform_thread() { }
+void Thread::_deinit_platform_thread()
+{
+	/* release the RPC reply channels of the thread */
+	native_thread().reply_channels.dissolve();
+}
 
 
 void Thread::start()
@@ -22,6 +22,8 @@
 
 /* Genode includes */
 #include <base/thread.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
 
 /* Linux includes */
 #include <linux_syscalls.h>
@@ -30,19 +32,59 @@
 extern int main_thread_futex_counter;
 
 
-static inline void thread_yield()
+/*
+ * The futex counter of a thread holds a wake-up token. The token is posted
+ * by the thread that hands over a lock to the blocked thread and consumed
+ * by the blocked thread. Because a token posted before the recipient went
+ * to sleep is not lost, waking up a thread never has to be retried.
+ */
+
+enum { WAKE_UP_TOKEN = 1 };
+
+
+static inline int *thread_futex_counter(Genode::Thread *thread_base)
+{
+	return thread_base ? &thread_base->native_thread().futex_counter
+	                   : &main_thread_futex_counter;
+}
+
+
+static inline void thread_yield() { lx_sched_yield(); }
+
+
+/**
+ * Post wake-up token to thread without waking it up
+ */
+static inline void thread_post_wake_up(Genode::Thread *thread_base)
 {
-	struct timespec ts = { 0, 1000 };
-	lx_nanosleep(&ts, 0);
+	Genode::memory_barrier();
+	*thread_futex_counter(thread_base) = WAKE_UP_TOKEN;
+}
+
+
+/**
+ * Wake up thread if it sleeps in 'thread_stop_myself'
+ */
+static inline void thread_wake_up(Genode::Thread *thread_base)
+{
+	lx_futex(thread_futex_counter(thread_base), LX_FUTEX_WAKE, 1);
+}
+
+
+/**
+ * Discard wake-up token that was posted to the calling thread
+ */
+static inline void thread_discard_wake_up()
+{
+	*thread_futex_counter(Genode::Thread::myself()) = 0;
 }
 
 
 static inline bool thread_check_stopped_and_restart(Genode::Thread *thread_base)
 {
-	const int *futex_counter_ptr = thread_base ?
-	                               &thread_base->native_thread().futex_counter :
-	                               &main_thread_futex_counter;
-	return lx_futex(futex_counter_ptr, LX_FUTEX_WAKE, 1);
+	thread_post_wake_up(thread_base);
+	thread_wake_up(thread_base);
+	return true;
 }
 
 
@@ -52,18 +94,23 @@ static inline void thread_switch_to(Genode::Thread *thread_base)
 }
 
 
+/**
+ * Block until a wake-up token arrives or the blocking gets canceled
+ */
 static inline void thread_stop_myself()
 {
-	/*
-	 * Just go to sleep without modifying the counter value. The
-	 * 'thread_check_stopped_and_restart()' function will get called
-	 * repeatedly until this thread has actually executed the syscall.
-	 */
-	Genode::Thread *myself = Genode::Thread::myself();
-	const int *futex_counter_ptr = myself ?
-	                               &myself->native_thread().futex_counter :
-	                               &main_thread_futex_counter;
-	lx_futex(futex_counter_ptr, LX_FUTEX_WAIT, 0);
+	enum { LX_EAGAIN = 11 };
+
+	int * const futex_counter_ptr = thread_futex_counter(Genode::Thread::myself());
+
+	while (!Genode::cmpxchg(futex_counter_ptr, WAKE_UP_TOKEN, 0)) {
+
+		int const ret = lx_futex(futex_counter_ptr, LX_FUTEX_WAIT, 0);
+
+		/* return on cancel-blocking signal */
+		if (ret < 0 && ret != -LX_EAGAIN)
+			return;
+	}
 }
 
 #endif /* _INCLUDE__BASE__INTERNAL__LOCK_HELPER_H_ */
@@ -48,6 +48,63 @@ struct Genode::Native_thread
 
 	Socket_pair socket_pair;
 
+	/**
+	 * Socket pair used for receiving the replies of outgoing RPC calls
+	 *
+	 * The remote socket is handed out to the callee along with each call
+	 * message. A callee may keep the remote socket. Hence, a channel is
+	 * reused only for calls to the same destination, so that a callee
+	 * cannot inject replies into calls to other servers.
+	 */
+	struct Reply_channel
+	{
+		int      dst_sd     = -1; /* destination the channel is used for */
+		int      local_sd   = -1;
+		int      remote_sd  = -1;
+		unsigned generation = 0;  /* registry generation at creation */
+
+		bool valid() const { return local_sd != -1; }
+
+		/**
+		 * Close both sockets of the channel
+		 *
+		 * A reply that is still in flight for the closed channel is
+		 * dropped by the kernel.
+		 */
+		void dissolve();
+	};
+
+	/**
+	 * Reply channels of the most recent call destinations
+	 *
+	 * A destination socket identifies the callee only as long as it is
+	 * not closed. Once closed, its number may be reused for another
+	 * callee. Destination sockets are closed only after they are
+	 * disassociated from the entrypoint-socket registry. Therefore, a
+	 * channel is dissolved on lookup if the registry generation changed
+	 * since the channel was created.
+	 */
+	struct Reply_channels
+	{
+		enum { NUM = 4 };
+
+		Reply_channel channel[NUM];
+		unsigned      victim = 0;
+
+		/**
+		 * Return channel for calls to 'dst_sd'
+		 *
+		 * \param generation  current generation of the entrypoint-socket
+		 *                    registry
+		 *
+		 * The returned channel is not valid if it must be created first.
+		 */
+		Reply_channel &lookup(int dst_sd, unsigned generation);
+
+		void dissolve();
+
+	} reply_channels;
+
 	Native_thread() { }
 };
 
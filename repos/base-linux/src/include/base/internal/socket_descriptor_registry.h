@@ -11,7 +11,7 @@
  */
 
 /*
- * Copyright (C) 2012-2013 Genode Labs GmbH
+ * Copyright (C) 2012-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -68,6 +68,12 @@ class Genode::Socket_descriptor_registry
 
 		Genode::Lock mutable _lock;
 
+		/*
+		 * Number of disassociations, incremented before a socket
+		 * descriptor may be closed and its number be reused
+		 */
+		unsigned volatile _generation = 0;
+
 		Entry &_find_free_entry()
 		{
 			for (unsigned i = 0; i < MAX_FDS; i++)
@@ -106,6 +112,8 @@ class Genode::Socket_descriptor_registry
 		{
 			Genode::Lock::Guard guard(_lock);
 
+			_generation = _generation + 1;
+
 			for (unsigned i = 0; i < MAX_FDS; i++)
 				if (_entries[i].fd == sd) {
 					_entries[i].mark_as_free();
@@ -113,6 +121,14 @@ class Genode::Socket_descriptor_registry
 				}
 		}
 
+		/**
+		 * Return number of disassociations so far
+		 *
+		 * State that is keyed by socket-descriptor numbers is stale if
+		 * the generation changed meanwhile.
+		 */
+		unsigned generation() const { return _generation; }
+
 		/**
 		 * Try to associate socket descriptor with corresponding ID
 		 *
@@ -345,6 +345,86 @@ static inline void lx_reply(int reply_socket, Rpc_exception_code exception_code,
 }
 
 
+/*******************
+ ** Reply channel **
+ *******************/
+
+void Native_thread::Reply_channel::dissolve()
+{
+	if (local_sd  != -1) lx_close(local_sd);
+	if (remote_sd != -1) lx_close(remote_sd);
+
+	local_sd = remote_sd = dst_sd = -1;
+}
+
+
+Native_thread::Reply_channel &
+Native_thread::Reply_channels::lookup(int dst_sd, unsigned generation)
+{
+	/* drop channels whose destination may have been closed meanwhile */
+	for (unsigned i = 0; i < NUM; i++)
+		if (channel[i].valid() && channel[i].generation != generation)
+			channel[i].dissolve();
+
+	for (unsigned i = 0; i < NUM; i++)
+		if (channel[i].valid() && channel[i].dst_sd == dst_sd)
+			return channel[i];
+
+	/* replace the channels in round-robin fashion */
+	Reply_channel &c = channel[victim];
+	victim = (victim + 1) % NUM;
+
+	c.dissolve();
+	return c;
+}
+
+
+void Native_thread::Reply_channels::dissolve()
+{
+	for (unsigned i = 0; i < NUM; i++)
+		channel[i].dissolve();
+}
+
+
+/**
+ * Return reply channel of the calling thread for the given destination
+ *
+ * The main thread has no 'Thread' object and, therefore, no 'Native_thread'.
+ * Its reply channels are kept in a static object instead.
+ */
+static Native_thread::Reply_channel &reply_channel_of_myself(int dst_sd)
+{
+	unsigned const generation = Genode::ep_sd_registry()->generation();
+
+	Thread * const myself = Thread::myself();
+	if (myself)
+		return myself->native_thread().reply_channels.lookup(dst_sd, generation);
+
+	static Native_thread::Reply_channels main_thread_reply_channels;
+	return main_thread_reply_channels.lookup(dst_sd, generation);
+}
+
+
+static void create_reply_channel(Native_thread::Reply_channel &channel,
+                                 int dst_sd)
+{
+	unsigned const generation = Genode::ep_sd_registry()->generation();
+
+	int sd[2] = { -1, -1 };
+
+	int const ret = lx_socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sd);
+	if (ret < 0) {
+		PRAW("[%d] lx_socketpair failed with %d", lx_getpid(), ret);
+		throw Genode::Ipc_error();
+	}
+
+	channel.dst_sd     = dst_sd;
+	channel.local_sd   = sd[0];
+	channel.remote_sd  = sd[1];
+	channel.generation = generation;
+}
+
+
 /****************
  ** IPC client **
  ****************/
@@ -359,48 +439,22 @@ Rpc_exception_code Genode::ipc_call(Native_capability dst,
 	Message snd_msg(snd_header.msg_start(),
 	                sizeof(Protocol_header) + snd_msgbuf.data_size());
 
-	/*
-	 * Create reply channel
-	 *
-	 * The reply channel will be closed when leaving the scope of 'lx_call'.
-	 */
-	struct Reply_channel
-	{
-		enum { LOCAL_SOCKET = 0, REMOTE_SOCKET = 1 };
-		int sd[2];
-
-		Reply_channel()
-		{
-			sd[LOCAL_SOCKET] = -1; sd[REMOTE_SOCKET] = -1;
-
-			int ret = lx_socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sd);
-			if (ret < 0) {
-				PRAW("[%d] lx_socketpair failed with %d", lx_getpid(), ret);
-				throw Genode::Ipc_error();
-			}
-		}
-
-		~Reply_channel()
-		{
-			if (sd[LOCAL_SOCKET]  != -1) lx_close(sd[LOCAL_SOCKET]);
-			if (sd[REMOTE_SOCKET] != -1) lx_close(sd[REMOTE_SOCKET]);
-		}
+	int const dst_socket = Capability_space::ipc_cap_data(dst).dst.socket;
 
-		int local_socket()  const { return sd[LOCAL_SOCKET];  }
-		int remote_socket() const { return sd[REMOTE_SOCKET]; }
+	Native_thread::Reply_channel &reply_channel =
+		reply_channel_of_myself(dst_socket);
 
-	} reply_channel;
+	if (!reply_channel.valid())
+		create_reply_channel(reply_channel, dst_socket);
 
 	/* assemble message */
 
 	/* marshal reply capability */
-	snd_msg.marshal_socket(reply_channel.remote_socket());
+	snd_msg.marshal_socket(reply_channel.remote_sd);
 
 	/* marshal capabilities contained in 'snd_msgbuf' */
 	insert_sds_into_message(snd_msg, snd_header, snd_msgbuf);
 
-	int const dst_socket = Capability_space::ipc_cap_data(dst).dst.socket;
-
 	int const send_ret = lx_sendmsg(dst_socket, snd_msg.msg(), 0);
 	if (send_ret < 0) {
 		raw(Pid(), " lx_sendmsg to sd ", dst_socket,
@@ -418,7 +472,15 @@ Rpc_exception_code Genode::ipc_call(Native_capability dst,
 	rcv_msg.accept_sockets(Message::MAX_SDS_PER_MSG);
 
 	rcv_msgbuf.reset();
-	int const recv_ret = lx_recvmsg(reply_channel.local_socket(), rcv_msg.msg(), 0);
+	int const recv_ret = lx_recvmsg(reply_channel.local_sd, rcv_msg.msg(), 0);
+
+	/*
+	 * If the call got aborted, the callee may still reply at a later time.
+	 * Dissolve the reply channel to prevent such a stale reply from being
+	 * mistaken as the reply of the next call.
+	 */
+	if (recv_ret < 0)
+		reply_channel.dissolve();
 
 	/* system call got interrupted by a signal */
 	if (recv_ret == -LX_EINTR)
@@ -0,0 +1,228 @@
+/*
+ * \brief  Linux-specific lock implementation
+ * \author Genode Labs
+ * \date   2016-08-28
+ *
+ * The lock follows the generic implementation but takes advantage of the
+ * futex-based wake-up tokens provided by 'lock_helper.h':
+ *
+ * - Before blocking, a thread spins for a bounded number of iterations as
+ *   long as the lock is held but no other applicant is queued. Once an
+ *   applicant is queued, the lock is handed over in FIFO order so that
+ *   spinning cannot succeed anymore.
+ *
+ * - The lock is handed over directly to the next applicant by posting a
+ *   wake-up token while holding the spinlock. The new owner discards the
+ *   token after observing its ownership, which prevents a token posted to
+ *   a thread that returned early because of a cancel-blocking signal from
+ *   surviving to the next time the thread blocks.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/cancelable_lock.h>
+#include <cpu/memory_barrier.h>
+#include <base/trace/events.h>
+
+/* base-internal includes */
+#include <base/internal/spin_lock.h>
+
+using namespace Genode;
+
+
+enum { SPIN_LIMIT = 1000 };
+
+
+static inline Genode::Thread *invalid_thread_base()
+{
+	return (Genode::Thread*)~0;
+}
+
+
+static inline bool thread_base_valid(Genode::Thread *thread_base)
+{
+	return (thread_base != invalid_thread_base());
+}
+
+
+/********************
+ ** Lock applicant **
+ ********************/
+
+void Cancelable_lock::Applicant::wake_up()
+{
+	if (!thread_base_valid(_thread_base)) return;
+
+	thread_check_stopped_and_restart(_thread_base);
+}
+
+
+/*********************
+ ** Cancelable lock **
+ *********************/
+
+/**
+ * Generate trace event if the lock is held by another thread
+ *
+ * The lock state is inspected without holding the spinlock because the
+ * event must not be generated while being enqueued as applicant. The trace
+ * logger may take locks itself when evaluating the tracing condition.
+ * Locks that are used as blocking primitive, i.e., locked twice by the same
+ * thread, are not reported.
+ *
+ * \return  true if a 'Lock_wait' event was generated
+ */
+bool Cancelable_lock::_trace_contention(Thread *myself)
+{
+	if (_state != LOCKED)
+		return false;
+
+	Thread * const holder = _owner.thread_base();
+	if (!thread_base_valid(holder) || holder == myself)
+		return false;
+
+	Trace::Lock_wait trace_event(this, holder);
+	return true;
+}
+
+
+void Cancelable_lock::lock()
+{
+	Applicant myself(Thread::myself());
+
+	bool const contended = _trace_contention(myself.thread_base());
+
+	/*
+	 * Spin while the lock is held by a thread that may release it soon. A
+	 * queued applicant indicates that the lock will be handed over to the
+	 * applicant, not released.
+	 */
+	for (unsigned i = 0; i < SPIN_LIMIT; i++) {
+
+		if (_state == UNLOCKED || _last_applicant != &_owner)
+			break;
+
+		memory_barrier();
+	}
+
+	spinlock_lock(&_spinlock_state);
+
+	/* reset ownership if one thread 'lock' twice */
+	if (_owner == myself)
+		_owner = Applicant(invalid_thread_base());
+
+	if (cmpxchg(&_state, UNLOCKED, LOCKED)) {
+
+		/* we got the lock */
+		_owner          =  myself;
+		_last_applicant = &_owner;
+		spinlock_unlock(&_spinlock_state);
+
+		if (contended) { Trace::Lock_acquired trace_event(this); }
+		return;
+	}
+
+	/*
+	 * We failed to grab the lock, lets add ourself to the
+	 * list of applicants and block for the current lock holder.
+	 */
+	_last_applicant->applicant_to_wake_up(&myself);
+	_last_applicant = &myself;
+	spinlock_unlock(&_spinlock_state);
+
+	/*
+	 * If the lock holder hands over the lock before we went to sleep, the
+	 * posted wake-up token makes 'thread_stop_myself' return immediately.
+	 */
+	thread_stop_myself();
+
+	/*
+	 * We expect to be the lock owner when woken up. If this is not
+	 * the case, the blocking was canceled via core's cancel-blocking
+	 * mechanism. We have to dequeue ourself from the list of applicants
+	 * and reflect this condition as a C++ exception.
+	 */
+	spinlock_lock(&_spinlock_state);
+	if (_owner != myself) {
+		/*
+		 * Check if we are the applicant to be waken up next,
+		 * otherwise, go through the list of remaining applicants
+		 */
+		for (Applicant *a = &_owner; a; a = a->applicant_to_wake_up()) {
+			/* remove reference to ourself from the applicants list */
+			if (a->applicant_to_wake_up() == &myself) {
+				a->applicant_to_wake_up(myself.applicant_to_wake_up());
+				if (_last_applicant == &myself)
+					_last_applicant = a;
+				break;
+			}
+		}
+
+		spinlock_unlock(&_spinlock_state);
+
+		throw Blocking_canceled();
+	}
+
+	/* the token was posted while the lock got handed over to us */
+	thread_discard_wake_up();
+
+	spinlock_unlock(&_spinlock_state);
+
+	if (contended) { Trace::Lock_acquired trace_event(this); }
+}
+
+
+void Cancelable_lock::unlock()
+{
+	spinlock_lock(&_spinlock_state);
+
+	Applicant *next_owner = _owner.applicant_to_wake_up();
+
+	if (next_owner) {
+
+		/* transfer lock ownership to next applicant and wake him up */
+		_owner = *next_owner;
+
+		/* make copy since _owner may change outside spinlock ! */
+		Applicant owner = *next_owner;
+
+		if (_last_applicant == next_owner)
+			_last_applicant = &_owner;
+
+		Thread * const thread_base = owner.thread_base();
+		if (thread_base_valid(thread_base))
+			thread_post_wake_up(thread_base);
+
+		spinlock_unlock(&_spinlock_state);
+
+		if (thread_base_valid(thread_base))
+			thread_wake_up(thread_base);
+
+	} else {
+
+		/* there is no further applicant, leave the lock alone */
+		_owner          = Applicant(invalid_thread_base());
+		_last_applicant = 0;
+		_state          = UNLOCKED;
+
+		spinlock_unlock(&_spinlock_state);
+	}
+}
+
+
+Cancelable_lock::Cancelable_lock(Cancelable_lock::State initial)
+:
+	_spinlock_state(SPINLOCK_UNLOCKED),
+	_state(UNLOCKED),
+	_last_applicant(0),
+	_owner(invalid_thread_base())
+{
+	if (initial == LOCKED)
+		lock();
+}
@@ -145,6 +145,15 @@ void *Region_map_mmap::_map_local(Dataspace_capability ds,
 		throw Region_map::Region_conflict();
 	}
 
+	/*
+	 * Allow the kernel to back large data mappings by transparent huge
+	 * pages. The advice has no effect if the kernel does not support huge
+	 * pages for shared memory.
+	 */
+	enum { HUGE_PAGE_SIZE = 2*1024*1024, LX_MADV_HUGEPAGE = 14 };
+	if (size >= HUGE_PAGE_SIZE && !executable)
+		lx_madvise(addr_out, size, LX_MADV_HUGEPAGE);
+
 	return addr_out;
 }
 
@@ -0,0 +1,221 @@
+/*
+ * \brief  Linux-specific signal submission via shared signal slots
+ * \author Genode Labs
+ * \date   2016-08-27
+ *
+ * Submitting a signal to a context that is already pending at the receiver
+ * is accounted in the signal slot of the context, which resides in a page
+ * shared with core. Only the submission that makes the context pending is
+ * forwarded to core, which drains the slots of the context when delivering
+ * the signal. The page belongs to the submitter, so a submitter cannot
+ * tamper with the signals of other submitters.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/signal.h>
+#include <base/env.h>
+#include <base/lock.h>
+#include <base/trace/events.h>
+
+/* base-internal includes */
+#include <base/internal/signal_slot.h>
+
+using namespace Genode;
+
+
+namespace Genode {
+
+	/*
+	 * Core submits signals via its local PD session and, therefore,
+	 * overrides this function.
+	 */
+	bool signal_slots_enabled() __attribute__((weak));
+	bool signal_slots_enabled() { return true; }
+}
+
+
+namespace {
+
+	/**
+	 * Page of signal slots of the component and the slot IDs of recently
+	 * used contexts
+	 */
+	class Signal_slot_cache
+	{
+		private:
+
+			enum { NUM_ENTRIES = 16 };
+
+			struct Entry
+			{
+				long     name = 0;  /* local name of context cap */
+				unsigned id   = 0;  /* slot ID, 0 if context has no slot */
+
+				bool used() const { return name != 0; }
+			};
+
+			Lock     _lock;
+			Entry    _entries[NUM_ENTRIES];
+			unsigned _next = 0;
+
+			Ram_dataspace_capability _page_ds;
+			int volatile            *_slots    = nullptr;
+			bool                     _disabled = false;
+
+			/**
+			 * Provide page of signal slots to core on first use
+			 */
+			bool _init_page()
+			{
+				if (_slots)
+					return true;
+
+				if (_disabled)
+					return false;
+
+				/* try only once, even if the platform lacks support */
+				_disabled = true;
+
+				try {
+					_page_ds = env()->ram_session()->alloc(Signal_slot::PAGE_SIZE);
+					_slots   = env()->rm_session()->attach(_page_ds);
+				} catch (...) {
+					_release_page();
+					return false;
+				}
+
+				if (!env()->pd_session()->signal_page(_page_ds)) {
+					_release_page();
+					return false;
+				}
+
+				_disabled = false;
+				return true;
+			}
+
+			void _release_page()
+			{
+				if (_slots)
+					env()->rm_session()->detach((void *)_slots);
+
+				if (_page_ds.valid())
+					env()->ram_session()->free(_page_ds);
+
+				_slots   = nullptr;
+				_page_ds = Ram_dataspace_capability();
+			}
+
+			Entry *_lookup(long name)
+			{
+				for (unsigned i = 0; i < NUM_ENTRIES; i++)
+					if (_entries[i].name == name)
+						return &_entries[i];
+
+				return nullptr;
+			}
+
+			Entry &_insert(Signal_context_capability context)
+			{
+				Entry &e = _entries[_next];
+				_next = (_next + 1) % NUM_ENTRIES;
+
+				/*
+				 * A context without slot is cached as well to spare the
+				 * request to core on subsequent submissions.
+				 */
+				e.name = context.local_name();
+				e.id   = env()->pd_session()->signal_slot(context);
+
+				return e;
+			}
+
+		public:
+
+			enum Result { COALESCED, NOTIFY, VIA_CORE };
+
+			/**
+			 * Account signals in the slot of the context
+			 *
+			 * \return  'NOTIFY' if the receiver must be woken up,
+			 *          'VIA_CORE' if the signals must be submitted via core
+			 */
+			Result submit(Signal_context_capability context, unsigned cnt)
+			{
+				Lock::Guard guard(_lock);
+
+				if (!_init_page())
+					return VIA_CORE;
+
+				Entry *e = _lookup(context.local_name());
+				if (!e)
+					e = &_insert(context);
+
+				if (!e->id)
+					return VIA_CORE;
+
+				int volatile &slot = _slots[Signal_slot::index(e->id)];
+				unsigned const key = Signal_slot::key(e->id);
+
+				switch (Signal_slot::submit(slot, key, cnt)) {
+				case Signal_slot::COALESCED: return COALESCED;
+				case Signal_slot::NOTIFY:    return NOTIFY;
+				case Signal_slot::REJECTED:  break;
+				}
+
+				/*
+				 * The slot belongs to another context now or its counter is
+				 * saturated. The former case requires a fresh lookup.
+				 */
+				if (Signal_slot::key((unsigned)slot) != key)
+					*e = Entry();
+
+				return VIA_CORE;
+			}
+	};
+
+	Signal_slot_cache &signal_slot_cache()
+	{
+		static Signal_slot_cache inst;
+		return inst;
+	}
+}
+
+
+/************************
+ ** Signal transmitter **
+ ************************/
+
+void Signal_transmitter::submit(unsigned cnt)
+{
+	{
+		Trace::Signal_submit trace_event(cnt);
+	}
+
+	if (!signal_slots_enabled() || !_context.valid()) {
+		env()->pd_session()->submit(_context, cnt);
+		return;
+	}
+
+	switch (signal_slot_cache().submit(_context, cnt)) {
+
+	case Signal_slot_cache::COALESCED:
+		return;
+
+	case Signal_slot_cache::NOTIFY:
+
+		/* the signals are accounted in the slot, just wake up the receiver */
+		env()->pd_session()->submit(_context, 0);
+		return;
+
+	case Signal_slot_cache::VIA_CORE:
+		env()->pd_session()->submit(_context, cnt);
+		return;
+	}
+}
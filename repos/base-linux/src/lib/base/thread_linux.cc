@@ -128,6 +128,9 @@ void Thread::_deinit_platform_thread()
 		lx_nanosleep(&ts, 0);
 	}
 
+	/* release the RPC reply channels of the thread */
+	native_thread().reply_channels.dissolve();
+
 	/* inform core about the killed thread */
 	_cpu_session->kill_thread(_thread_cap);
 }
@@ -514,6 +514,9 @@ Thread::~Thread()
 			        "with ", ret, " (errno=", errno, ")");
 	}
 
+	/* release the RPC reply channels of the thread */
+	native_thread().reply_channels.dissolve();
+
 	Thread_meta_data_created *meta_data =
 		dynamic_cast<Thread_meta_data_created *>(native_thread().meta_data);
 
@@ -213,6 +213,12 @@ inline int lx_munmap(void *addr, Genode::size_t length)
 }
 
 
+inline int lx_madvise(void *addr, Genode::size_t length, int advice)
+{
+	return lx_syscall(SYS_madvise, addr, length, advice);
+}
+
+
 /***********************************************************************
  ** Functions used by thread lib and core's cancel-blocking mechanism **
  ***********************************************************************/
@@ -338,6 +344,11 @@ inline int lx_nanosleep(const struct timespec *req, struct timespec *rem)
 	return lx_syscall(SYS_nanosleep, req, rem);
 }
 
+inline int lx_sched_yield()
+{
+	return lx_syscall(SYS_sched_yield);
+}
+
 enum {
 	LX_FUTEX_WAIT = FUTEX_WAIT,
 	LX_FUTEX_WAKE = FUTEX_WAKE,
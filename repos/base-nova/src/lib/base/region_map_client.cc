@@ -13,6 +13,7 @@
  */
 
 #include <region_map/client.h>
+#include <base/trace/events.h>
 
 using namespace Genode;
 
@@ -39,7 +40,20 @@ void Region_map_client::fault_handler(Signal_context_capability cap) {
 	call<Rpc_fault_handler>(cap); }
 
 
-Region_map::State Region_map_client::state() { return call<Rpc_state>(); }
+/*
+ * Faults of managed dataspaces are reported by the fault handler that
+ * obtains the fault state because core's threads cannot be traced.
+ */
+Region_map::State Region_map_client::state()
+{
+	State const state = call<Rpc_state>();
+
+	if (state.type != State::READY) {
+		bool const write = (state.type == State::WRITE_FAULT);
+		Trace::Region_map_fault trace_event(state.addr, write);
+	}
+	return state;
+}
 
 
 Dataspace_capability Region_map_client::dataspace()
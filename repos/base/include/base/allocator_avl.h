@@ -50,16 +50,52 @@ class Genode::Allocator_avl_base : public Range_allocator
 
 	protected:
 
+		class Block;
+
+		/**
+		 * Node of the tree of free blocks, which is sorted by block size
+		 *
+		 * Blocks of equal size are ordered by their base address such that
+		 * a search for the smallest fitting block yields the lowest address.
+		 */
+		class Size_node : public Avl_node<Size_node>
+		{
+			private:
+
+				Block &_block;
+
+			public:
+
+				Size_node(Block &block) : _block(block) { }
+
+				Block &block() const { return _block; }
+
+				/**
+				 * Avl_node interface: compare two nodes
+				 */
+				bool higher(Size_node *n);
+
+				/**
+				 * Find smallest block that can hold the specified subblock
+				 */
+				Block *find_best_fit(size_t size, unsigned align,
+				                     addr_t from, addr_t to);
+		};
+
 		class Block : public Avl_node<Block>
 		{
 			private:
 
+				friend class Size_node;
+
 				addr_t _addr;       /* base address    */
 				size_t _size;       /* size of block   */
 				bool   _used;       /* block is in use */
 				short  _id;         /* for debugging   */
 				size_t _max_avail;  /* biggest free block size of subtree */
 
+				Size_node _size_node { *this };
+
 				/**
 				 * Request max_avail value of subtree
 				 */
@@ -111,6 +147,8 @@ class Genode::Allocator_avl_base : public Range_allocator
 
 				inline void used(bool used) { _used = used; }
 
+				inline Size_node &size_node() { return _size_node; }
+
 
 				enum { FREE = false, USED = true };
 
@@ -168,9 +206,10 @@ class Genode::Allocator_avl_base : public Range_allocator
 
 	private:
 
-		Avl_tree<Block>  _addr_tree;      /* blocks sorted by base address */
-		Allocator       *_md_alloc;       /* meta-data allocator           */
-		size_t           _md_entry_size;  /* size of block meta-data entry */
+		Avl_tree<Block>      _addr_tree;      /* blocks sorted by base address */
+		Avl_tree<Size_node>  _size_tree;      /* free blocks sorted by size    */
+		Allocator           *_md_alloc;       /* meta-data allocator           */
+		size_t               _md_entry_size;  /* size of block meta-data entry */
 
 		/**
 		 * Alloc meta-data block
@@ -190,6 +229,12 @@ class Genode::Allocator_avl_base : public Range_allocator
 
 		Block *_find_any_used_block(Block *sub_tree);
 
+		/**
+		 * Find best-fitting free block
+		 */
+		Block *_find_best_fit(size_t size, unsigned align,
+		                      addr_t from, addr_t to);
+
 		/**
 		 * Destroy block
 		 */
@@ -67,6 +67,11 @@ class Genode::Cancelable_lock
 		Applicant* volatile _last_applicant;
 		Applicant  _owner;
 
+		/**
+		 * Generate 'Lock_wait' trace event if the lock is contended
+		 */
+		bool _trace_contention(Thread *myself);
+
 	public:
 
 		enum State { LOCKED, UNLOCKED };
@@ -438,8 +438,10 @@ class Genode::Child : protected Rpc_object<Parent>
 		 * transferred back to our own 'env()->ram_session()' account. Note
 		 * that the specified server object may not exist anymore. We do
 		 * not de-reference the server argument in here!
+		 *
+		 * \return  true if at least one session was discarded
 		 */
-		void revoke_server(const Server *server);
+		bool revoke_server(const Server *server);
 
 		/**
 		 * Instruct the child to yield resources
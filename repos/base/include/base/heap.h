@@ -25,6 +25,7 @@ namespace Genode {
 	
 	class Heap;
 	class Sliced_heap;
+	class Thread_cached_heap;
 }
 
 
@@ -208,4 +209,90 @@ class Genode::Sliced_heap : public Allocator
 		bool   need_size_for_free() const override { return false; }
 };
 
+
+/**
+ * Heap front end that caches small blocks per thread
+ *
+ * Small allocations are served from magazines of free blocks, one magazine
+ * per size class. Each thread is mapped to one of 'NUM_STRIPES' sets of
+ * magazines, each protected by a lock of its own. Hence, concurrent threads
+ * rarely contend for the lock of the underlying heap. Magazines that exceed
+ * their capacity return their surplus blocks to the heap. Allocations larger
+ * than the largest size class are passed through to the heap.
+ */
+class Genode::Thread_cached_heap : public Allocator
+{
+	public:
+
+		enum {
+			NUM_STRIPES         = 8,
+			NUM_SIZE_CLASSES    = 8,
+			MIN_CLASS_SIZE_LOG2 = 4,   /* 16 bytes */
+			MAGAZINE_CAPACITY   = 64,  /* blocks per size class and stripe */
+		};
+
+	private:
+
+		/*
+		 * Each block handed out by the cache is preceded by a header that
+		 * denotes its size class. Blocks passed through to the heap are
+		 * marked with 'NUM_SIZE_CLASSES'.
+		 */
+		struct Header { addr_t size_class; };
+
+		struct Free_block { Free_block *next; };
+
+		struct Magazine
+		{
+			Free_block *first = nullptr;
+			unsigned    count = 0;
+		};
+
+		struct Stripe
+		{
+			Lock     lock;
+			Magazine magazines[NUM_SIZE_CLASSES];
+			size_t   cached_bytes = 0;
+		};
+
+		Heap &_heap;
+
+		Stripe mutable _stripes[NUM_STRIPES];
+
+		static size_t _block_size(unsigned size_class) {
+			return sizeof(Header) + (1UL << (size_class + MIN_CLASS_SIZE_LOG2)); }
+
+		/**
+		 * Return stripe of magazines used by the calling thread
+		 */
+		Stripe &_stripe_of_myself();
+
+		/**
+		 * Return chain of free blocks of the given size class to the heap
+		 */
+		void _release(Free_block *chain, unsigned size_class);
+
+	public:
+
+		Thread_cached_heap(Heap &heap) : _heap(heap) { }
+
+		~Thread_cached_heap() { flush(); }
+
+		/**
+		 * Return all cached blocks to the heap
+		 */
+		void flush();
+
+
+		/*************************
+		 ** Allocator interface **
+		 *************************/
+
+		bool   alloc(size_t, void **) override;
+		void   free(void *, size_t) override;
+		size_t consumed() const override;
+		size_t overhead(size_t size) const override;
+		bool   need_size_for_free() const override { return false; }
+};
+
 #endif /* _INCLUDE__BASE__HEAP_H_ */
@@ -7,7 +7,7 @@
  */
 
 /*
- * Copyright (C) 2006-2013 Genode Labs GmbH
+ * Copyright (C) 2006-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -20,6 +20,8 @@
 #include <util/noncopyable.h>
 #include <base/capability.h>
 #include <base/weak_ptr.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
 
 namespace Genode { template <typename> class Object_pool; }
 
@@ -96,6 +98,122 @@ class Genode::Object_pool
 		Avl_tree<Entry> _tree;
 		Lock            _lock;
 
+		/*
+		 * Read-mostly lookup cache
+		 *
+		 * The cache is a direct-mapped table of entries indexed by the local
+		 * name. It is populated on 'insert' and on lookups that missed the
+		 * cache and resolved the entry via the AVL tree. Lookups consult the
+		 * cache without taking the pool lock. Concurrent readers announce
+		 * their presence at a reader counter of the current epoch. Before
+		 * 'remove' returns, it waits until all readers that may have observed
+		 * the removed entry left the cache (grace period). The counters are
+		 * spread over a few cache lines, selected by the cache slot, so that
+		 * lookups of different objects do not contend.
+		 */
+		enum { CACHE_SLOTS = 256, READER_SHARDS = 4 };
+
+		Entry * volatile _cache[CACHE_SLOTS] { };
+
+		struct Readers
+		{
+			int volatile count[2];
+			int          _pad[14]; /* occupy a cache line of its own */
+		};
+
+		int volatile _epoch = 0;
+		Readers      _readers[READER_SHARDS] { };
+
+		/*
+		 * The remover blocks at '_drained' until the last reader of the
+		 * previous epoch left. Grace periods are serialized by '_grace_lock',
+		 * which is not held by lookups.
+		 */
+		Lock         _grace_lock;
+		Lock         _drained { Lock::LOCKED };
+		int volatile _waiting = 0;
+
+		static unsigned _slot(unsigned long capid) {
+			return (capid ^ (capid >> 8) ^ (capid >> 16)) % CACHE_SLOTS; }
+
+		static void _atomic_add(int volatile *value, int inc)
+		{
+			for (;;) {
+				int const old = *value;
+				if (cmpxchg(value, old, old + inc))
+					return;
+			}
+		}
+
+		bool _drained_epoch(int epoch) const
+		{
+			for (unsigned i = 0; i < READER_SHARDS; i++)
+				if (_readers[i].count[epoch])
+					return false;
+			return true;
+		}
+
+		/**
+		 * Enter read-side section of the cache
+		 *
+		 * \return epoch to be passed to '_leave_cache'
+		 */
+		int _enter_cache(unsigned shard)
+		{
+			for (;;) {
+				int const epoch = _epoch & 1;
+				_atomic_add(&_readers[shard].count[epoch], 1);
+
+				/* the epoch did not advance while we registered */
+				if ((_epoch & 1) == epoch)
+					return epoch;
+
+				_leave_cache(shard, epoch);
+			}
+		}
+
+		void _leave_cache(unsigned shard, int epoch)
+		{
+			_atomic_add(&_readers[shard].count[epoch], -1);
+
+			/* wake up remover if we were the last reader of its epoch */
+			if ((_epoch & 1) != epoch && _waiting && _drained_epoch(epoch)
+			 && cmpxchg(&_waiting, 1, 0))
+				_drained.unlock();
+		}
+
+		/**
+		 * Wait until all readers of the current epoch left the cache
+		 *
+		 * Must not be called with '_lock' held.
+		 */
+		void _wait_for_readers()
+		{
+			Lock::Guard grace_guard(_grace_lock);
+
+			int const epoch = _epoch & 1;
+			_waiting = 1;
+			_atomic_add(&_epoch, 1);
+
+			/* block unless the epoch is drained already */
+			if (!_drained_epoch(epoch) || !cmpxchg(&_waiting, 1, 0))
+				_drained.lock();
+		}
+
+		/**
+		 * Remove entry from the cache
+		 *
+		 * Must be called with '_lock' held. The caller must wait for the
+		 * end of the grace period via '_wait_for_readers' after releasing
+		 * '_lock' and before the entry is destructed.
+		 */
+		void _evict(Entry *entry)
+		{
+			Entry * volatile &slot = _cache[_slot(entry->_obj_id())];
+			if (slot == entry)
+				slot = nullptr;
+		}
+
 	protected:
 
 		bool empty()
@@ -110,12 +228,24 @@ class Genode::Object_pool
 		{
 			Lock::Guard lock_guard(_lock);
 			_tree.insert(obj);
+
+			memory_barrier();
+			_cache[_slot(obj->_obj_id())] = obj;
 		}
 
 		void remove(OBJ_TYPE *obj)
 		{
-			Lock::Guard lock_guard(_lock);
-			_tree.remove(obj);
+			{
+				Lock::Guard lock_guard(_lock);
+				_tree.remove(obj);
+				_evict(obj);
+			}
+
+			/*
+			 * Even if the entry is no longer cached, a reader may still
+			 * refer to it if the slot got reused just recently.
+			 */
+			_wait_for_readers();
 		}
 
 		template <typename FUNC>
@@ -129,13 +259,29 @@ class Genode::Object_pool
 
 			Weak_ptr ptr;
 
+			/* look up entry in the cache without taking the pool lock */
 			{
+				unsigned const slot  = _slot(capid);
+				unsigned const shard = slot % READER_SHARDS;
+				int      const epoch = _enter_cache(shard);
+
+				Entry * const entry = _cache[slot];
+				if (entry && entry->_obj_id() == capid)
+					ptr = entry->_lock.weak_ptr();
+
+				_leave_cache(shard, epoch);
+			}
+
+			if (!ptr.obj()) {
 				Lock::Guard lock_guard(_lock);
 
 				Entry * entry = _tree.first() ?
 					_tree.first()->find_by_obj_id(capid) : nullptr;
 
-				if (entry) ptr = entry->_lock.weak_ptr();
+				if (entry) {
+					ptr = entry->_lock.weak_ptr();
+					_cache[_slot(capid)] = entry;
+				}
 			}
 
 			{
@@ -173,9 +319,12 @@ class Genode::Object_pool
 						if (!lock_ptr.valid()) return;
 
 						_tree.remove(obj);
+						_evict(obj);
 					}
 				}
 
+				_wait_for_readers();
+
 				func(obj);
 			}
 		}
@@ -0,0 +1,174 @@
+/*
+ * \brief  Pool of RPC entrypoints distributed over multiple CPUs
+ * \author Genode Labs
+ * \date   2016-08-26
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_
+#define _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_
+
+#include <util/noncopyable.h>
+#include <util/string.h>
+#include <base/rpc_server.h>
+#include <base/allocator.h>
+#include <base/lock.h>
+#include <base/env.h>
+#include <base/snprintf.h>
+
+namespace Genode { class Rpc_entrypoint_pool; }
+
+
+/**
+ * Set of worker entrypoints that serve the RPC objects of one server
+ *
+ * Each worker is an 'Rpc_entrypoint' placed at a distinct CPU of the
+ * component's affinity space. The capability of an RPC object is bound to
+ * the worker that manages the object. To keep the state of each session
+ * single-threaded, a server selects a worker when a session is created and
+ * manages all RPC objects of the session via this worker.
+ */
+class Genode::Rpc_entrypoint_pool : Noncopyable
+{
+	public:
+
+		/*
+		 * Number of workers if the affinity space does not tell
+		 *
+		 * Some kernels, e.g., Linux, report an affinity space of one CPU
+		 * regardless of the CPUs actually present.
+		 */
+		enum { MAX_WORKERS = 32, FALLBACK_WORKERS = 4 };
+
+	private:
+
+		struct Worker
+		{
+			Rpc_entrypoint ep;
+			unsigned       sessions = 0;
+
+			Worker(Pd_session &pd, size_t stack_size, char const *name,
+			       Affinity::Location location)
+			: ep(&pd, stack_size, name, true, location) { }
+		};
+
+		Allocator &_alloc;
+
+		unsigned const _num_workers;
+
+		Worker *_workers[MAX_WORKERS];
+
+		Lock _lock;
+
+		static unsigned _init_num_workers(Env &env, unsigned num_workers)
+		{
+			unsigned const num_cpus = env.cpu().affinity_space().total();
+
+			if (num_workers == 0)
+				num_workers = num_cpus > 1 ? num_cpus : (unsigned)FALLBACK_WORKERS;
+
+			return max(1U, min(num_workers, (unsigned)MAX_WORKERS));
+		}
+
+		Worker &_worker_of(Rpc_entrypoint &ep)
+		{
+			for (unsigned i = 0; i < _num_workers; i++)
+				if (&_workers[i]->ep == &ep)
+					return *_workers[i];
+
+			struct Unknown_entrypoint : Exception { };
+			throw Unknown_entrypoint();
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param num_workers  number of worker entrypoints, if 0, one worker
+		 *                     is created for each CPU of the affinity space,
+		 *                     or 'FALLBACK_WORKERS' if the space has a
+		 *                     single CPU only
+		 * \param stack_size   stack size of each worker
+		 * \param name         name prefix of the worker threads
+		 */
+		Rpc_entrypoint_pool(Env &env, Allocator &alloc, unsigned num_workers,
+		                    size_t stack_size, char const *name)
+		:
+			_alloc(alloc), _num_workers(_init_num_workers(env, num_workers))
+		{
+			Affinity::Space space = env.cpu().affinity_space();
+
+			for (unsigned i = 0; i < _num_workers; i++) {
+
+				char worker_name[32];
+				snprintf(worker_name, sizeof(worker_name), "%s.%u", name, i);
+
+				try {
+					_workers[i] = new (_alloc)
+						Worker(env.pd(), stack_size, worker_name,
+						       space.location_of_index(i));
+				} catch (...) {
+
+					/* the destructor is not called for a partial object */
+					while (i--)
+						destroy(_alloc, _workers[i]);
+					throw;
+				}
+			}
+		}
+
+		~Rpc_entrypoint_pool()
+		{
+			for (unsigned i = 0; i < _num_workers; i++)
+				destroy(_alloc, _workers[i]);
+		}
+
+		unsigned num_workers() const { return _num_workers; }
+
+		/**
+		 * Return worker entrypoint by index
+		 */
+		Rpc_entrypoint &worker(unsigned i) { return _workers[i % _num_workers]->ep; }
+
+		/**
+		 * Select worker for a new session
+		 *
+		 * The worker that serves the least number of sessions is selected.
+		 * All RPC objects of the session should be managed by the returned
+		 * entrypoint. The session must be released via 'release_session'
+		 * once it is closed.
+		 */
+		Rpc_entrypoint &acquire_session()
+		{
+			Lock::Guard guard(_lock);
+
+			Worker *selected = _workers[0];
+			for (unsigned i = 1; i < _num_workers; i++)
+				if (_workers[i]->sessions < selected->sessions)
+					selected = _workers[i];
+
+			selected->sessions++;
+			return selected->ep;
+		}
+
+		/**
+		 * Release session assigned via 'acquire_session'
+		 */
+		void release_session(Rpc_entrypoint &ep)
+		{
+			Lock::Guard guard(_lock);
+
+			Worker &worker = _worker_of(ep);
+			if (worker.sessions)
+				worker.sessions--;
+		}
+};
+
+#endif /* _INCLUDE__BASE__RPC_ENTRYPOINT_POOL_H_ */
@@ -38,6 +38,13 @@ class Genode::Semaphore
 
 		Fifo<Element> _queue;
 
+		/*
+		 * Generate trace events, implemented out of line because the
+		 * trace-event definitions depend on this header
+		 */
+		void _trace_block() const;
+		void _trace_woken() const;
+
 	public:
 
 		/**
@@ -102,7 +109,9 @@ class Genode::Semaphore
 				 * waiting for getting waked from another thread
 				 * calling 'up()'
 				 * */
+				_trace_block();
 				queue_element.block();
+				_trace_woken();
 
 			} else {
 				_meta_lock.unlock();
@@ -46,12 +46,20 @@ class Genode::Slab : public Allocator
 
 		size_t _num_blocks  = 0;
 		size_t _total_avail = 0;
+		size_t _max_used    = 0;  /* high-water mark of used entries */
 
 		/**
-		 * Block used for attempting the next allocation
+		 * Current position within the ring of all slab blocks
 		 */
 		Block *_curr_sb = nullptr;
 
+		/**
+		 * Ring of slab blocks with at least one free entry
+		 *
+		 * Allocations are always served from the first block of this ring.
+		 */
+		Block *_avail_sb = nullptr;
+
 		Allocator   *_backing_store;
 
 		/**
@@ -73,6 +81,16 @@ class Genode::Slab : public Allocator
 		 */
 		void _insert_sb(Block *);
 
+		/**
+		 * Insert block at the front of the ring of non-full blocks
+		 */
+		void _link_avail_sb(Block *);
+
+		/**
+		 * Remove block from the ring of non-full blocks
+		 */
+		void _unlink_avail_sb(Block *);
+
 		/**
 		 * Release slab block
 		 */
@@ -114,6 +132,18 @@ class Genode::Slab : public Allocator
 		 */
 		void *any_used_elem();
 
+		/**
+		 * Allocation statistics, intended for profiling
+		 */
+		struct Stats
+		{
+			size_t blocks;            /* number of slab blocks           */
+			size_t used_entries;      /* number of allocated entries     */
+			size_t max_used_entries;  /* high-water mark of used entries */
+		};
+
+		Stats stats() const;
+
 		/**
 		 * Define/request backing-store allocator
 		 *
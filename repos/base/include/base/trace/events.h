@@ -25,6 +25,11 @@ namespace Genode { namespace Trace {
 	struct Rpc_reply;
 	struct Signal_submit;
 	struct Signal_received;
+	struct Lock_wait;
+	struct Lock_acquired;
+	struct Semaphore_block;
+	struct Semaphore_woken;
+	struct Region_map_fault;
 } }
 
 
@@ -121,4 +126,78 @@ struct Genode::Trace::Signal_received
 };
 
 
+/**
+ * Thread is about to block on a lock held by another thread
+ */
+struct Genode::Trace::Lock_wait
+{
+	void const *lock;
+	void const *holder;
+
+	Lock_wait(void const *lock, void const *holder)
+	:
+		lock(lock), holder(holder)
+	{
+		Thread::trace(this);
+	}
+
+	size_t generate(Policy_module &policy, char *dst) const {
+		return policy.lock_wait(dst, lock, holder); }
+};
+
+
+/**
+ * Thread acquired a lock after having waited for it
+ */
+struct Genode::Trace::Lock_acquired
+{
+	void const *lock;
+
+	Lock_acquired(void const *lock) : lock(lock) { Thread::trace(this); }
+
+	size_t generate(Policy_module &policy, char *dst) const {
+		return policy.lock_acquired(dst, lock); }
+};
+
+
+struct Genode::Trace::Semaphore_block
+{
+	void const *semaphore;
+
+	Semaphore_block(void const *semaphore) : semaphore(semaphore)
+	{ Thread::trace(this); }
+
+	size_t generate(Policy_module &policy, char *dst) const {
+		return policy.semaphore_block(dst, semaphore); }
+};
+
+
+struct Genode::Trace::Semaphore_woken
+{
+	void const *semaphore;
+
+	Semaphore_woken(void const *semaphore) : semaphore(semaphore)
+	{ Thread::trace(this); }
+
+	size_t generate(Policy_module &policy, char *dst) const {
+		return policy.semaphore_woken(dst, semaphore); }
+};
+
+
+/**
+ * Fault of a managed dataspace as obtained by the region-map fault handler
+ */
+struct Genode::Trace::Region_map_fault
+{
+	addr_t const addr;
+	bool   const write;
+
+	Region_map_fault(addr_t addr, bool write) : addr(addr), write(write)
+	{ Thread::trace(this); }
+
+	size_t generate(Policy_module &policy, char *dst) const {
+		return policy.region_map_fault(dst, addr, write); }
+};
+
+
 #endif /* _INCLUDE__BASE__TRACE__EVENTS_H_ */
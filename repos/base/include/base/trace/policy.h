@@ -38,6 +38,11 @@ struct Genode::Trace::Policy_module
 	size_t (*rpc_reply)       (char *, char const *);
 	size_t (*signal_submit)   (char *, unsigned const);
 	size_t (*signal_received) (char *, Signal_context const &, unsigned const);
+	size_t (*lock_wait)       (char *, void const *, void const *);
+	size_t (*lock_acquired)   (char *, void const *);
+	size_t (*semaphore_block) (char *, void const *);
+	size_t (*semaphore_woken) (char *, void const *);
+	size_t (*region_map_fault)(char *, addr_t, bool);
 };
 
 #endif /* _INCLUDE__BASE__TRACE__POLICY_H_ */
@@ -47,6 +47,12 @@ struct Genode::Pd_session_client : Rpc_client<Pd_session>
 	void submit(Signal_context_capability receiver, unsigned cnt = 1) override {
 		call<Rpc_submit>(receiver, cnt); }
 
+	bool signal_page(Capability<Dataspace> page) override {
+		return call<Rpc_signal_page>(page); }
+
+	unsigned signal_slot(Signal_context_capability context) override {
+		return call<Rpc_signal_slot>(context); }
+
 	Native_capability alloc_rpc_cap(Native_capability ep) override {
 		return call<Rpc_alloc_rpc_cap>(ep); }
 
@@ -120,6 +120,30 @@ struct Genode::Pd_session : Session
 	 */
 	virtual void submit(Capability<Signal_context> context, unsigned cnt = 1) = 0;
 
+	/**
+	 * Provide page of signal slots for the signals submitted by the PD
+	 *
+	 * \param page  RAM dataspace of 4 KiB holding one 32-bit slot per
+	 *              signal context
+	 * \return      false if the platform does not support signal slots
+	 *
+	 * Signal slots allow a submitter to coalesce signals for a context that
+	 * is already pending at the receiver without involving core. The page
+	 * is shared between the submitter and core only. Core drains the slots
+	 * of a context when delivering a signal for the context.
+	 */
+	virtual bool signal_page(Capability<Dataspace> page) = 0;
+
+	/**
+	 * Request signal slot for the specified signal context
+	 *
+	 * \param context  signal destination
+	 * \return         slot ID within the page provided via 'signal_page',
+	 *                 consisting of slot index and generation key, or 0 if
+	 *                 the context has no slot
+	 */
+	virtual unsigned signal_slot(Capability<Signal_context> context) = 0;
+
 
 	/***********************************
 	 ** Support for the RPC framework **
@@ -197,6 +221,9 @@ struct Genode::Pd_session : Session
 	GENODE_RPC(Rpc_free_context, void, free_context,
 	           Capability<Signal_context>);
 	GENODE_RPC(Rpc_submit, void, submit, Capability<Signal_context>, unsigned);
+	GENODE_RPC(Rpc_signal_page, bool, signal_page, Capability<Dataspace>);
+	GENODE_RPC(Rpc_signal_slot, unsigned, signal_slot,
+	           Capability<Signal_context>);
 
 	GENODE_RPC_THROW(Rpc_alloc_rpc_cap, Native_capability, alloc_rpc_cap,
 	                 GENODE_TYPE_LIST(Out_of_metadata), Native_capability);
@@ -211,6 +238,7 @@ struct Genode::Pd_session : Session
 	GENODE_RPC_INTERFACE(Rpc_assign_parent, Rpc_assign_pci,
 	                     Rpc_alloc_signal_source, Rpc_free_signal_source,
 	                     Rpc_alloc_context, Rpc_free_context, Rpc_submit,
+	                     Rpc_signal_page, Rpc_signal_slot,
 	                     Rpc_alloc_rpc_cap, Rpc_free_rpc_cap, Rpc_address_space,
 	                     Rpc_stack_area, Rpc_linker_area, Rpc_native_pd);
 };
@@ -15,11 +15,14 @@
 #define _INCLUDE__UTIL__XML_NODE_H_
 
 #include <util/token.h>
+#include <util/noncopyable.h>
 #include <base/exception.h>
+#include <base/allocator.h>
 
 namespace Genode {
 	class Xml_attribute;
 	class Xml_node;
+	class Xml_index;
 }
 
 
@@ -57,6 +60,7 @@ class Genode::Xml_attribute
 		 * explicit friendship to 'Tag'.
 		 */
 		friend class Tag;
+		friend class Xml_index;
 
 		/**
 		 * Constructor
@@ -449,6 +453,26 @@ class Genode::Xml_node
 		Tag         _start_tag;
 		Tag         _end_tag;
 
+		/*
+		 * Nodes obtained from an 'Xml_index' refer to the index to
+		 * navigate to sub nodes, siblings, and attributes without
+		 * re-tokenizing the XML data.
+		 */
+		Xml_index const *_index    = nullptr;
+		unsigned         _index_id = 0;
+
+		friend class Xml_index;
+
+		/**
+		 * Constructor used for nodes obtained from an 'Xml_index'
+		 */
+		inline Xml_node(Xml_index const &index, unsigned id);
+
+		inline Xml_node      _indexed_next() const;
+		inline Xml_node      _indexed_sub_node(unsigned idx) const;
+		inline Xml_attribute _indexed_attribute(unsigned idx) const;
+		inline unsigned      _indexed_num_attributes() const;
+
 		/**
 		 * Search for end tag of XML node and initialize '_num_sub_nodes'
 		 *
@@ -720,6 +744,9 @@ class Genode::Xml_node
 		 */
 		Xml_node next() const
 		{
+			if (_index)
+				return _indexed_next();
+
 			Token after_node = _end_tag.next_token();
 			after_node = skip_non_tag_characters(after_node);
 			try { return _sub_node(after_node.start()); }
@@ -765,6 +792,9 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(unsigned idx = 0U) const
 		{
+			if (_index)
+				return _indexed_sub_node(idx);
+
 			if (_num_sub_nodes > 0) {
 
 				/* look up node at specified index */
@@ -786,6 +816,15 @@ class Genode::Xml_node
 		 */
 		Xml_node sub_node(const char *type) const
 		{
+			if (_index) {
+				for (unsigned i = 0; i < (unsigned)_num_sub_nodes; i++) {
+					Xml_node const node = _indexed_sub_node(i);
+					if (node.has_type(type))
+						return node;
+				}
+				throw Nonexistent_sub_node();
+			}
+
 			if (_num_sub_nodes > 0) {
 
 				/* search for sub node of specified type */
@@ -839,6 +878,9 @@ class Genode::Xml_node
 		 */
 		Xml_attribute attribute(unsigned idx) const
 		{
+			if (_index)
+				return _indexed_attribute(idx);
+
 			/* get first attribute of the node */
 			Xml_attribute a = _start_tag.attribute();
 
@@ -858,6 +900,16 @@ class Genode::Xml_node
 		 */
 		Xml_attribute attribute(const char *type) const
 		{
+			if (_index) {
+				unsigned const num = _indexed_num_attributes();
+				for (unsigned i = 0; i < num; i++) {
+					Xml_attribute a = _indexed_attribute(i);
+					if (a.has_type(type))
+						return a;
+				}
+				throw Nonexistent_attribute();
+			}
+
 			/* iterate, beginning with the first attribute of the node */
 			for (Xml_attribute a = _start_tag.attribute(); ; a = a.next())
 				if (a.has_type(type))
@@ -911,4 +963,284 @@ class Genode::Xml_node
 			output.out_string(addr(), size()); }
 };
 
+
+/**
+ * Index of the nodes and attributes of an XML node
+ *
+ * The index is built by a single pass over the XML data. Nodes obtained
+ * from the index provide the same interface as regular 'Xml_node' objects
+ * but access sub nodes by index, siblings, and attributes in constant time
+ * instead of re-tokenizing the XML data on each access. Components that
+ * repeatedly inspect a large XML structure, e.g., a configuration, should
+ * build the index once whenever the XML data changes.
+ *
+ * The XML data must stay unmodified during the lifetime of the index.
+ * In contrast to regular nodes, the nodes obtained from the index do not
+ * consider any XML data following the indexed top-level node. Hence, the
+ * top-level node has no successor.
+ */
+class Genode::Xml_index : Noncopyable
+{
+	private:
+
+		friend class Xml_node;
+
+		typedef Xml_node::Token Token;
+		typedef Xml_node::Tag   Tag;
+
+		enum { INVALID = ~0U };
+
+		struct Node
+		{
+			unsigned start;         /* offset of start tag                   */
+			unsigned end;           /* offset of end tag, 'start' if empty   */
+			unsigned parent;
+			unsigned next;          /* next sibling or 'INVALID'             */
+			unsigned num_sub_nodes;
+			unsigned first_child;   /* index into '_children'                */
+			unsigned first_attr;    /* index into '_attrs'                   */
+			unsigned num_attrs;
+		};
+
+		Allocator  &_alloc;
+		char const *_base;
+		size_t      _len;
+
+		unsigned _num_nodes = 0;
+		unsigned _num_attrs = 0;
+
+		Node     *_nodes    = nullptr;
+		unsigned *_children = nullptr;  /* node IDs ordered by parent */
+		unsigned *_attrs    = nullptr;  /* offsets of attribute tokens */
+
+		unsigned _offset(Token t) const { return t.start() - _base; }
+
+		Token _token(unsigned offset) const {
+			return Token(_base + offset, _len - offset); }
+
+		/**
+		 * Traverse all tags of the indexed node
+		 *
+		 * \param fn  functor called with each tag that is part of the
+		 *            node structure, including the start tag of the
+		 *            top-level node
+		 */
+		template <typename FN>
+		void _for_each_tag(FN const &fn) const
+		{
+			Tag const start_tag(_token(0));
+
+			fn(start_tag);
+
+			if (start_tag.type() != Tag::START)
+				return;
+
+			int   depth = 1;
+			Token curr_token = start_tag.next_token();
+
+			while (depth > 0 && curr_token.type() != Token::END) {
+
+				/* eat XML comment */
+				Xml_node::Comment curr_comment(curr_token);
+				if (curr_comment.valid()) {
+					curr_token = curr_comment.next_token();
+					continue;
+				}
+
+				/* skip all tokens that are no tags */
+				Tag curr_tag(curr_token);
+				if (curr_tag.type() == Tag::INVALID) {
+					curr_token = curr_token.next();
+					continue;
+				}
+
+				fn(curr_tag);
+
+				depth += (curr_tag.type() == Tag::START);
+				depth -= (curr_tag.type() == Tag::END);
+
+				curr_token = curr_tag.next_token();
+			}
+		}
+
+		static unsigned _num_tag_attributes(Tag const &tag)
+		{
+			unsigned cnt = 0;
+			try {
+				for (Xml_attribute a = tag.attribute(); ; a = a.next())
+					cnt++;
+			} catch (Xml_attribute::Nonexistent_attribute) { }
+			return cnt;
+		}
+
+		void _build()
+		{
+			/* first pass, determine the size of the index */
+			_for_each_tag([&] (Tag const &tag) {
+				if (!tag.node())
+					return;
+				_num_nodes++;
+				_num_attrs += _num_tag_attributes(tag);
+			});
+
+			_nodes    = (Node *)    _alloc.alloc(sizeof(Node)     * _num_nodes);
+			_children = (unsigned *)_alloc.alloc(sizeof(unsigned) * _num_nodes);
+			_attrs    = (unsigned *)_alloc.alloc(sizeof(unsigned) * max(_num_attrs, 1U));
+
+			/* second pass, record nodes and attributes */
+			unsigned curr = INVALID, num_nodes = 0, num_attrs = 0;
+
+			_for_each_tag([&] (Tag const &tag) {
+
+				if (tag.type() == Tag::END) {
+
+					Node &node = _nodes[curr];
+					Token const name = Tag(_token(node.start)).name();
+
+					if (name.len() != tag.name().len()
+					 || strcmp(name.start(), tag.name().start(), name.len()))
+						throw Xml_node::Invalid_syntax();
+
+					node.end = _offset(tag.token());
+					curr     = node.parent;
+					return;
+				}
+
+				unsigned const id = num_nodes++;
+				Node &node = _nodes[id];
+
+				node.start         = _offset(tag.token());
+				node.end           = node.start;
+				node.parent        = curr;
+				node.next          = INVALID;
+				node.num_sub_nodes = 0;
+				node.first_child   = 0;
+				node.first_attr    = num_attrs;
+				node.num_attrs     = 0;
+
+				try {
+					for (Xml_attribute a = tag.attribute(); ; a = a.next()) {
+						_attrs[num_attrs++] = _offset(a._name);
+						node.num_attrs++;
+					}
+				} catch (Xml_attribute::Nonexistent_attribute) { }
+
+				if (curr != INVALID)
+					_nodes[curr].num_sub_nodes++;
+
+				if (tag.type() == Tag::START)
+					curr = id;
+			});
+
+			/* link siblings and lay out the sub nodes of each node */
+			unsigned slot = 0;
+			for (unsigned id = 0; id < _num_nodes; id++) {
+				_nodes[id].first_child   = slot;
+				slot                    += _nodes[id].num_sub_nodes;
+				_nodes[id].num_sub_nodes = 0;
+			}
+
+			for (unsigned id = 1; id < _num_nodes; id++) {
+				Node &parent = _nodes[_nodes[id].parent];
+
+				if (parent.num_sub_nodes)
+					_nodes[_children[parent.first_child + parent.num_sub_nodes - 1]].next = id;
+
+				_children[parent.first_child + parent.num_sub_nodes++] = id;
+			}
+		}
+
+		void _free()
+		{
+			if (_nodes)    _alloc.free(_nodes,    sizeof(Node)     * _num_nodes);
+			if (_children) _alloc.free(_children, sizeof(unsigned) * _num_nodes);
+			if (_attrs)    _alloc.free(_attrs,    sizeof(unsigned) * max(_num_attrs, 1U));
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param alloc  allocator used for the index data
+		 * \param node   XML node to index
+		 *
+		 * \throw Xml_node::Invalid_syntax  start and end tags of a
+		 *                                  sub node do not match
+		 * \throw Allocator::Out_of_memory
+		 */
+		Xml_index(Allocator &alloc, Xml_node const &node)
+		:
+			_alloc(alloc),
+			_base(node._start_tag.token().start()),
+			_len(node._max_len - (_base - node.addr()))
+		{
+			try { _build(); }
+			catch (...) { _free(); throw; }
+		}
+
+		~Xml_index() { _free(); }
+
+		/**
+		 * Return indexed top-level node
+		 */
+		Xml_node xml() const { return Xml_node(*this, 0); }
+
+		/**
+		 * Return total number of indexed nodes
+		 */
+		unsigned num_nodes() const { return _num_nodes; }
+};
+
+
+Genode::Xml_node::Xml_node(Xml_index const &index, unsigned id)
+:
+	_addr(index._base + index._nodes[id].start),
+	_max_len(index._len - index._nodes[id].start),
+	_num_sub_nodes(index._nodes[id].num_sub_nodes),
+	_start_tag(Token(_addr, _max_len)),
+	_end_tag(_start_tag.type() == Tag::START
+	         ? Tag(index._token(index._nodes[id].end)) : _start_tag),
+	_index(&index), _index_id(id)
+{ }
+
+
+Genode::Xml_node Genode::Xml_node::_indexed_next() const
+{
+	unsigned const next = _index->_nodes[_index_id].next;
+
+	if (next == Xml_index::INVALID)
+		throw Nonexistent_sub_node();
+
+	return Xml_node(*_index, next);
+}
+
+
+Genode::Xml_node Genode::Xml_node::_indexed_sub_node(unsigned idx) const
+{
+	Xml_index::Node const &node = _index->_nodes[_index_id];
+
+	if (idx >= node.num_sub_nodes)
+		throw Nonexistent_sub_node();
+
+	return Xml_node(*_index, _index->_children[node.first_child + idx]);
+}
+
+
+Genode::Xml_attribute Genode::Xml_node::_indexed_attribute(unsigned idx) const
+{
+	Xml_index::Node const &node = _index->_nodes[_index_id];
+
+	if (idx >= node.num_attrs)
+		throw Nonexistent_attribute();
+
+	return Xml_attribute(_index->_token(_index->_attrs[node.first_attr + idx]));
+}
+
+
+unsigned Genode::Xml_node::_indexed_num_attributes() const
+{
+	return _index->_nodes[_index_id].num_attrs;
+}
+
 #endif /* _INCLUDE__UTIL__XML_NODE_H_ */
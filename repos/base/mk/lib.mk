@@ -203,6 +203,7 @@ ENTRY_POINT      ?= 0x0
 $(LIB_SO): $(STATIC_LIBS) $(OBJECTS) $(wildcard $(LD_SCRIPT_SO))
 	$(MSG_MERGE)$(LIB_SO)
 	$(VERBOSE)libs=$(LIB_CACHE_DIR); $(LD) -o $(LIB_SO) -shared --eh-frame-hdr \
+	                --hash-style=both \
 	                $(LD_OPT) \
 	                -T $(LD_SCRIPT_SO) \
 	                --entry=$(ENTRY_POINT) \
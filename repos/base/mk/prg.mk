@@ -120,7 +120,7 @@ LD_OPT += --dynamic-list=$(call select_from_repositories,src/ld/genode_dyn.dl)
 
 LD_SCRIPTS  := $(LD_SCRIPT_DYN)
 LD_CMD      += -Wl,--dynamic-linker=$(DYNAMIC_LINKER).lib.so \
-               -Wl,--eh-frame-hdr
+               -Wl,--eh-frame-hdr -Wl,--hash-style=both
 
 #
 # Filter out the base libraries since they will be provided by the LDSO library
@@ -93,6 +93,16 @@ class Genode::Core_pd_session_component : public Rpc_object<Pd_session>
 			});
 		}
 
+		bool signal_page(Capability<Dataspace>) override
+		{
+			ASSERT_NEVER_CALLED;
+		}
+
+		unsigned signal_slot(Capability<Signal_context>) override
+		{
+			ASSERT_NEVER_CALLED;
+		}
+
 		Native_capability alloc_rpc_cap(Native_capability) override
 		{
 			ASSERT_NEVER_CALLED;
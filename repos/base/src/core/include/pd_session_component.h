@@ -173,6 +173,12 @@ class Genode::Pd_session_component : public Rpc_object<Pd_session>
 		void submit(Signal_context_capability cap, unsigned n) override {
 			_signal_broker.submit(cap, n); }
 
+		bool signal_page(Capability<Dataspace> page) override {
+			return _signal_broker.signal_page(page); }
+
+		unsigned signal_slot(Signal_context_capability cap) override {
+			return _signal_broker.signal_slot(cap); }
+
 		Native_capability alloc_rpc_cap(Native_capability ep) override
 		{
 			try {
@@ -104,6 +104,14 @@ class Genode::Signal_broker
 				context->source()->submit(context, cnt);
 			});
 		}
+
+		/*
+		 * Signals are submitted via core only. Coalescing submissions via
+		 * signal slots is supported on Linux only.
+		 */
+		bool signal_page(Capability<Dataspace>) { return false; }
+
+		unsigned signal_slot(Signal_context_capability) { return 0; }
 };
 
 #endif /* _CORE__INCLUDE__SIGNAL_BROKER_H_ */
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2009-2013 Genode Labs GmbH
+ * Copyright (C) 2009-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -21,10 +21,15 @@
 #include <base/rpc_client.h>
 #include <base/rpc_server.h>
 #include <util/fifo.h>
+#include <util/list.h>
 #include <base/signal.h>
 
+/* base-internal includes */
+#include <base/internal/signal_slot.h>
+
 namespace Genode {
 
+	class Signal_slot_ref;
 	class Signal_context_component;
 	class Signal_source_component;
 
@@ -32,6 +37,43 @@ namespace Genode {
 }
 
 
+/**
+ * Signal slot of a submitter assigned to a signal context
+ *
+ * On platforms where submitters coalesce signals in a page of signal slots
+ * shared with core, core drains the slots of a context whenever it
+ * delivers a signal for the context. Each submitter provides a page of
+ * its own, so a submitter can only account signals for contexts it is
+ * able to signal anyway.
+ */
+class Genode::Signal_slot_ref : public List<Signal_slot_ref>::Element
+{
+	public:
+
+		/**
+		 * Interface of the page holding the slot
+		 */
+		struct Owner { virtual void release(Signal_slot_ref &) = 0; };
+
+		Owner                    &owner;
+		Signal_context_component &context;
+		int volatile             &slot;
+
+		Signal_slot_ref(Owner &owner, Signal_context_component &context,
+		                int volatile &slot)
+		: owner(owner), context(context), slot(slot) { }
+
+		/**
+		 * Lock protecting the slot references of all contexts
+		 */
+		static Lock &lock()
+		{
+			static Lock inst;
+			return inst;
+		}
+};
+
+
 class Genode::Signal_context_component : public Rpc_object<Signal_context>,
                                          public Signal_queue::Element
 {
@@ -40,6 +82,7 @@ class Genode::Signal_context_component : public Rpc_object<Signal_context>,
 		long                     _imprint;
 		int                      _cnt;
 		Signal_source_component *_source;
+		List<Signal_slot_ref>    _slot_refs;
 
 	public:
 
@@ -65,6 +108,36 @@ class Genode::Signal_context_component : public Rpc_object<Signal_context>,
 		 */
 		void reset_signal_cnt() { _cnt = 0; }
 
+		/**
+		 * Add signals accounted in the signal slots of the context
+		 */
+		void drain_slots()
+		{
+			/* contexts without slots take the regular path */
+			if (!_slot_refs.first())
+				return;
+
+			Lock::Guard guard(Signal_slot_ref::lock());
+
+			for (Signal_slot_ref *r = _slot_refs.first(); r; r = r->next())
+				_cnt += Signal_slot::drain(r->slot);
+		}
+
+		/*
+		 * The following functions must be called with 'Signal_slot_ref::lock'
+		 * held.
+		 */
+		void add_slot_ref(Signal_slot_ref &r)    { _slot_refs.insert(&r); }
+		void remove_slot_ref(Signal_slot_ref &r) { _slot_refs.remove(&r); }
+
+		Signal_slot_ref *slot_ref(Signal_slot_ref::Owner const &owner)
+		{
+			for (Signal_slot_ref *r = _slot_refs.first(); r; r = r->next())
+				if (&r->owner == &owner)
+					return r;
+			return nullptr;
+		}
+
 		long                          imprint()  { return _imprint; }
 		int                           cnt()      { return _cnt; }
 		Signal_source_component      *source()   { return _source; }
@@ -138,6 +211,16 @@ Genode::Signal_context_component::~Signal_context_component()
 {
 	if (enqueued() && _source)
 		_source->release(this);
+
+	if (!_slot_refs.first())
+		return;
+
+	Lock::Guard guard(Signal_slot_ref::lock());
+
+	while (Signal_slot_ref *r = _slot_refs.first()) {
+		_slot_refs.remove(r);
+		r->owner.release(*r);
+	}
 }
 
 #endif /* _CORE__INCLUDE__SIGNAL_SOURCE_COMPONENT_H_ */
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2009-2013 Genode Labs GmbH
+ * Copyright (C) 2009-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -47,6 +47,15 @@ void Signal_source_component::submit(Signal_context_component *context,
 	 */
 	if (_reply_cap.valid()) {
 
+		/*
+		 * Signals coalesced by submitters are accounted at delivery time.
+		 * A submission merely notifying about coalesced signals may find
+		 * them delivered already.
+		 */
+		context->drain_slots();
+		if (!context->cnt())
+			return;
+
 		_entrypoint->reply_signal_info(_reply_cap, context->imprint(), context->cnt());
 
 		/*
@@ -66,23 +75,30 @@ void Signal_source_component::submit(Signal_context_component *context,
 
 Signal_source::Signal Signal_source_component::wait_for_signal()
 {
-	/* keep client blocked */
-	if (_signal_queue.empty()) {
+	/* dequeue and return pending signal */
+	while (!_signal_queue.empty()) {
 
-		/*
-		 * Keep reply capability for outstanding request to be used
-		 * for the later call of 'explicit_reply()'.
-		 */
-		_reply_cap = _entrypoint->reply_dst();
-		_entrypoint->omit_reply();
-		return Signal(0, 0);  /* just a dummy */
+		Signal_context_component *context = _signal_queue.dequeue();
+
+		/* skip notifications about coalesced signals delivered already */
+		context->drain_slots();
+		if (!context->cnt())
+			continue;
+
+		Signal result(context->imprint(), context->cnt());
+		context->reset_signal_cnt();
+		return result;
 	}
 
-	/* dequeue and return pending signal */
-	Signal_context_component *context = _signal_queue.dequeue();
-	Signal result(context->imprint(), context->cnt());
-	context->reset_signal_cnt();
-	return result;
+	/*
+	 * Keep client blocked
+	 *
+	 * Keep reply capability for outstanding request to be used
+	 * for the later call of 'explicit_reply()'.
+	 */
+	_reply_cap = _entrypoint->reply_dst();
+	_entrypoint->omit_reply();
+	return Signal(0, 0);  /* just a dummy */
 }
 
 
@@ -0,0 +1,128 @@
+/*
+ * \brief  Shared-memory slots for coalescing signal submissions
+ * \author Genode Labs
+ * \date   2016-08-27
+ *
+ * Each submitter provides a page of slots to core. Core assigns a slot of
+ * the page to each signal context the submitter signals. As long as a
+ * context is pending at the receiver, the submitter merely adds its signal
+ * count to the slot instead of performing an RPC to core. Core drains the
+ * slots of a context when delivering a signal for the context.
+ *
+ * A slot is a single 32-bit word:
+ *
+ * - bit 0 is set while the context is pending at the receiver,
+ * - bits 1..15 hold the number of signals accumulated in the slot,
+ * - bits 16..31 hold the generation key of the context that owns the slot.
+ *
+ * The key enables a submitter to detect that its cached slot was passed on
+ * to another context. Key 0 marks an unused slot. Because all fields are
+ * updated by a single compare-and-exchange, a submitter can never modify a
+ * slot that no longer belongs to its context.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__BASE__INTERNAL__SIGNAL_SLOT_H_
+#define _INCLUDE__BASE__INTERNAL__SIGNAL_SLOT_H_
+
+/* Genode includes */
+#include <cpu/atomic.h>
+
+namespace Genode { struct Signal_slot; }
+
+
+struct Genode::Signal_slot
+{
+	enum {
+		PAGE_SIZE  = 4096,
+		NUM        = PAGE_SIZE / sizeof(int),
+
+		PENDING    = 1,
+		CNT_SHIFT  = 1,
+		CNT_MAX    = 0x7fff,
+		KEY_SHIFT  = 16,
+		INDEX_MASK = 0xffff,
+	};
+
+	/**
+	 * Slot ID as handed out by core, combining slot index and key
+	 */
+	static unsigned id(unsigned index, unsigned key) {
+		return (key << KEY_SHIFT) | index; }
+
+	static unsigned index(unsigned id) { return id & INDEX_MASK; }
+	static unsigned key(unsigned id)   { return id >> KEY_SHIFT; }
+
+	/**
+	 * Initialize slot for the context with the given slot ID
+	 */
+	static void init(int volatile &slot, unsigned id) {
+		slot = (int)(key(id) << KEY_SHIFT); }
+
+	/**
+	 * Mark slot as unused
+	 */
+	static void invalidate(int volatile &slot) { slot = 0; }
+
+	enum Submit_result {
+		COALESCED, /* context was pending, count was added to the slot */
+		NOTIFY,    /* context became pending, receiver must be notified */
+		REJECTED,  /* slot unusable, signal must be submitted via core */
+	};
+
+	/**
+	 * Account 'cnt' signals in the slot
+	 *
+	 * \param key  generation key of the context as known by the submitter
+	 */
+	static Submit_result submit(int volatile &slot, unsigned key, unsigned cnt)
+	{
+		for (;;) {
+			unsigned const old = (unsigned)slot;
+
+			if ((old >> KEY_SHIFT) != key)
+				return REJECTED;
+
+			unsigned const num = ((old >> CNT_SHIFT) & CNT_MAX) + cnt;
+			if (num > CNT_MAX)
+				return REJECTED;
+
+			unsigned const now = (key << KEY_SHIFT) | (num << CNT_SHIFT) | PENDING;
+
+			if (cmpxchg(&slot, (int)old, (int)now))
+				return (old & PENDING) ? COALESCED : NOTIFY;
+		}
+	}
+
+	/**
+	 * Take all signals accumulated in the slot and clear the pending bit
+	 *
+	 * \return number of accumulated signals
+	 *
+	 * The slot is written by the submitter concurrently. To prevent a
+	 * submitter from stalling core by modifying the slot continuously,
+	 * the number of attempts is bounded. If all attempts fail, the slot
+	 * stays pending, which affects the signals of this submitter only.
+	 */
+	static unsigned drain(int volatile &slot)
+	{
+		enum { MAX_ATTEMPTS = 64 };
+
+		for (unsigned i = 0; i < MAX_ATTEMPTS; i++) {
+			unsigned const old = (unsigned)slot;
+			unsigned const now = old & ~(unsigned)INDEX_MASK;
+
+			if (cmpxchg(&slot, (int)old, (int)now))
+				return (old >> CNT_SHIFT) & CNT_MAX;
+		}
+		return 0;
+	}
+};
+
+#endif /* _INCLUDE__BASE__INTERNAL__SIGNAL_SLOT_H_ */
@@ -91,6 +91,45 @@ void Allocator_avl_base::Block::recompute()
 }
 
 
+/******************************
+ ** Size-node implementation **
+ ******************************/
+
+bool Allocator_avl_base::Size_node::higher(Size_node *n)
+{
+	Block const &a = _block, &b = n->_block;
+
+	return (b.size() > a.size()) || (b.size() == a.size() && b.addr() >= a.addr());
+}
+
+
+Allocator_avl_base::Block *
+Allocator_avl_base::Size_node::find_best_fit(size_t size, unsigned align,
+                                             addr_t from, addr_t to)
+{
+	/* the left subtree contains even smaller blocks only */
+	if (_block.size() < size) {
+		Size_node *c = child(RIGHT);
+		return c ? c->find_best_fit(size, align, from, to) : 0;
+	}
+
+	/* prefer smaller blocks of the left subtree */
+	if (Size_node *c = child(LEFT))
+		if (Block *res = c->find_best_fit(size, align, from, to))
+			return res;
+
+	if (_block._fits(size, align, from, to))
+		return &_block;
+
+	/*
+	 * The block is large enough but does not fit because of the alignment
+	 * or address constraints, try the larger blocks.
+	 */
+	Size_node *c = child(RIGHT);
+	return c ? c->find_best_fit(size, align, from, to) : 0;
+}
+
+
 /**********************************
  ** Allocator_avl implementation **
  **********************************/
@@ -126,9 +165,12 @@ int Allocator_avl_base::_add_block(Block *block_metadata,
 	/* call constructor for new block */
 	construct_at<Block>(block_metadata, base, size, used);
 
-	/* insert block into avl tree */
+	/* insert block into avl trees */
 	_addr_tree.insert(block_metadata);
 
+	if (!used)
+		_size_tree.insert(&block_metadata->size_node());
+
 	return 0;
 }
 
@@ -139,6 +181,10 @@ void Allocator_avl_base::_destroy_block(Block *b)
 
 	/* remove block from both avl trees */
 	_addr_tree.remove(b);
+
+	if (!b->used())
+		_size_tree.remove(&b->size_node());
+
 	_md_alloc->free(b, _md_entry_size);
 }
 
@@ -263,6 +309,30 @@ int Allocator_avl_base::remove_range(addr_t base, size_t size)
 }
 
 
+Allocator_avl_base::Block *
+Allocator_avl_base::_find_best_fit(size_t size, unsigned align,
+                                   addr_t from, addr_t to)
+{
+	/*
+	 * For requests restricted to an address window, most candidates of the
+	 * size tree may lie outside of the window. In this case, search the
+	 * address tree guided by the 'max_avail' values instead.
+	 */
+	if (from != 0UL || to != ~0UL) {
+		Block *b = _addr_tree.first();
+		return b ? b->find_best_fit(size, align, from, to) : 0;
+	}
+
+	/*
+	 * Look up the smallest free block that can hold the request. Blocks of
+	 * at least 'size + 2^align - 1' bytes always fit. So only blocks smaller
+	 * than that may be skipped by the search because of the alignment.
+	 */
+	Size_node *n = _size_tree.first();
+	return n ? n->find_best_fit(size, align, from, to) : 0;
+}
+
+
 Range_allocator::Alloc_return
 Allocator_avl_base::alloc_aligned(size_t size, void **out_addr, int align,
                                   addr_t from, addr_t to)
@@ -272,8 +342,7 @@ Allocator_avl_base::alloc_aligned(size_t size, void **out_addr, int align,
 		return Alloc_return(Alloc_return::OUT_OF_METADATA);
 
 	/* find best fitting block */
-	Block *b = _addr_tree.first();
-	b = b ? b->find_best_fit(size, align, from, to) : 0;
+	Block *b = _find_best_fit(size, align, from, to);
 
 	if (!b) {
 		_md_alloc->free(dst1, sizeof(Block));
@@ -259,17 +259,19 @@ void Child::_close(Session* s)
 }
 
 
-void Child::revoke_server(Server const *server)
+bool Child::revoke_server(Server const *server)
 {
 	Lock::Guard lock_guard(_lock);
 
-	while (1) {
+	bool revoked = false;
+
+	for (;; revoked = true) {
 		/* search session belonging to the specified server */
 		Session *s = _session_list.first();
 		for ( ; s && (s->server() != server); s = s->next());
 
 		/* if no matching session exists, we are done */
-		if (!s) return;
+		if (!s) return revoked;
 
 		_session_pool.apply(s->cap(), [&] (Session *s) {
 			if (s) _session_pool.remove(s); });
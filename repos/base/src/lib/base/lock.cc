@@ -14,6 +14,7 @@
 /* Genode includes */
 #include <base/cancelable_lock.h>
 #include <cpu/memory_barrier.h>
+#include <base/trace/events.h>
 
 /* base-internal includes */
 #include <base/internal/spin_lock.h>
@@ -60,10 +61,37 @@ void Cancelable_lock::Applicant::wake_up()
  ** Cancelable lock **
  *********************/
 
+/**
+ * Generate trace event if the lock is held by another thread
+ *
+ * The lock state is inspected without holding the spinlock because the
+ * event must not be generated while being enqueued as applicant. The trace
+ * logger may take locks itself when evaluating the tracing condition.
+ * Locks that are used as blocking primitive, i.e., locked twice by the same
+ * thread, are not reported.
+ *
+ * \return  true if a 'Lock_wait' event was generated
+ */
+bool Cancelable_lock::_trace_contention(Thread *myself)
+{
+	if (_state != LOCKED)
+		return false;
+
+	Thread * const holder = _owner.thread_base();
+	if (!thread_base_valid(holder) || holder == myself)
+		return false;
+
+	Trace::Lock_wait trace_event(this, holder);
+	return true;
+}
+
+
 void Cancelable_lock::lock()
 {
 	Applicant myself(Thread::myself());
 
+	bool const contended = _trace_contention(myself.thread_base());
+
 	spinlock_lock(&_spinlock_state);
 
 	/* reset ownership if one thread 'lock' twice */
@@ -76,6 +104,8 @@ void Cancelable_lock::lock()
 		_owner          =  myself;
 		_last_applicant = &_owner;
 		spinlock_unlock(&_spinlock_state);
+
+		if (contended) { Trace::Lock_acquired trace_event(this); }
 		return;
 	}
 
@@ -133,6 +163,8 @@ void Cancelable_lock::lock()
 		throw Blocking_canceled();
 	}
 	spinlock_unlock(&_spinlock_state);
+
+	if (contended) { Trace::Lock_acquired trace_event(this); }
 }
 
 
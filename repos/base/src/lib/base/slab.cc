@@ -28,12 +28,29 @@ class Genode::Slab::Block
 		Block *next = this;  /* next block in ring     */
 		Block *prev = this;  /* previous block in ring */
 
+		Block *avail_next = nullptr;  /* next block in ring of non-full blocks     */
+		Block *avail_prev = nullptr;  /* previous block in ring of non-full blocks */
+
 	private:
 
 		enum { FREE, USED };
 
-		Slab  &_slab;                              /* back reference to slab     */
-		size_t _avail = _slab._entries_per_block;  /* free entries of this block */
+		enum { NO_ENTRY = ~0U };
+
+		/**
+		 * Link of the free-entry list, stored in place of a free entry
+		 */
+		struct Free_link
+		{
+			unsigned next;
+
+			Free_link(unsigned next) : next(next) { }
+		};
+
+		Slab    &_slab;                              /* back reference to slab     */
+		size_t   _avail = _slab._entries_per_block;  /* free entries of this block */
+		unsigned _first_free = NO_ENTRY;             /* head of free-entry list    */
+		unsigned _num_touched = 0;                   /* entries ever allocated     */
 
 		/*
 		 * Each slab block consists of three areas, a fixed-size header
@@ -43,6 +60,10 @@ class Genode::Slab::Block
 		 * of state-table elements corresponds to the maximum number of slab
 		 * entries per slab block (the '_entries_per_block' member variable of
 		 * the Slab allocator).
+		 *
+		 * Freed entries are kept in a list that is linked through the
+		 * entries themselves. Entries that were never allocated are handed
+		 * out in the order of their index once the list is empty.
 		 */
 
 		char _data[];  /* dynamic data (state table and slab entries) */
@@ -92,15 +113,19 @@ class Genode::Slab::Block
 		 */
 		void *alloc();
 
+		/**
+		 * Release slab entry of block
+		 */
+		void free(Entry *e);
+
 		/**
 		 * Return a used slab block entry
 		 */
 		Entry *any_used_entry();
 
 		/**
-		 * These functions are called by Slab::Entry.
+		 * This function is called by Slab::Entry.
 		 */
-		void inc_avail(Entry &e);
 		void dec_avail() { _avail--; }
 };
 
@@ -119,11 +144,6 @@ struct Genode::Slab::Entry
 			block.dec_avail();
 		}
 
-		~Entry()
-		{
-			block.inc_avail(*this);
-		}
-
 		/**
 		 * Lookup Entry by given address
 		 *
@@ -161,16 +181,35 @@ int Slab::Block::_slab_entry_idx(Slab::Entry *e)
 
 void *Slab::Block::alloc()
 {
-	for (unsigned i = 0; i < _slab._entries_per_block; i++) {
-		if (_state(i) != FREE)
-			continue;
-
-		_state(i, USED);
-		Entry * const e = _slab_entry(i);
-		construct_at<Entry>(e, *this);
-		return e->data;
+	unsigned idx = NO_ENTRY;
+
+	if (_first_free != NO_ENTRY) {
+		idx = _first_free;
+		_first_free = reinterpret_cast<Free_link *>(_slab_entry(idx))->next;
+
+	} else if (_num_touched < _slab._entries_per_block) {
+		idx = _num_touched++;
+
+	} else {
+		return nullptr;
 	}
-	return nullptr;
+
+	_state(idx, USED);
+	Entry * const e = _slab_entry(idx);
+	construct_at<Entry>(e, *this);
+	return e->data;
+}
+
+
+void Slab::Block::free(Entry *e)
+{
+	unsigned const idx = _slab_entry_idx(e);
+
+	/* mark slab entry as free and put it at the front of the free list */
+	_state(idx, FREE);
+	construct_at<Free_link>(e, _first_free);
+	_first_free = idx;
+	_avail++;
 }
 
 
@@ -184,14 +223,6 @@ Slab::Entry *Slab::Block::any_used_entry()
 }
 
 
-void Slab::Block::inc_avail(Entry &e)
-{
-	/* mark slab entry as free */
-	_state(_slab_entry_idx(&e), FREE);
-	_avail++;
-}
-
-
 /**********
  ** Slab **
  **********/
@@ -229,6 +260,8 @@ Slab::Slab(size_t slab_size, size_t block_size, void *initial_sb,
 	construct_at<Block>(_curr_sb, *this);
 	_total_avail = _entries_per_block;
 	_num_blocks  = 1;
+
+	_link_avail_sb(_curr_sb);
 }
 
 
@@ -285,10 +318,12 @@ void Slab::_free_curr_sb()
 	if (_num_blocks <= 1)
 		return;
 
-	/* remove block from ring */
+	/* remove block from rings */
 	block->prev->next = block->next;
 	block->next->prev = block->prev;
 
+	_unlink_avail_sb(block);
+
 	_release_backing_store(block);
 }
 
@@ -303,6 +338,41 @@ void Slab::_insert_sb(Block *sb)
 
 	_total_avail += _entries_per_block;
 	_num_blocks++;
+
+	_link_avail_sb(sb);
+}
+
+
+void Slab::_link_avail_sb(Block *sb)
+{
+	if (!_avail_sb) {
+		sb->avail_next = sb->avail_prev = sb;
+	} else {
+		sb->avail_next = _avail_sb;
+		sb->avail_prev = _avail_sb->avail_prev;
+
+		_avail_sb->avail_prev->avail_next = sb;
+		_avail_sb->avail_prev = sb;
+	}
+	_avail_sb = sb;
+}
+
+
+void Slab::_unlink_avail_sb(Block *sb)
+{
+	if (!sb->avail_next)
+		return;
+
+	if (sb->avail_next == sb) {
+		_avail_sb = nullptr;
+	} else {
+		sb->avail_prev->avail_next = sb->avail_next;
+		sb->avail_next->avail_prev = sb->avail_prev;
+
+		if (_avail_sb == sb)
+			_avail_sb = sb->avail_next;
+	}
+	sb->avail_next = sb->avail_prev = nullptr;
 }
 
 
@@ -331,26 +401,25 @@ bool Slab::alloc(size_t size, void **out_addr)
 
 		if (!sb) return false;
 
-		/*
-		 * The new block has the maximum number of available slots and
-		 * so we can insert it at the beginning of the sorted block
-		 * list.
-		 */
 		_insert_sb(sb);
 	}
 
-	/* skip completely occupied slab blocks, detect cycles */
-	Block const * const orig_curr_sb = _curr_sb;
-	for (; _curr_sb->avail() == 0; _curr_sb = _curr_sb->next)
-		if (_curr_sb->next == orig_curr_sb)
-			break;
+	/* all blocks are completely occupied */
+	if (!_avail_sb)
+		return false;
+
+	Block * const sb = _avail_sb;
 
-	*out_addr = _curr_sb->alloc();
+	*out_addr = sb->alloc();
 
 	if (*out_addr == nullptr)
 		return false;
 
+	if (sb->avail() == 0)
+		_unlink_avail_sb(sb);
+
 	_total_avail--;
+	_max_used = max(_max_used, _num_blocks*_entries_per_block - _total_avail);
 	return true;
 }
 
@@ -364,9 +433,14 @@ void Slab::_free(void *addr)
 
 	Block &block = e->block;
 
-	e->~Entry();
+	bool const block_was_full = (block.avail() == 0);
+
+	block.free(e);
 	_total_avail++;
 
+	if (block_was_full)
+		_link_avail_sb(&block);
+
 	/*
 	 * Release completely free slab blocks if the total number of free slab
 	 * entries exceeds the capacity of two slab blocks. This way we keep
@@ -402,3 +476,10 @@ void *Slab::any_used_elem()
 
 
 size_t Slab::consumed() const { return _num_blocks*_block_size; }
+
+
+Slab::Stats Slab::stats() const
+{
+	return Stats { _num_blocks, _num_blocks*_entries_per_block - _total_avail,
+	               _max_used };
+}
@@ -0,0 +1,175 @@
+/*
+ * \brief  Heap front end with per-thread caches of small blocks
+ * \author Genode Labs
+ * \date   2016-08-24
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#include <base/heap.h>
+#include <base/thread.h>
+
+using namespace Genode;
+
+
+Thread_cached_heap::Stripe &Thread_cached_heap::_stripe_of_myself()
+{
+	/*
+	 * The main thread may have no 'Thread' object, which maps it to
+	 * stripe 0. Thread objects are at least a few hundred bytes in size, so
+	 * we drop the lower address bits before hashing.
+	 */
+	addr_t const key = (addr_t)Thread::myself() >> 8;
+
+	return _stripes[(key ^ (key >> 3) ^ (key >> 7)) % NUM_STRIPES];
+}
+
+
+void Thread_cached_heap::_release(Free_block *chain, unsigned size_class)
+{
+	while (chain) {
+		Free_block *next = chain->next;
+		_heap.free(chain, _block_size(size_class));
+		chain = next;
+	}
+}
+
+
+void Thread_cached_heap::flush()
+{
+	for (unsigned i = 0; i < NUM_STRIPES; i++) {
+
+		Stripe &stripe = _stripes[i];
+
+		for (unsigned c = 0; c < NUM_SIZE_CLASSES; c++) {
+
+			Free_block *chain = nullptr;
+			{
+				Lock::Guard guard(stripe.lock);
+
+				Magazine &magazine = stripe.magazines[c];
+
+				chain = magazine.first;
+				stripe.cached_bytes -= magazine.count*_block_size(c);
+				magazine = Magazine();
+			}
+			_release(chain, c);
+		}
+	}
+}
+
+
+bool Thread_cached_heap::alloc(size_t size, void **out_addr)
+{
+	/* determine size class */
+	unsigned size_class = 0;
+	while (size_class < NUM_SIZE_CLASSES
+	    && size > (1UL << (size_class + MIN_CLASS_SIZE_LOG2)))
+		size_class++;
+
+	Header *header = nullptr;
+
+	if (size_class < NUM_SIZE_CLASSES) {
+
+		Stripe &stripe = _stripe_of_myself();
+
+		Lock::Guard guard(stripe.lock);
+
+		Magazine &magazine = stripe.magazines[size_class];
+		if (magazine.first) {
+			header = (Header *)magazine.first;
+			magazine.first = magazine.first->next;
+			magazine.count--;
+			stripe.cached_bytes -= _block_size(size_class);
+		}
+	}
+
+	/* cache miss or large allocation, allocate block at the heap */
+	if (!header) {
+
+		size_t const block_size = size_class < NUM_SIZE_CLASSES
+		                        ? _block_size(size_class)
+		                        : sizeof(Header) + size;
+
+		if (!_heap.alloc(block_size, (void **)&header))
+			return false;
+	}
+
+	header->size_class = size_class;
+	*out_addr = header + 1;
+	return true;
+}
+
+
+void Thread_cached_heap::free(void *addr, size_t)
+{
+	Header * const header     = (Header *)addr - 1;
+	unsigned const size_class = header->size_class;
+
+	if (size_class >= NUM_SIZE_CLASSES) {
+		_heap.free(header, 0);
+		return;
+	}
+
+	Free_block *surplus = nullptr;
+	{
+		Stripe &stripe = _stripe_of_myself();
+
+		Lock::Guard guard(stripe.lock);
+
+		Magazine &magazine = stripe.magazines[size_class];
+
+		Free_block * const block = (Free_block *)header;
+		block->next    = magazine.first;
+		magazine.first = block;
+		magazine.count++;
+		stripe.cached_bytes += _block_size(size_class);
+
+		/*
+		 * Once the magazine is full, detach its older half and return it to
+		 * the heap outside of the critical section.
+		 */
+		if (magazine.count > MAGAZINE_CAPACITY) {
+
+			Free_block *last = magazine.first;
+			for (unsigned i = 1; i < MAGAZINE_CAPACITY/2; i++)
+				last = last->next;
+
+			surplus    = last->next;
+			last->next = nullptr;
+
+			unsigned const num_surplus = magazine.count - MAGAZINE_CAPACITY/2;
+			magazine.count       = MAGAZINE_CAPACITY/2;
+			stripe.cached_bytes -= num_surplus*_block_size(size_class);
+		}
+	}
+
+	_release(surplus, size_class);
+}
+
+
+size_t Thread_cached_heap::consumed() const
+{
+	/*
+	 * Blocks held in the magazines are accounted at the heap but are not
+	 * in use by any client of the cache.
+	 */
+	size_t cached_bytes = 0;
+	for (unsigned i = 0; i < NUM_STRIPES; i++) {
+		Lock::Guard guard(_stripes[i].lock);
+		cached_bytes += _stripes[i].cached_bytes;
+	}
+
+	return _heap.consumed() - cached_bytes;
+}
+
+
+size_t Thread_cached_heap::overhead(size_t size) const
+{
+	return sizeof(Header) + _heap.overhead(sizeof(Header) + size);
+}
@@ -15,6 +15,8 @@
 #include <base/env.h>
 #include <base/thread.h>
 #include <base/trace/policy.h>
+#include <base/trace/events.h>
+#include <base/semaphore.h>
 #include <dataspace/client.h>
 #include <util/construct_at.h>
 #include <cpu_thread/client.h>
@@ -219,3 +221,11 @@ Trace::Logger *Thread::_logger()
 
 	return logger;
 }
+
+
+/***************
+ ** Semaphore **
+ ***************/
+
+void Semaphore::_trace_block() const { Trace::Semaphore_block trace_event(this); }
+void Semaphore::_trace_woken() const { Trace::Semaphore_woken trace_event(this); }
@@ -13,6 +13,7 @@
 
 #include <debug.h>
 #include <linker.h>
+#include <dynamic.h>
 
 /*
  * GDB can set a breakpoint at this function to find out when ldso has loaded
@@ -38,3 +39,13 @@ void Linker::dump_link_map(Object *o)
 		            ": ", o->name());
 	}
 }
+
+
+void Linker::dump_lookup_stats(Object *o)
+{
+	for (; o; o = o->next_obj())
+		Genode::log("  ", o->name(), ": ",
+		            o->dynamic()->num_relocations(), " relocations, ",
+		            o->lookups(), " symbol lookups (",
+		            o->cached_lookups(), " cached)");
+}
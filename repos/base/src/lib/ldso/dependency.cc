@@ -25,12 +25,16 @@ Linker::Dependency::Dependency(char const *path, Root_object *root,
 	: obj(load(path, this, flags)), root(root)
 {
 	dep->enqueue(this);
+	flush_symbol_cache();
+
 	load_needed(dep, flags);
 }
 
 
 Linker::Dependency::~Dependency()
 {
+	flush_symbol_cache();
+
 	if (obj->unload()) {
 
 		if (verbose_loading)
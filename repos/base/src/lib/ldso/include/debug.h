@@ -26,6 +26,7 @@ namespace Linker {
 
 	struct Object;
 	void dump_link_map(Object *o);
+	void dump_lookup_stats(Object *o);
 }
 
 /*
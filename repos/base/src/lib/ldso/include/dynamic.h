@@ -18,6 +18,8 @@
 
 namespace Linker {
 	struct Hash_table;
+	struct Gnu_hash_table;
+	class  Symbol_hash;
 	struct Dynamic;
 }
 
@@ -51,6 +53,110 @@ struct Linker::Hash_table
 };
 
 
+/**
+ * GNU hash table and hash function
+ *
+ * In contrast to the ELF hash table, the table starts with a bloom filter
+ * that rejects most symbols not defined by the object without touching the
+ * hash chains. The chains contain the hash values of the symbols, which
+ * makes string comparisons for non-matching symbols unnecessary. Only
+ * symbols starting at 'symoffset' are covered by the table.
+ */
+struct Linker::Gnu_hash_table
+{
+	Elf::Hashelt const nbuckets;
+	Elf::Hashelt const symoffset;
+	Elf::Hashelt const bloom_size;
+	Elf::Hashelt const bloom_shift;
+
+	Elf::Addr    const *bloom()   const { return (Elf::Addr const *)(this + 1); }
+	Elf::Hashelt const *buckets() const { return (Elf::Hashelt const *)(bloom() + bloom_size); }
+	Elf::Hashelt const *chains()  const { return buckets() + nbuckets; }
+
+	/**
+	 * GNU hash function (DJB hash)
+	 */
+	static Elf::Hashelt hash(char const *name)
+	{
+		Elf::Hashelt h = 5381;
+
+		for (unsigned char const *p = (unsigned char const *)name; *p; p++)
+			h = (h << 5) + h + *p;
+
+		return h;
+	}
+
+	/**
+	 * Return false if the object definitely lacks a symbol with 'hash'
+	 */
+	bool may_contain(Elf::Hashelt hash) const
+	{
+		enum { BITS = sizeof(Elf::Addr)*8 };
+
+		Elf::Addr const word = bloom()[(hash / BITS) & (bloom_size - 1)];
+		Elf::Addr const mask = ((Elf::Addr)1 << (hash % BITS))
+		                     | ((Elf::Addr)1 << ((hash >> bloom_shift) % BITS));
+
+		return (word & mask) == mask;
+	}
+
+	/**
+	 * Return number of entries of the dynamic symbol table
+	 *
+	 * The GNU hash table does not record the size of the symbol table. The
+	 * last symbol is the end of the chain of the highest bucket.
+	 */
+	unsigned long num_symbols() const
+	{
+		unsigned long last = 0;
+		for (unsigned i = 0; i < nbuckets; i++)
+			last = Genode::max(last, (unsigned long)buckets()[i]);
+
+		if (last < symoffset)
+			return symoffset;
+
+		while (!(chains()[last - symoffset] & 1))
+			last++;
+
+		return last + 1;
+	}
+};
+
+
+/**
+ * Hash values of a symbol name
+ *
+ * The ELF hash value is needed for objects without GNU hash table only and
+ * is, therefore, computed on demand.
+ */
+class Linker::Symbol_hash
+{
+	private:
+
+		char const *_name;
+
+		Elf::Hashelt const    _gnu;
+		mutable unsigned long _sysv = 0;
+		mutable bool          _sysv_valid = false;
+
+	public:
+
+		Symbol_hash(char const *name)
+		: _name(name), _gnu(Gnu_hash_table::hash(name)) { }
+
+		Elf::Hashelt gnu() const { return _gnu; }
+
+		unsigned long sysv() const
+		{
+			if (!_sysv_valid) {
+				_sysv       = Hash_table::hash(_name);
+				_sysv_valid = true;
+			}
+			return _sysv;
+		}
+};
+
+
 /**
  * .dynamic section entries
  */
@@ -78,6 +184,8 @@ struct Linker::Dynamic
 	Elf::Dyn   const     *dynamic;
 
 	Hash_table          *hash_table    = nullptr;
+	Gnu_hash_table      *gnu_hash_table = nullptr;
+	unsigned long        num_symbols   = 0;
 
 	Elf::Rela           *reloca        = nullptr;
 	unsigned long        reloca_size   = 0;
@@ -167,10 +275,29 @@ struct Linker::Dynamic
 				case DT_REL     : section<typeof(rel)>(&rel, d);                     break;
 				case DT_RELSZ   : rel_size = d->un.val;                              break;
 				case DT_DEBUG   : section_dt_debug(d);                               break;
+				case DT_GNU_HASH: section<typeof(gnu_hash_table)>(&gnu_hash_table, d); break;
 				default:
 					break;
 			}
 		}
+
+		if (hash_table)
+			num_symbols = hash_table->nchains();
+		else if (gnu_hash_table)
+			num_symbols = gnu_hash_table->num_symbols();
+	}
+
+	/**
+	 * Return number of relocations to apply at load time or lazily
+	 */
+	unsigned long num_relocations() const
+	{
+		unsigned long const pltrel_entry_size = pltrel_type == DT_RELA
+		                                      ? sizeof(Elf::Rela) : sizeof(Elf::Rel);
+
+		return reloca_size / sizeof(Elf::Rela)
+		     + rel_size    / sizeof(Elf::Rel)
+		     + pltrel_size / pltrel_entry_size;
 	}
 
 	void relocate()
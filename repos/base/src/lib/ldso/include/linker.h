@@ -96,6 +96,13 @@ namespace Linker {
 	Elf::Sym const *lookup_symbol(char const *name, Dependency const *dep, Elf::Addr *base,
 	                              bool undef = false, bool other = false);
 
+	/**
+	 * Invalidate cached results of symbol lookups
+	 *
+	 * Must be called whenever a dependency list changes.
+	 */
+	void flush_symbol_cache();
+
 	/**
 	 * Load an ELF (setup segments and map program header)
 	 *
@@ -152,6 +159,10 @@ class Linker::Object : public Genode::Fifo<Object>::Element,
 		File const *_file = nullptr;
 		Elf::Addr   _reloc_base = 0;
 
+		/* statistics about the symbol lookups of the object's relocations */
+		mutable unsigned long _lookups        = 0;
+		mutable unsigned long _cached_lookups = 0;
+
 	public:
 
 		Object(Elf::Addr reloc_base) : _reloc_base(reloc_base) { }
@@ -173,6 +184,16 @@ class Linker::Object : public Genode::Fifo<Object>::Element,
 		File      const *file() { return _file; }
 		Elf::Size const  size() const { return _file ? _file->size : 0; }
 
+		void count_lookup(bool cached) const
+		{
+			_lookups++;
+			if (cached)
+				_cached_lookups++;
+		}
+
+		unsigned long lookups()        const { return _lookups; }
+		unsigned long cached_lookups() const { return _cached_lookups; }
+
 		virtual bool is_linker() const = 0;
 		virtual bool is_binary() const = 0;
 
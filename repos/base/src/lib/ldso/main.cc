@@ -32,6 +32,7 @@ namespace Linker {
 	struct Binary;
 	struct Link_map;
 	struct Debug;
+	class  Symbol_cache;
 
 };
 
@@ -102,7 +103,7 @@ struct Linker::Elf_object : Object, Genode::Fifo<Elf_object>::Element
 	 */
 	Elf::Sym const *symbol(unsigned sym_index) const
 	{
-		if (sym_index > dyn.hash_table->nchains())
+		if (sym_index >= dyn.num_symbols)
 			return 0;
 
 		return dyn.symtab + sym_index;
@@ -116,9 +117,23 @@ struct Linker::Elf_object : Object, Genode::Fifo<Elf_object>::Element
 	}
 
 	/**
-	 * Lookup symbol name in this ELF
+	 * Return true if symbol 'sym' is a definition of 'name'
 	 */
-	Elf::Sym const *lookup_symbol(char const *name, unsigned long hash) const
+	bool _matches(Elf::Sym const *sym, char const *name) const
+	{
+		/* this omitts everything but 'NOTYPE', 'OBJECT', and 'FUNC' */
+		if (sym->type() > STT_FUNC)
+			return false;
+
+		if (sym->st_value == 0)
+			return false;
+
+		/* check for symbol name */
+		char const *sym_name = symbol_name(sym);
+		return name[0] == sym_name[0] && !Genode::strcmp(name, sym_name);
+	}
+
+	Elf::Sym const *_lookup_sysv(char const *name, unsigned long hash) const
 	{
 		Hash_table *h = dyn.hash_table;
 
@@ -134,22 +149,65 @@ struct Linker::Elf_object : Object, Genode::Fifo<Elf_object>::Element
 			if (sym_index > h->nchains())
 				return nullptr;
 
-			Elf::Sym const *sym      = symbol(sym_index);
-			char const     *sym_name = symbol_name(sym);
+			Elf::Sym const *sym = symbol(sym_index);
 
-			/* this omitts everything but 'NOTYPE', 'OBJECT', and 'FUNC' */
-			if (sym->type() > STT_FUNC)
-				continue;
+			if (_matches(sym, name))
+				return sym;
+		}
 
-			if (sym->st_value == 0)
-				continue;
+		return nullptr;
+	}
 
-			/* check for symbol name */
-			if (name[0] != sym_name[0] || Genode::strcmp(name, sym_name))
-				continue;
+	Elf::Sym const *_lookup_gnu(char const *name, Elf::Hashelt hash) const
+	{
+		Gnu_hash_table const *h = dyn.gnu_hash_table;
+
+		if (!h->nbuckets || !h->may_contain(hash))
+			return nullptr;
+
+		unsigned long sym_index = h->buckets()[hash % h->nbuckets];
+
+		/* empty bucket */
+		if (sym_index < h->symoffset)
+			return nullptr;
+
+		/*
+		 * Traverse hash chain, the lowest bit of a chain entry marks the
+		 * end of the chain
+		 */
+		for (;; sym_index++) {
+
+			/* bad object */
+			if (sym_index >= dyn.num_symbols)
+				return nullptr;
 
-			return sym;
+			Elf::Hashelt const chain = h->chains()[sym_index - h->symoffset];
+
+			if ((chain | 1) == (hash | 1)) {
+				Elf::Sym const *sym = symbol(sym_index);
+
+				if (_matches(sym, name))
+					return sym;
+			}
+
+			if (chain & 1)
+				return nullptr;
 		}
+	}
+
+	/**
+	 * Lookup symbol name in this ELF
+	 *
+	 * The GNU hash table is preferred over the ELF hash table if the
+	 * object provides both.
+	 */
+	Elf::Sym const *lookup_symbol(char const *name, Symbol_hash const &hash) const
+	{
+		if (dyn.gnu_hash_table)
+			return _lookup_gnu(name, hash.gnu());
+
+		if (dyn.hash_table)
+			return _lookup_sysv(name, hash.sysv());
 
 		return nullptr;
 	}
@@ -184,9 +242,7 @@ struct Linker::Elf_object : Object, Genode::Fifo<Elf_object>::Element
 		info.base = map.addr;
 		info.addr = 0;
 
-		Hash_table *h = dyn.hash_table;
-
-		for (unsigned long sym_index = 0; sym_index < h->nchains(); sym_index++)
+		for (unsigned long sym_index = 0; sym_index < dyn.num_symbols; sym_index++)
 		{
 			Elf::Sym const *sym = symbol(sym_index);
 
@@ -260,7 +316,10 @@ struct Linker::Ld : Dependency, Elf_object
 		 * Use DT_HASH table address for linker, assuming that it will always be at
 		 * the beginning of the file
 		 */
-		map.addr = trunc_page((Elf::Addr)dynamic()->hash_table);
+		Elf::Addr const hash_table = dynamic()->hash_table
+		                           ? (Elf::Addr)dynamic()->hash_table
+		                           : (Elf::Addr)dynamic()->gnu_hash_table;
+		map.addr = trunc_page(hash_table);
 	}
 
 	void load_phdr()
@@ -352,7 +411,7 @@ struct Linker::Binary : Root_object, Elf_object
 	{
 		Elf::Sym const *symbol = 0;
 
-		if ((symbol = Elf_object::lookup_symbol(name, Hash_table::hash(name))))
+		if ((symbol = Elf_object::lookup_symbol(name, Symbol_hash(name))))
 			return reloc_base() + symbol->st_value;
 
 		return 0;
@@ -445,11 +504,110 @@ Elf::Sym const *Linker::lookup_symbol(unsigned sym_index, Dependency const *dep,
 }
 
 
-Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const *dep,
-                                      Elf::Addr *base, bool undef, bool other)
+/**
+ * Cache of symbol-lookup results
+ *
+ * Relocations of different objects refer to the same symbols over and over
+ * again. The cache maps a symbol name and the dependency list searched for
+ * the symbol to the lookup result. Since the result depends on the loaded
+ * objects, the cache is flushed whenever a dependency is added or removed.
+ * Names are copied into the cache because the caller's string (e.g., the
+ * argument of 'dlsym') may vanish after the lookup. Names longer than the
+ * entry buffer are not cached.
+ */
+class Linker::Symbol_cache
+{
+	private:
+
+		enum { NUM_ENTRIES = 1024, MAX_NAME_LEN = 64 };
+
+		struct Entry
+		{
+			char              name[MAX_NAME_LEN];
+			Dependency const *scope;
+			Elf::Sym   const *symbol;
+			Elf::Addr         base;
+			Elf::Hashelt      hash;
+			bool              undef;
+		};
+
+		Genode::Lock  _lock;
+		Entry        *_entries = nullptr;
+
+		Entry &_entry(Symbol_hash const &hash) {
+			return _entries[hash.gnu() % NUM_ENTRIES]; }
+
+	public:
+
+		Elf::Sym const *lookup(char const *name, Symbol_hash const &hash,
+		                       Dependency const *scope, bool undef, Elf::Addr *base)
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			if (!_entries)
+				return nullptr;
+
+			Entry const &e = _entry(hash);
+
+			if (!e.symbol || e.hash != hash.gnu() || e.scope != scope
+			 || e.undef != undef || Genode::strcmp(e.name, name))
+				return nullptr;
+
+			*base = e.base;
+			return e.symbol;
+		}
+
+		void insert(char const *name, Symbol_hash const &hash,
+		            Dependency const *scope, bool undef,
+		            Elf::Sym const *symbol, Elf::Addr base)
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			if (!_entries) {
+				_entries = (Entry *)Genode::env()->heap()->alloc(sizeof(Entry)*NUM_ENTRIES);
+				Genode::memset(_entries, 0, sizeof(Entry)*NUM_ENTRIES);
+			}
+
+			if (Genode::strlen(name) >= MAX_NAME_LEN)
+				return;
+
+			Entry &e = _entry(hash);
+			Genode::strncpy(e.name, name, sizeof(e.name));
+			e.scope  = scope;
+			e.symbol = symbol;
+			e.base   = base;
+			e.hash   = hash.gnu();
+			e.undef  = undef;
+		}
+
+		void flush()
+		{
+			Genode::Lock::Guard guard(_lock);
+
+			if (_entries)
+				Genode::memset(_entries, 0, sizeof(Entry)*NUM_ENTRIES);
+		}
+};
+
+
+static Symbol_cache &symbol_cache()
+{
+	static Symbol_cache _cache;
+	return _cache;
+}
+
+
+void Linker::flush_symbol_cache() { symbol_cache().flush(); }
+
+
+/**
+ * Find symbol via name without consulting the symbol cache
+ */
+static Elf::Sym const *lookup_symbol_uncached(char const *name, Symbol_hash const &hash,
+                                              Dependency const *dep, Elf::Addr *base,
+                                              bool undef, bool other)
 {
 	Dependency const *curr        = dep->root ? dep->root->dep.head() : dep;
-	unsigned long     hash        = Hash_table::hash(name);
 	Elf::Sym   const *weak_symbol = 0;
 	Elf::Addr        weak_base    = 0;
 	Elf::Sym   const *symbol      = 0;
@@ -487,7 +645,8 @@ Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const *dep,
 	/* try searching binary's dependencies */
 	if (!weak_symbol && dep->root) {
 		if (binary && dep != binary->dep.head()) {
-			return lookup_symbol(name, binary->dep.head(), base, undef, other);
+			return lookup_symbol_uncached(name, hash, binary->dep.head(),
+			                              base, undef, other);
 		} else {
 			Genode::error("LD: could not lookup symbol \"", name, "\"");
 			throw Not_found();
@@ -505,6 +664,35 @@ Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const *dep,
 }
 
 
+Elf::Sym const *Linker::lookup_symbol(char const *name, Dependency const *dep,
+                                      Elf::Addr *base, bool undef, bool other)
+{
+	Symbol_hash const hash(name);
+
+	/*
+	 * Lookups without root happen while the linker relocates itself and
+	 * cannot use the heap. Lookups that skip the requesting object are
+	 * needed for copy relocations only.
+	 */
+	if (!dep->root || other)
+		return lookup_symbol_uncached(name, hash, dep, base, undef, other);
+
+	Dependency const * const scope = dep->root->dep.head();
+
+	Elf::Sym const *symbol = symbol_cache().lookup(name, hash, scope, undef, base);
+
+	dep->obj->count_lookup(symbol != nullptr);
+
+	if (symbol)
+		return symbol;
+
+	symbol = lookup_symbol_uncached(name, hash, dep, base, undef, other);
+	symbol_cache().insert(name, hash, scope, undef, symbol, *base);
+
+	return symbol;
+}
+
+
 void Linker::load_linker_phdr()
 {
 	if (!Ld::linker()->file())
@@ -578,6 +766,7 @@ void Component::construct(Genode::Env &env)
 			                Thread::stack_area_virtual_size() - 1),
 			    ": stack area");
 			dump_link_map(Elf_object::obj_list()->head());
+			dump_lookup_stats(Elf_object::obj_list()->head());
 		}
 	} catch (...) {  }
 
@@ -67,8 +67,10 @@ Genode::Shared_object::Shared_object(char const *file, unsigned flags)
 
 		/* print loaded object information */
 		try {
-			if (Linker::verbose)
+			if (Linker::verbose) {
 				Linker::dump_link_map(to_root(_handle)->dep.head()->obj);
+				Linker::dump_lookup_stats(to_root(_handle)->dep.head()->obj);
+			}
 		} catch (...) {  }
 
 	} catch (...) { throw Invalid_file(); }
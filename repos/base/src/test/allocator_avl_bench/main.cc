@@ -0,0 +1,168 @@
+/*
+ * \brief  Fragmentation and latency benchmark for the AVL range allocator
+ * \author Genode Labs
+ * \date   2016-08-25
+ *
+ * The benchmark manages a large address range, which is never accessed. It
+ * fragments the range by allocating blocks of pseudo-random sizes and
+ * freeing a pseudo-random subset of them. Afterwards, it measures the
+ * latency of further allocations and reports the largest remaining free
+ * block.
+ *
+ * Each pattern is executed twice, once with unrestricted allocations, which
+ * are served by the size-sorted tree of free blocks, and once restricted to
+ * the (complete) managed range, which lets the allocator search its
+ * address-sorted tree.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/allocator_avl.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Pattern;
+	struct Main;
+
+	enum { RANGE_BASE = 0x10000000, RANGE_SIZE = 0x40000000 };
+}
+
+
+struct Test::Pattern
+{
+	char const *name;
+	size_t      min_size;
+	size_t      max_size;
+	int         align_log2;
+};
+
+
+struct Test::Main
+{
+	enum { NUM_BLOCKS = 20000, NUM_PROBES = 20000 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Heap heap { env.ram(), env.rm() };
+
+	addr_t blocks[NUM_BLOCKS];
+
+	unsigned seed = 1;
+
+	unsigned random()
+	{
+		seed = seed*1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	size_t random_size(Pattern const &p) {
+		return p.min_size + random() % (p.max_size - p.min_size + 1); }
+
+	/**
+	 * Return size of the largest block that can be allocated
+	 */
+	static size_t largest_free_block(Allocator_avl &alloc)
+	{
+		size_t lo = 0, hi = RANGE_SIZE;
+		while (lo < hi) {
+			size_t const size = (lo + hi + 1)/2;
+			void *addr = nullptr;
+			if (alloc.alloc_aligned(size, &addr, 0).ok()) {
+				alloc.free(addr);
+				lo = size;
+			} else {
+				hi = size - 1;
+			}
+		}
+		return lo;
+	}
+
+	void measure(Pattern const &p, bool restricted)
+	{
+		Allocator_avl alloc(&heap);
+		alloc.add_range(RANGE_BASE, RANGE_SIZE);
+
+		addr_t const from = restricted ? RANGE_BASE : 0UL;
+		addr_t const to   = restricted ? RANGE_BASE + RANGE_SIZE - 1 : ~0UL;
+
+		auto alloc_block = [&] (size_t size) -> addr_t {
+			void *addr = nullptr;
+			return alloc.alloc_aligned(size, &addr, p.align_log2, from, to).ok()
+			     ? (addr_t)addr : 0; };
+
+		seed = 1;
+
+		/* fragment the range */
+		for (unsigned i = 0; i < NUM_BLOCKS; i++)
+			blocks[i] = alloc_block(random_size(p));
+
+		for (unsigned i = 0; i < NUM_BLOCKS; i++)
+			if (blocks[i] && (random() & 1)) {
+				alloc.free((void *)blocks[i]);
+				blocks[i] = 0;
+			}
+
+		/* measure allocation latency in the fragmented range */
+		unsigned failed = 0;
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < NUM_PROBES; i++) {
+
+			unsigned const idx = random() % NUM_BLOCKS;
+
+			if (blocks[idx])
+				alloc.free((void *)blocks[idx]);
+
+			blocks[idx] = alloc_block(random_size(p));
+			if (!blocks[idx])
+				failed++;
+		}
+
+		unsigned long const duration_ms = timer.elapsed_ms() - start_ms;
+
+		log(p.name, restricted ? " (address tree): " : " (size tree):    ",
+		    (unsigned)NUM_PROBES, " alloc/free in ", duration_ms, " ms, ",
+		    failed, " failed, avail ", alloc.avail()/1024, " KiB, "
+		    "largest free block ", largest_free_block(alloc)/1024, " KiB");
+
+		for (unsigned i = 0; i < NUM_BLOCKS; i++)
+			if (blocks[i])
+				alloc.free((void *)blocks[i]);
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- allocator-avl benchmark started ---");
+
+		Pattern const patterns[] = {
+			{ "small blocks",    16,    256,       3 },
+			{ "mixed blocks",    16,    64*1024,   3 },
+			{ "page blocks",     4096,  256*1024,  12 },
+			{ "large blocks",    4096,  4096*1024, 12 },
+		};
+
+		for (Pattern const &p : patterns) {
+			measure(p, false);
+			measure(p, true);
+		}
+
+		log("--- allocator-avl benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-allocator_avl_bench
+SRC_CC = main.cc
+LIBS   = base
@@ -0,0 +1,150 @@
+/*
+ * \brief  Multi-threaded allocation stress test for the heap
+ * \author Genode Labs
+ * \date   2016-08-24
+ *
+ * A varying number of threads concurrently allocate and free small blocks
+ * of pseudo-random sizes, once using a plain 'Heap' and once using a
+ * 'Thread_cached_heap' in front of the heap. The benchmark reports the
+ * achieved operations per second and checks that the quota accounting
+ * returns to its initial state.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/thread.h>
+#include <base/log.h>
+#include <util/volatile_object.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Worker;
+	struct Main;
+
+	enum { MAX_THREADS = 8 };
+}
+
+
+struct Test::Worker : Thread
+{
+	enum { STACK_SIZE = 4*1024*sizeof(long), ROUNDS = 200000, WINDOW = 64 };
+
+	Allocator &_alloc;
+
+	unsigned _seed;
+
+	void *_blocks[WINDOW];
+
+	/**
+	 * Return pseudo-random block size between 8 and 512 bytes
+	 */
+	size_t _random_size()
+	{
+		_seed = _seed*1103515245 + 12345;
+		return 8 + ((_seed >> 16) % 505);
+	}
+
+	void entry() override
+	{
+		for (unsigned i = 0; i < WINDOW; i++)
+			_blocks[i] = nullptr;
+
+		for (unsigned i = 0; i < ROUNDS; i++) {
+
+			void *&block = _blocks[i % WINDOW];
+
+			if (block)
+				_alloc.free(block, 0);
+
+			if (!_alloc.alloc(_random_size(), &block)) {
+				error("allocation failed");
+				block = nullptr;
+			}
+		}
+
+		for (unsigned i = 0; i < WINDOW; i++)
+			if (_blocks[i])
+				_alloc.free(_blocks[i], 0);
+	}
+
+	Worker(Env &env, Allocator &alloc, unsigned id)
+	:
+		Thread(env, "worker", STACK_SIZE), _alloc(alloc), _seed(id)
+	{ }
+};
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Heap worker_heap { env.ram(), env.rm() };
+
+	void measure(char const *name, Allocator &alloc, unsigned num_threads)
+	{
+		Lazy_volatile_object<Worker> workers[MAX_THREADS];
+
+		for (unsigned i = 0; i < num_threads; i++)
+			workers[i].construct(env, alloc, i + 1);
+
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < num_threads; i++) workers[i]->start();
+		for (unsigned i = 0; i < num_threads; i++) workers[i]->join();
+
+		unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+
+		/* each round consists of one alloc and one free operation */
+		unsigned long const ops = 2UL*num_threads*Worker::ROUNDS;
+
+		log(name, ", ", num_threads, " threads: ", ops, " ops in ",
+		    duration_ms, " ms (", (ops/duration_ms)*1000, " ops/s)");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- heap benchmark started ---");
+
+		size_t const initial_consumed = worker_heap.consumed();
+
+		for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+			measure("heap", worker_heap, n);
+
+		{
+			Thread_cached_heap cached_heap(worker_heap);
+
+			for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+				measure("thread-cached heap", cached_heap, n);
+
+			if (cached_heap.consumed() != initial_consumed) {
+				error("unexpected quota of thread-cached heap: ",
+				      cached_heap.consumed(), " (expected ", initial_consumed, ")");
+				return;
+			}
+		}
+
+		if (worker_heap.consumed() != initial_consumed) {
+			error("thread-cached heap leaked ",
+			      worker_heap.consumed() - initial_consumed, " bytes");
+			return;
+		}
+
+		log("--- heap benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
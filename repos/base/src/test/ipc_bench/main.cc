@@ -0,0 +1,125 @@
+/*
+ * \brief  Benchmark for measuring the synchronous RPC round-trip rate
+ * \author Genode Labs
+ * \date   2016-08-22
+ *
+ * A client repeatedly invokes an RPC object served by a separate entrypoint
+ * of the same component. For each kind of call, the benchmark reports the
+ * achieved number of round trips per second.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/entrypoint.h>
+#include <base/rpc_server.h>
+#include <base/rpc_client.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Session;
+	struct Client;
+	struct Component;
+	struct Main;
+}
+
+
+struct Test::Session : Genode::Session
+{
+	static const char *service_name() { return "IPC_BENCH"; }
+
+	GENODE_RPC(Rpc_null, void, null);
+	GENODE_RPC(Rpc_add, unsigned long, add, unsigned long, unsigned long);
+	GENODE_RPC(Rpc_cap, Native_capability, cap, Native_capability);
+	GENODE_RPC_INTERFACE(Rpc_null, Rpc_add, Rpc_cap);
+};
+
+
+struct Test::Client : Genode::Rpc_client<Session>
+{
+	Client(Capability<Session> cap) : Rpc_client<Session>(cap) { }
+
+	void null() { call<Rpc_null>(); }
+
+	unsigned long add(unsigned long a, unsigned long b) {
+		return call<Rpc_add>(a, b); }
+
+	Native_capability cap(Native_capability cap) {
+		return call<Rpc_cap>(cap); }
+};
+
+
+struct Test::Component : Genode::Rpc_object<Session, Component>
+{
+	void null() { }
+
+	unsigned long add(unsigned long a, unsigned long b) { return a + b; }
+
+	Native_capability cap(Native_capability cap) { return cap; }
+};
+
+
+struct Test::Main
+{
+	enum { STACK_SIZE = 2*1024*sizeof(long), ROUNDS = 100000 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Entrypoint server_ep { env, STACK_SIZE, "server_ep" };
+
+	Test::Component component;
+
+	Capability<Session> cap = server_ep.manage(component);
+
+	Client client { cap };
+
+	/**
+	 * Execute 'ROUNDS' calls via 'fn' and print the achieved call rate
+	 */
+	template <typename FN>
+	void measure(char const *name, FN const &fn)
+	{
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < ROUNDS; i++)
+			fn(i);
+
+		unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+
+		log(name, ": ", (unsigned long)ROUNDS, " calls in ", duration_ms, " ms "
+		    "(", (ROUNDS*1000UL)/duration_ms, " calls/s)");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- IPC benchmark started ---");
+
+		measure("null RPC", [&] (unsigned) { client.null(); });
+
+		measure("RPC with arguments", [&] (unsigned i) {
+			if (client.add(i, 1) != i + 1UL)
+				error("unexpected result of 'add' RPC"); });
+
+		measure("RPC with capability", [&] (unsigned) {
+			client.cap(cap); });
+
+		server_ep.dissolve(component);
+
+		log("--- IPC benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
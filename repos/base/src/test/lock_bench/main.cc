@@ -0,0 +1,190 @@
+/*
+ * \brief  Benchmark for contended locks
+ * \author Genode Labs
+ * \date   2016-08-28
+ *
+ * A number of threads repeatedly acquire a shared lock and execute a
+ * critical section of configurable length. For each combination of thread
+ * count and critical-section size, the benchmark reports the number of
+ * lock acquisitions per second and the distribution of the time needed to
+ * acquire the lock.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/thread.h>
+#include <base/lock.h>
+#include <base/log.h>
+#include <util/misc_math.h>
+#include <util/volatile_object.h>
+#include <trace/timestamp.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Histogram;
+	struct Locker;
+	struct Main;
+
+	enum { MAX_THREADS = 8 };
+}
+
+
+/**
+ * Distribution of lock-acquisition latencies in power-of-two buckets
+ */
+struct Test::Histogram
+{
+	enum { NUM_BUCKETS = 64 };
+
+	unsigned long buckets[NUM_BUCKETS];
+
+	Histogram() { reset(); }
+
+	void reset()
+	{
+		for (unsigned i = 0; i < NUM_BUCKETS; i++)
+			buckets[i] = 0;
+	}
+
+	void record(Trace::Timestamp cycles)
+	{
+		buckets[cycles ? log2(cycles) : 0]++;
+	}
+
+	void add(Histogram const &other)
+	{
+		for (unsigned i = 0; i < NUM_BUCKETS; i++)
+			buckets[i] += other.buckets[i];
+	}
+
+	/**
+	 * Return upper bound of the bucket containing the given percentile
+	 *
+	 * \param permille  percentile in units of 0.1 percent
+	 */
+	unsigned long long percentile(unsigned permille) const
+	{
+		unsigned long total = 0;
+		for (unsigned i = 0; i < NUM_BUCKETS; i++)
+			total += buckets[i];
+
+		unsigned long const threshold = (total*permille + 999)/1000;
+
+		unsigned long sum = 0;
+		for (unsigned i = 0; i < NUM_BUCKETS; i++) {
+			sum += buckets[i];
+			if (sum >= threshold && sum)
+				return 2ULL << i;
+		}
+		return 0;
+	}
+};
+
+
+struct Test::Locker : Thread
+{
+	enum { STACK_SIZE = 4*1024*sizeof(long) };
+
+	Lock          &_lock;
+	unsigned const _rounds;
+	unsigned const _cs_size;
+
+	unsigned long volatile &_shared;
+
+	Histogram histogram;
+
+	void entry() override
+	{
+		for (unsigned i = 0; i < _rounds; i++) {
+
+			Trace::Timestamp const start = Trace::timestamp();
+
+			_lock.lock();
+
+			histogram.record(Trace::timestamp() - start);
+
+			/* critical section */
+			for (unsigned j = 0; j < _cs_size; j++)
+				_shared = _shared + 1;
+
+			_lock.unlock();
+		}
+	}
+
+	Locker(Env &env, Lock &lock, unsigned rounds, unsigned cs_size,
+	       unsigned long volatile &shared)
+	:
+		Thread(env, "locker", STACK_SIZE),
+		_lock(lock), _rounds(rounds), _cs_size(cs_size), _shared(shared)
+	{ }
+};
+
+
+struct Test::Main
+{
+	enum { ROUNDS = 20000 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Lock lock;
+
+	unsigned long volatile shared = 0;
+
+	void measure(unsigned num_threads, unsigned cs_size)
+	{
+		Lazy_volatile_object<Locker> lockers[MAX_THREADS];
+
+		for (unsigned i = 0; i < num_threads; i++)
+			lockers[i].construct(env, lock, (unsigned)ROUNDS, cs_size, shared);
+
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < num_threads; i++) lockers[i]->start();
+		for (unsigned i = 0; i < num_threads; i++) lockers[i]->join();
+
+		unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+		unsigned long const acquisitions = (unsigned long)num_threads*ROUNDS;
+
+		Histogram histogram;
+		for (unsigned i = 0; i < num_threads; i++)
+			histogram.add(lockers[i]->histogram);
+
+		log(num_threads, " threads, critical section ", cs_size, ": ",
+		    (acquisitions*1000)/duration_ms, " acquisitions/s, "
+		    "latency p50 <", histogram.percentile(500),
+		    " p99 <",        histogram.percentile(990),
+		    " p99.9 <",      histogram.percentile(999),
+		    " max <",        histogram.percentile(1000), " cycles");
+
+		for (unsigned i = 0; i < num_threads; i++)
+			lockers[i].destruct();
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- lock benchmark started ---");
+
+		unsigned const cs_sizes[] = { 0, 100, 1000 };
+
+		for (unsigned cs_size : cs_sizes)
+			for (unsigned n = 1; n <= MAX_THREADS; n *= 2)
+				measure(n, cs_size);
+
+		log("--- lock benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
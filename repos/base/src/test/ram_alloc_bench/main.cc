@@ -0,0 +1,89 @@
+/*
+ * \brief  Benchmark for measuring the latency of RAM-dataspace allocations
+ * \author Genode Labs
+ * \date   2016-08-23
+ *
+ * For a range of dataspace sizes, the benchmark repeatedly allocates a RAM
+ * dataspace and frees it. In a second pass, each allocated dataspace is also
+ * attached and each of its pages is touched before it gets detached and
+ * freed.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	/**
+	 * Return average duration of 'fn' in microseconds
+	 */
+	template <typename FN>
+	unsigned long _avg_us(unsigned const rounds, FN const &fn)
+	{
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < rounds; i++)
+			fn();
+
+		return ((timer.elapsed_ms() - start_ms)*1000)/rounds;
+	}
+
+	void measure(size_t const size, unsigned const rounds)
+	{
+		unsigned long const alloc_us = _avg_us(rounds, [&] () {
+			env.ram().free(env.ram().alloc(size)); });
+
+		unsigned long const cycle_us = _avg_us(rounds, [&] () {
+
+			Ram_dataspace_capability ds = env.ram().alloc(size);
+
+			char * const ptr = env.rm().attach(ds);
+			for (size_t offset = 0; offset < size; offset += 4096)
+				ptr[offset] = 1;
+
+			env.rm().detach(ptr);
+			env.ram().free(ds);
+		});
+
+		log("size ", size/1024, " KiB: ", rounds, " rounds, "
+		    "alloc+free ", alloc_us, " us, "
+		    "alloc+attach+touch+free ", cycle_us, " us");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- RAM allocation benchmark started ---");
+
+		measure(4*1024,         2000);
+		measure(64*1024,        2000);
+		measure(1024*1024,      500);
+		measure(4*1024*1024,    100);
+		measure(16*1024*1024,   50);
+
+		log("--- RAM allocation benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,187 @@
+/*
+ * \brief  Throughput benchmark for a pool of RPC entrypoints
+ * \author Genode Labs
+ * \date   2016-08-26
+ *
+ * Each client thread issues RPCs to a session object of its own. The
+ * session objects are served by an 'Rpc_entrypoint_pool' whose number of
+ * workers is doubled from one up to the configured number. Each RPC performs
+ * a small amount of computation on the server side. The benchmark reports
+ * the total number of calls per second for each pool size.
+ *
+ * The 'clients' and 'workers' config attributes default to the number of
+ * CPUs of the affinity space. Because some kernels, e.g., Linux, report a
+ * single CPU only, 'DEFAULT_COUNT' is used in this case.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/rpc_entrypoint_pool.h>
+#include <base/rpc_client.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/attached_rom_dataspace.h>
+#include <util/volatile_object.h>
+#include <timer_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Session;
+	struct Client;
+	struct Session_component;
+	struct Client_thread;
+	struct Main;
+
+	enum { MAX_CPUS = 16, DEFAULT_COUNT = 4 };
+}
+
+
+struct Test::Session : Genode::Session
+{
+	static const char *service_name() { return "RPC_POOL_BENCH"; }
+
+	GENODE_RPC(Rpc_compute, unsigned long, compute, unsigned long);
+	GENODE_RPC_INTERFACE(Rpc_compute);
+};
+
+
+struct Test::Client : Genode::Rpc_client<Session>
+{
+	Client(Capability<Session> cap) : Rpc_client<Session>(cap) { }
+
+	unsigned long compute(unsigned long value) {
+		return call<Rpc_compute>(value); }
+};
+
+
+struct Test::Session_component : Genode::Rpc_object<Session, Session_component>
+{
+	Rpc_entrypoint_pool &pool;
+	Rpc_entrypoint      &ep;
+
+	Capability<Session> const cap;
+
+	unsigned long compute(unsigned long value)
+	{
+		enum { WORK = 2000 };
+		for (unsigned i = 0; i < WORK; i++)
+			value = value*1103515245 + 12345;
+		return value;
+	}
+
+	Session_component(Rpc_entrypoint_pool &pool)
+	:
+		pool(pool), ep(pool.acquire_session()), cap(ep.manage(this))
+	{ }
+
+	~Session_component()
+	{
+		ep.dissolve(this);
+		pool.release_session(ep);
+	}
+};
+
+
+struct Test::Client_thread : Thread
+{
+	enum { STACK_SIZE = 4*1024*sizeof(long), ROUNDS = 20000 };
+
+	Client _client;
+
+	void entry() override
+	{
+		unsigned long value = 0;
+		for (unsigned i = 0; i < ROUNDS; i++)
+			value = _client.compute(value);
+	}
+
+	Client_thread(Env &env, Capability<Session> cap, Affinity::Location location)
+	:
+		Thread(env, "client", STACK_SIZE, location, Weight(), env.cpu()),
+		_client(cap)
+	{ }
+};
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Heap heap { env.ram(), env.rm() };
+
+	Attached_rom_dataspace config { env, "config" };
+
+	Affinity::Space space = env.cpu().affinity_space();
+
+	unsigned _count(char const *attr) const
+	{
+		unsigned const dflt = space.total() > 1 ? space.total()
+		                                        : (unsigned)DEFAULT_COUNT;
+
+		unsigned const count = config.xml().attribute_value(attr, dflt);
+		return max(1U, min(count, (unsigned)MAX_CPUS));
+	}
+
+	unsigned const num_clients = _count("clients");
+	unsigned const max_workers = _count("workers");
+
+	void measure(unsigned num_workers)
+	{
+		enum { STACK_SIZE = 4*1024*sizeof(long) };
+
+		Rpc_entrypoint_pool pool(env, heap, num_workers, STACK_SIZE, "worker");
+
+		Lazy_volatile_object<Session_component> sessions[MAX_CPUS];
+		Lazy_volatile_object<Client_thread>     clients[MAX_CPUS];
+
+		for (unsigned i = 0; i < num_clients; i++) {
+			sessions[i].construct(pool);
+			clients[i].construct(env, sessions[i]->cap, space.location_of_index(i));
+		}
+
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < num_clients; i++) clients[i]->start();
+		for (unsigned i = 0; i < num_clients; i++) clients[i]->join();
+
+		unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+		unsigned long const calls = (unsigned long)num_clients*Client_thread::ROUNDS;
+
+		log(pool.num_workers(), " workers, ", num_clients, " clients: ",
+		    calls, " calls in ", duration_ms, " ms "
+		    "(", (calls*1000)/duration_ms, " calls/s)");
+
+		for (unsigned i = 0; i < num_clients; i++) {
+			clients[i].destruct();
+			sessions[i].destruct();
+		}
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- RPC entrypoint pool benchmark started ---");
+		log("affinity space of ", space.total(), " CPUs, using ",
+		    num_clients, " clients and up to ", max_workers, " workers");
+
+		for (unsigned n = 1; n < max_workers; n *= 2)
+			measure(n);
+
+		measure(max_workers);
+
+		log("--- RPC entrypoint pool benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-rpc_pool_bench
+SRC_CC = main.cc
+LIBS   = base
@@ -3,6 +3,8 @@
  * \author Norman Feske
  * \date   2015-03-31
  *
+ * Besides checking the release of slab blocks, the test measures the
+ * duration of bulk allocations and of randomized alloc/free sequences.
  */
 
 /*
@@ -68,6 +70,57 @@ struct Array_of_slab_elements
 };
 
 
+static void print_stats(Genode::Slab const &slab)
+{
+	Genode::Slab::Stats const stats = slab.stats();
+
+	log(" slab stats: ", stats.blocks, " blocks, ",
+	    stats.used_entries, " used entries, ",
+	    stats.max_used_entries, " max used entries");
+}
+
+
+/**
+ * Measure randomized alloc/free sequence on a partially occupied slab
+ */
+static void measure_random_alloc_free(Genode::Slab &slab, Timer::Connection &timer)
+{
+	enum { NUM_SLOTS = 100000, ROUNDS = 2000000, SLAB_SIZE = 16 };
+
+	void **slot = (void **)Genode::env()->heap()->alloc(NUM_SLOTS*sizeof(void *));
+	for (size_t i = 0; i < NUM_SLOTS; i++)
+		slot[i] = nullptr;
+
+	unsigned seed = 1;
+	unsigned long const start_ms = timer.elapsed_ms();
+
+	for (size_t i = 0; i < ROUNDS; i++) {
+
+		seed = seed*1103515245 + 12345;
+		void *&elem = slot[(seed >> 8) % NUM_SLOTS];
+
+		if (elem) {
+			slab.free(elem, SLAB_SIZE);
+			elem = nullptr;
+		} else if (!slab.alloc(SLAB_SIZE, &elem)) {
+			error("slab allocation failed");
+		}
+	}
+
+	unsigned long const duration_ms = timer.elapsed_ms() - start_ms;
+
+	log(" random alloc/free: ", (unsigned)ROUNDS, " operations in ",
+	    duration_ms, " ms");
+	print_stats(slab);
+
+	for (size_t i = 0; i < NUM_SLOTS; i++)
+		if (slot[i])
+			slab.free(slot[i], SLAB_SIZE);
+
+	Genode::env()->heap()->free(slot, NUM_SLOTS*sizeof(void *));
+}
+
+
 int main(int argc, char **argv)
 {
 	log("--- slab test ---");
@@ -85,10 +138,16 @@ int main(int argc, char **argv)
 			    "used quota: ", alloc.consumed(), " "
 			    "time: ", timer.elapsed_ms(), " ms)");
 
+			unsigned long const start_ms = timer.elapsed_ms();
+
 			Array_of_slab_elements array(slab, i*100000, SLAB_SIZE);
-			log(" allocation completed (used quota: ", alloc.consumed(), ")");
+			log(" allocation completed (used quota: ", alloc.consumed(), ", "
+			    "duration: ", timer.elapsed_ms() - start_ms, " ms)");
+			print_stats(slab);
 		}
 
+		measure_random_alloc_free(slab, timer);
+
 		log(" finished (used quota: ", alloc.consumed(), ", "
 		    "time: ", timer.elapsed_ms(), " ms)");
 
@@ -31,11 +31,11 @@ int clock_gettime(clockid_t clk_id, struct timespec *tp)
 		read_rtc = true;
 	}
 
-	Genode::Alarm::Time time = Genode::Timeout_thread::alarm_timer()->time();
+	Genode::uint64_t const us = Genode::Timeout_thread::alarm_timer()->time_us();
 
 	if (tp) {
-		tp->tv_sec = rtc + time / 1000;
-		tp->tv_nsec = (time % 1000) * (1000 * 1000);
+		tp->tv_sec  = rtc + us / (1000*1000);
+		tp->tv_nsec = (us % (1000*1000)) * 1000;
 	}
 
 	return 0;
@@ -0,0 +1,83 @@
+/*
+ * \brief  Benchmark for loading and relocating shared objects
+ * \author Genode Labs
+ * \date   2016-08-30
+ *
+ * The libraries listed in the config are loaded one after another with
+ * immediate binding, which relocates all of their symbols at load time.
+ * Libraries are never unloaded so that each load accounts for the objects
+ * not loaded by a previous library only. If 'ld_verbose' is set, the
+ * dynamic linker reports the number of relocations and symbol lookups per
+ * object.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/shared_object.h>
+#include <base/attached_rom_dataspace.h>
+#include <trace/timestamp.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Library;
+	struct Main;
+}
+
+
+struct Test::Library : List<Library>::Element
+{
+	typedef String<64> Name;
+
+	Shared_object object;
+
+	Library(Name const &name) : object(name.string(), Shared_object::NOW) { }
+};
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	Attached_rom_dataspace config { env, "config" };
+
+	List<Library> libraries;
+
+	Main(Env &env) : env(env)
+	{
+		log("--- ldso benchmark started ---");
+
+		config.xml().for_each_sub_node("library", [&] (Xml_node node) {
+
+			Library::Name const name = node.attribute_value("name", Library::Name());
+
+			Trace::Timestamp const start = Trace::timestamp();
+
+			try {
+				libraries.insert(new (heap) Library(name));
+			} catch (Shared_object::Invalid_file) {
+				error("could not load ", name);
+				return;
+			}
+
+			log(name, ": loaded in ", Trace::timestamp() - start, " cycles");
+		});
+
+		log("--- ldso benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
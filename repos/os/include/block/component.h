@@ -74,9 +74,40 @@ class Block::Session_component : public Block::Session_component_base,
 		Signal_handler<Session_component> _sink_submit;
 		bool                              _req_queue_full;
 		bool                              _ack_queue_full;
+		bool                              _processing = false;
 		Packet_descriptor                 _p_to_handle;
 		unsigned                          _p_in_fly;
 
+		/*
+		 * Barrier and multi-range requests are processed exclusively, i.e.,
+		 * not before all previously submitted requests are acknowledged.
+		 * No further requests are taken from the submit queue until the
+		 * exclusive request is completed.
+		 */
+		Packet_descriptor _p_exclusive;
+		bool              _exclusive_pending = false;
+		bool              _exclusive_active  = false;
+
+		/*
+		 * State of the multi-range request in progress, the range table
+		 * is copied from the packet content to protect it against
+		 * modifications by the client
+		 */
+		Range    _ranges[Packet_descriptor::MAX_RANGES];
+		unsigned _range_num    = 0;
+		unsigned _range_idx    = 0;
+		off_t    _range_offset = 0;
+
+		/*
+		 * Ranges are issued by a loop rather than recursively from the
+		 * acknowledgement of the previous range. While the loop passes a
+		 * range to the driver, a synchronous acknowledgement merely
+		 * records the completion.
+		 */
+		bool _issuing_range = false;
+		bool _range_done    = false;
+		bool _range_success = false;
+
 		/**
 		 * Acknowledge a packet already handled
 		 */
@@ -85,6 +116,12 @@ class Block::Session_component : public Block::Session_component_base,
 			if (!tx_sink()->ready_to_ack())
 				error("not ready to ack!");
 
+			/* emulate 'FUA' for drivers without native support */
+			if (packet.succeeded() && packet.fua()
+			 && packet.operation() == Packet_descriptor::WRITE
+			 && !_driver.fua_supported())
+				_driver.sync();
+
 			tx_sink()->acknowledge_packet(packet);
 			_p_in_fly--;
 		}
@@ -96,6 +133,20 @@ class Block::Session_component : public Block::Session_component_base,
 			return p.block_number() + p.block_count() - 1
 			       < _driver.block_count(); }
 
+		/**
+		 * Complete a request processed by the driver
+		 */
+		void _complete(Packet_descriptor &packet, bool success)
+		{
+			packet.succeeded(success);
+
+			/* no other request is in flight while an exclusive one is */
+			if (_exclusive_active)
+				_exclusive_progress(success);
+			else
+				_ack_packet(packet);
+		}
+
 		/**
 		 * Handle a single request
 		 */
@@ -104,9 +155,11 @@ class Block::Session_component : public Block::Session_component_base,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
+			bool const payload = packet.operation() != Packet_descriptor::TRIM;
+
 			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
-				_ack_packet(_p_to_handle);
+			if ((payload && !packet.size()) || !_range_check(_p_to_handle)) {
+				_complete(_p_to_handle, false);
 				return;
 			}
 
@@ -139,31 +192,188 @@ class Block::Session_component : public Block::Session_component_base,
 						              _p_to_handle);
 					break;
 
+				case Block::Packet_descriptor::TRIM:
+					_driver.trim(packet.block_number(),
+					             packet.block_count(),
+					             _p_to_handle);
+					break;
+
 				default:
 					throw Driver::Io_error();
 				}
 			} catch (Driver::Request_congestion) {
 				_req_queue_full = true;
 			} catch (Driver::Io_error) {
-				_ack_packet(_p_to_handle);
+				_complete(_p_to_handle, false);
 			}
 		}
 
+		/**
+		 * Validate and copy the range table of a multi-range request
+		 */
+		bool _fetch_ranges(Packet_descriptor &p)
+		{
+			unsigned const num     = p.range_count();
+			char     const *content = tx_sink()->packet_content(p);
+
+			if (num > Packet_descriptor::MAX_RANGES || !content
+			 || p.size() < Packet_descriptor::RANGE_TABLE_SIZE)
+				return false;
+
+			memcpy(_ranges, content, num*sizeof(Range));
+
+			sector_t const blk_count = _driver.block_count();
+			uint64_t       blocks    = 0;
+			for (unsigned i = 0; i < num; i++) {
+				Range const &r = _ranges[i];
+				if (!r.block_count || r.block_number >= blk_count
+				 || r.block_count > blk_count - r.block_number)
+					return false;
+				blocks += r.block_count;
+			}
+
+			size_t const data_size = p.size() - Packet_descriptor::RANGE_TABLE_SIZE;
+			if (p.operation() != Packet_descriptor::TRIM
+			 && blocks > data_size / _driver.block_size())
+				return false;
+
+			_range_num    = num;
+			_range_idx    = 0;
+			_range_offset = p.offset() + Packet_descriptor::RANGE_TABLE_SIZE;
+			return true;
+		}
+
+		/**
+		 * Pass the current range of the multi-range request to the driver
+		 */
+		void _handle_range()
+		{
+			Range const &r = _ranges[_range_idx];
+
+			Packet_descriptor::Opcode const op = _p_exclusive.operation();
+
+			size_t const size = op == Packet_descriptor::TRIM
+			                  ? 0 : r.block_count*_driver.block_size();
+
+			Packet_descriptor range(Packet_descriptor(_range_offset, size),
+			                        op, r.block_number, r.block_count,
+			                        _p_exclusive.flags() & ~Packet_descriptor::BARRIER);
+			_range_offset += size;
+
+			_handle_packet(range);
+		}
+
+		/**
+		 * Issue ranges until the driver defers the completion of one
+		 */
+		void _issue_ranges()
+		{
+			for (;;) {
+				_range_done    = false;
+				_issuing_range = true;
+				_handle_range();
+				_issuing_range = false;
+
+				/* '_exclusive_progress' continues once the range completes */
+				if (!_range_done)
+					return;
+
+				if (!_range_success || ++_range_idx == _range_num) {
+					_finish_exclusive(_range_success);
+					return;
+				}
+			}
+		}
+
+		void _finish_exclusive(bool success)
+		{
+			_exclusive_active = false;
+			_p_exclusive.succeeded(success);
+			_ack_packet(_p_exclusive);
+		}
+
+		void _start_exclusive()
+		{
+			_exclusive_pending = false;
+			_exclusive_active  = true;
+
+			/* earlier writes must reach the medium before the barrier */
+			if (_p_exclusive.barrier())
+				_driver.sync();
+
+			if (!_p_exclusive.multi_range()) {
+				_handle_packet(_p_exclusive);
+				return;
+			}
+
+			if (_fetch_ranges(_p_exclusive))
+				_issue_ranges();
+			else
+				_finish_exclusive(false);
+		}
+
+		void _exclusive_progress(bool success)
+		{
+			if (_issuing_range) {
+				_range_done    = true;
+				_range_success = success;
+				return;
+			}
+
+			if (success && _p_exclusive.multi_range()
+			 && ++_range_idx < _range_num) {
+				_issue_ranges();
+				return;
+			}
+
+			_finish_exclusive(success);
+		}
+
+		/**
+		 * Handle request taken from the submit queue
+		 */
+		void _handle_request(Packet_descriptor packet)
+		{
+			if (!packet.barrier() && !packet.multi_range()) {
+				_handle_packet(packet);
+				return;
+			}
+
+			_p_exclusive       = packet;
+			_exclusive_pending = true;
+
+			if (_p_in_fly == 1)
+				_start_exclusive();
+		}
+
 		/**
 		 * Called whenever a signal from the packet-stream interface triggered
 		 */
 		void _signal()
 		{
+			/* drivers may acknowledge requests while we are processing */
+			if (_processing)
+				return;
+
+			_processing = true;
+
 			/*
 			 * as long as more packets are available, and we're able to ack
 			 * them, and the driver's request queue isn't full,
 			 * direct the packet request to the driver backend
 			 */
-			for (_ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free());
-			     !_req_queue_full && !_ack_queue_full
-			     && tx_sink()->packet_avail();
-				 _ack_queue_full = (++_p_in_fly >= tx_sink()->ack_slots_free()))
-				_handle_packet(tx_sink()->get_packet());
+			while (!_req_queue_full && !_exclusive_pending
+			       && !_exclusive_active && tx_sink()->packet_avail()) {
+
+				_ack_queue_full = (_p_in_fly >= tx_sink()->ack_slots_free());
+				if (_ack_queue_full)
+					break;
+
+				_p_in_fly++;
+				_handle_request(tx_sink()->get_packet());
+			}
+
+			_processing = false;
 		}
 
 	public:
@@ -184,6 +394,7 @@ class Block::Session_component : public Block::Session_component_base,
 		  _sink_ack(ep, *this, &Session_component::_signal),
 		  _sink_submit(ep, *this, &Session_component::_signal),
 		  _req_queue_full(false),
+		  _ack_queue_full(false),
 		  _p_in_fly(0)
 		{
 			_tx.sigh_ready_to_ack(_sink_ack);
@@ -204,11 +415,7 @@ class Block::Session_component : public Block::Session_component_base,
 		 */
 		void ack_packet(Packet_descriptor &packet, bool success)
 		{
-			packet.succeeded(success);
-			_ack_packet(packet);
-
-			if (!_req_queue_full && !_ack_queue_full)
-				return;
+			_complete(packet, success);
 
 			/*
 			 * when the driver's request queue was full,
@@ -219,6 +426,10 @@ class Block::Session_component : public Block::Session_component_base,
 				_handle_packet(_p_to_handle);
 			}
 
+			/* start exclusive request once all others are completed */
+			if (_exclusive_pending && _p_in_fly == 1)
+				_start_exclusive();
+
 			/* resume packet processing */
 			_signal();
 		}
@@ -234,6 +445,9 @@ class Block::Session_component : public Block::Session_component_base,
 			*blk_count = _driver.block_count();
 			*blk_size  = _driver.block_size();
 			*ops       = _driver.ops();
+
+			/* multi-range requests are split into single-range requests */
+			ops->set_multi_range();
 		}
 
 		void sync() { _driver.sync(); }
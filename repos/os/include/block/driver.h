@@ -7,7 +7,7 @@
  */
 
 /*
- * Copyright (C) 2011-2013 Genode Labs GmbH
+ * Copyright (C) 2011-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -167,6 +167,31 @@ class Block::Driver
 		                       Packet_descriptor &packet) {
 			throw Io_error(); }
 
+		/**
+		 * Discard content of blocks
+		 *
+		 * \param block_number  number of first block to discard
+		 * \param block_count   number of blocks to discard
+		 * \param packet        packet descriptor from the client
+		 *
+		 * \throw Request_congestion
+		 *
+		 * Note: should be overridden by devices that announce the
+		 *       'TRIM' operation
+		 */
+		virtual void trim(sector_t           block_number,
+		                  Genode::size_t     block_count,
+		                  Packet_descriptor &packet) {
+			throw Io_error(); }
+
+		/**
+		 * Check if driver honors the 'FUA' flag of write requests
+		 *
+		 * Otherwise, the session component calls 'sync' before
+		 * acknowledging a write request with the flag set.
+		 */
+		virtual bool fua_supported() { return false; }
+
 		/**
 		 * Check if DMA is enabled for driver
 		 *
@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2010-2013 Genode Labs GmbH
+ * Copyright (C) 2010-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -25,30 +25,67 @@ namespace Block {
 	 */
 	typedef Genode::uint64_t sector_t;
 
+	struct Range;
 	class Packet_descriptor;
 	struct Session;
 }
 
 
+/**
+ * Contiguous range of blocks within a multi-range request
+ */
+struct Block::Range
+{
+	sector_t         block_number;
+	Genode::uint64_t block_count;
+};
+
+
 /**
  * Represents an block-operation request
  *
  * The data associated with the 'Packet_descriptor' is either
  * the data read from or written to the block indicated by
  * its number.
+ *
+ * A multi-range request refers to several block ranges at once. Its
+ * payload starts with a table of 'Range' entries of 'RANGE_TABLE_SIZE'
+ * bytes, followed by the data of all ranges in the order of the table.
+ * The block number and count of such a descriptor denote the first block
+ * and the total number of blocks of the request.
+ *
+ * A 'TRIM' request informs the device that the content of the blocks is
+ * no longer needed. It carries no data. Subsequent reads of trimmed blocks
+ * return undefined content.
  */
 class Block::Packet_descriptor : public Genode::Packet_descriptor
 {
 	public:
 
-		enum Opcode    { READ, WRITE, END };
+		enum Opcode    { READ, WRITE, TRIM, END };
 		enum Alignment { PACKET_ALIGNMENT = 11 };
 
+		enum Flag {
+
+			/* complete write not before the data reached stable storage */
+			FUA     = 1 << 0,
+
+			/* start not before all previously submitted requests completed */
+			BARRIER = 1 << 1,
+		};
+
+		enum {
+			RANGE_TABLE_SIZE = 1 << PACKET_ALIGNMENT,
+			MAX_RANGES       = RANGE_TABLE_SIZE / sizeof(Range),
+		};
+
 	private:
 
 		Opcode          _op;           /* requested operation */
 		sector_t        _block_number; /* requested block number */
 		Genode::size_t  _block_count;  /* number of blocks to transfer */
+		unsigned        _flags;        /* bitfield of 'Flag' values */
+		unsigned        _range_count;  /* ranges of multi-range request */
 		unsigned        _success :1;   /* indicates success of operation */
 
 	public:
@@ -59,25 +96,62 @@ class Block::Packet_descriptor : public Genode::Packet_descriptor
 		Packet_descriptor(Genode::off_t offset=0, Genode::size_t size = 0)
 		:
 			Genode::Packet_descriptor(offset, size),
-			_op(READ), _block_number(0), _block_count(0), _success(false)
+			_op(READ), _block_number(0), _block_count(0), _flags(0),
+			_range_count(0), _success(false)
 		{ }
 
 		/**
 		 * Constructor
 		 */
 		Packet_descriptor(Packet_descriptor p, Opcode op,
-		                  sector_t blk_nr, Genode::size_t blk_count = 1)
+		                  sector_t blk_nr, Genode::size_t blk_count = 1,
+		                  unsigned flags = 0)
 		:
 			Genode::Packet_descriptor(p.offset(), p.size()),
 			_op(op), _block_number(blk_nr),
-			_block_count(blk_count), _success(false)
+			_block_count(blk_count), _flags(flags), _range_count(0),
+			_success(false)
 		{ }
 
+		/**
+		 * Constructor of multi-range request
+		 *
+		 * \param content  packet content, receives the range table
+		 * \param ranges   block ranges of the request
+		 * \param num      number of ranges, at most 'MAX_RANGES'
+		 */
+		Packet_descriptor(Packet_descriptor p, Opcode op, void *content,
+		                  Range const *ranges, unsigned num,
+		                  unsigned flags = 0)
+		:
+			Genode::Packet_descriptor(p.offset(), p.size()),
+			_op(op), _block_number(num ? ranges[0].block_number : 0),
+			_block_count(0), _flags(flags), _range_count(num),
+			_success(false)
+		{
+			Range *table = (Range *)content;
+			for (unsigned i = 0; i < num; i++) {
+				table[i]      = ranges[i];
+				_block_count += ranges[i].block_count;
+			}
+		}
+
 		Opcode         operation()    const { return _op;           }
 		sector_t       block_number() const { return _block_number; }
 		Genode::size_t block_count()  const { return _block_count;  }
+		unsigned       flags()        const { return _flags;        }
+		bool           fua()          const { return _flags & FUA;     }
+		bool           barrier()      const { return _flags & BARRIER; }
+		unsigned       range_count()  const { return _range_count;  }
+		bool           multi_range()  const { return _range_count;  }
 		bool           succeeded()    const { return _success;      }
 
+		/**
+		 * Return offset of the data within the packet content
+		 */
+		Genode::size_t data_offset() const {
+			return _range_count ? RANGE_TABLE_SIZE : 0; }
+
 		void succeeded(bool b) { _success = b ? 1 : 0; }
 };
 
@@ -108,16 +182,24 @@ struct Block::Session : public Genode::Session
 		private:
 
 			unsigned _ops :Packet_descriptor::END; /* bitfield of ops */
+			unsigned _multi_range :1;
 
 		public:
 
-			Operations() : _ops(0) { }
+			Operations() : _ops(0), _multi_range(0) { }
 
 			bool supported(Packet_descriptor::Opcode op) {
 				return (_ops & (1 << op)); }
 
 			void set_operation(Packet_descriptor::Opcode op) {
 				_ops |= (1 << op); }
+
+			/**
+			 * Return true if multi-range requests are supported
+			 */
+			bool multi_range() { return _multi_range; }
+
+			void set_multi_range() { _multi_range = 1; }
 	};
 
 
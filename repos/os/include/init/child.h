@@ -26,6 +26,7 @@
 /* init includes */
 #include <init/child_config.h>
 #include <init/child_policy.h>
+#include <init/routing_table.h>
 
 namespace Init {
 
@@ -155,74 +156,65 @@ namespace Init {
 		Genode::warning("cannot skip label prefix while processing <if-arg>");
 		return label;
 	}
+}
 
 
-	/**
-	 * Return true if service XML node matches service request
-	 *
-	 * \param args          session arguments, inspected for the session label
-	 * \param child_name    name of the originator of the session request
-	 * \param service_name  name of the requested service
-	 */
-	inline bool service_node_matches(Genode::Xml_node service_node,
-	                                 char const *args,
-	                                 char const *child_name,
-	                                 char const *service_name)
-	{
-		bool const service_matches =
-			service_node.has_type("any-service") ||
-			(service_node.has_type("service") &&
-			 service_node.attribute("name").has_value(service_name));
+namespace Init { class Buffered_xml; }
 
-		if (!service_matches)
-			return false;
 
-		Genode::Session_label const session_label(skip_label_prefix(
-			child_name, Genode::label_from_args(args).string()));
+/**
+ * Private copy of an XML node
+ *
+ * Children keep a copy of their start node because the XML data of init's
+ * config becomes invalid when the config is reloaded.
+ */
+class Init::Buffered_xml
+{
+	private:
 
-		return !Genode::Xml_node_label_score(service_node, session_label).conflict();
-	}
+		char          *_base = nullptr;
+		Genode::size_t _size = 0;
 
+		void _copy(Genode::Xml_node node)
+		{
+			_size = node.size();
+			_base = (char *)Genode::env()->heap()->alloc(_size);
+			Genode::memcpy(_base, node.addr(), _size);
+		}
 
-	/**
-	 * Check if arguments satisfy the condition specified for the route
-	 */
-	inline bool service_node_args_condition_satisfied(Genode::Xml_node service_node,
-	                                                  const char *args,
-	                                                  char const *child_name)
-	{
-		try {
-			Genode::Xml_node if_arg = service_node.sub_node("if-arg");
-			enum { KEY_MAX_LEN = 64, VALUE_MAX_LEN = 64 };
-			char key[KEY_MAX_LEN];
-			char value[VALUE_MAX_LEN];
-			if_arg.attribute("key").value(key, sizeof(key));
-			if_arg.attribute("value").value(value, sizeof(value));
+		void _free() { Genode::env()->heap()->free(_base, _size); }
 
-			char arg_value[VALUE_MAX_LEN];
-			Genode::Arg_string::find_arg(args, key).string(arg_value, sizeof(arg_value), "");
+		/*
+		 * Noncopyable
+		 */
+		Buffered_xml(Buffered_xml const &);
+		Buffered_xml &operator = (Buffered_xml const &);
 
-			/*
-			 * Skip child-name prefix if the key is the process "label".
-			 *
-			 * Because 'filter_session_args' is called prior the call of
-			 * 'resolve_session_request' from the 'Child::session' method,
-			 * 'args' contains the filtered arguments, in particular the label
-			 * prefixed with the child's name. For the 'if-args' declaration,
-			 * however, we want to omit specifying this prefix because the
-			 * session route is specific to the named start node anyway. So
-			 * the prefix information is redundant.
-			 */
-			if (Genode::strcmp("label", key) == 0)
-				return Genode::strcmp(value, skip_label_prefix(child_name, arg_value)) == 0;
+	public:
 
-			return Genode::strcmp(value, arg_value) == 0;
-		} catch (...) { }
+		Buffered_xml(Genode::Xml_node node) { _copy(node); }
 
-		/* if no if-arg node exists, the condition is met */
-		return true;
-	}
-}
+		~Buffered_xml() { _free(); }
+
+		Genode::Xml_node xml() const { return Genode::Xml_node(_base, _size); }
+
+		/**
+		 * Replace buffer content by a copy of 'node'
+		 */
+		void update(Genode::Xml_node node) { _free(); _copy(node); }
+
+		/**
+		 * Return true if the byte ranges of both XML nodes differ
+		 */
+		static bool differ(char const *a, Genode::size_t a_len,
+		                   char const *b, Genode::size_t b_len)
+		{
+			return a_len != b_len || Genode::memcmp(a, b, a_len) != 0;
+		}
+
+		bool differs_from(Genode::Xml_node node) const {
+			return differ(_base, _size, node.addr(), node.size()); }
+};
 
 
 /**
@@ -364,9 +356,29 @@ class Init::Child : Genode::Child_policy
 
 		Genode::List_element<Child> _list_element;
 
-		Genode::Xml_node _start_node;
+		Buffered_xml _start_node;
+
+		Buffered_xml _default_route_node;
+
+		static Genode::Xml_node _route_node(Genode::Xml_node start_node,
+		                                    Genode::Xml_node default_route_node)
+		{
+			try { return start_node.sub_node("route"); }
+			catch (...) { return default_route_node; }
+		}
+
+		/**
+		 * Routing rules, compiled from the child's route or the default route
+		 */
+		Routing_table _routing_table;
+
+		/*
+		 * Set if the child must be restarted because its sessions to a
+		 * server got revoked
+		 */
+		bool _abandoned = false;
 
-		Genode::Xml_node _default_route_node;
+		bool _started = false;
 
 		Name_registry &_name_registry;
 
@@ -556,6 +568,8 @@ class Init::Child : Genode::Child_policy
 			_list_element(this),
 			_start_node(start_node),
 			_default_route_node(default_route_node),
+			_routing_table(*Genode::env()->heap(),
+			               _route_node(start_node, default_route_node)),
 			_name_registry(name_registry),
 			_name(start_node, name_registry),
 			_resources(start_node, _name.unique, prio_levels,
@@ -631,7 +645,92 @@ class Init::Child : Genode::Child_policy
 		/**
 		 * Start execution of child
 		 */
-		void start() { _entrypoint.activate(); }
+		void start()
+		{
+			if (_started) return;
+
+			_started = true;
+			_entrypoint.activate();
+		}
+
+		/**
+		 * Mark child as relying on sessions of a server that vanished
+		 */
+		void revoke_server(Genode::Server const *server)
+		{
+			if (_child.revoke_server(server))
+				_abandoned = true;
+		}
+
+		bool started() const { return _started; }
+
+		enum Reconfiguration { UNCHANGED, CONFIG_CHANGED, RESTART_REQUIRED };
+
+		/**
+		 * Determine how to apply an updated start node to the child
+		 *
+		 * Only a changed 'config' entry can be applied to the running child.
+		 * Any other change, including a change of the child's routing
+		 * rules, requires a restart.
+		 */
+		Reconfiguration reconfiguration(Genode::Xml_node start_node,
+		                                Genode::Xml_node default_route_node) const
+		{
+			using Genode::Xml_node;
+
+			if (_abandoned)
+				return RESTART_REQUIRED;
+
+			Xml_node const old_start = _start_node.xml();
+
+			/* the default route applies only if no explicit route exists */
+			if (!start_node.has_sub_node("route")
+			 && _default_route_node.differs_from(default_route_node))
+				return RESTART_REQUIRED;
+
+			bool const old_config = old_start.has_sub_node("config"),
+			           new_config = start_node.has_sub_node("config");
+
+			if (old_config != new_config)
+				return RESTART_REQUIRED;
+
+			if (!new_config)
+				return _start_node.differs_from(start_node) ? RESTART_REQUIRED
+				                                            : UNCHANGED;
+
+			/* compare start nodes except for their config entries */
+			Xml_node const old_cfg = old_start.sub_node("config"),
+			               new_cfg = start_node.sub_node("config");
+
+			char const * const old_end = old_start.addr()  + old_start.size();
+			char const * const new_end = start_node.addr() + start_node.size();
+			char const * const old_cfg_end = old_cfg.addr() + old_cfg.size();
+			char const * const new_cfg_end = new_cfg.addr() + new_cfg.size();
+
+			if (Buffered_xml::differ(old_start.addr(), old_cfg.addr() - old_start.addr(),
+			                         start_node.addr(), new_cfg.addr() - start_node.addr())
+			 || Buffered_xml::differ(old_cfg_end, old_end - old_cfg_end,
+			                         new_cfg_end, new_end - new_cfg_end))
+				return RESTART_REQUIRED;
+
+			return Buffered_xml::differ(old_cfg.addr(), old_cfg.size(),
+			                            new_cfg.addr(), new_cfg.size())
+			       ? CONFIG_CHANGED : UNCHANGED;
+		}
+
+		/**
+		 * Hand out the 'config' entry of the updated start node to the child
+		 */
+		void update_config(Genode::Xml_node start_node)
+		{
+			_start_node.update(start_node);
+
+			Genode::Ram_dataspace_capability const old =
+				_config.update(start_node);
+
+			bool const fetched = _config_policy.update(_config.dataspace());
+			_config.release(old, fetched);
+		}
 
 
 		/****************************
@@ -655,85 +754,85 @@ class Init::Child : Genode::Child_policy
 			if ((service = _binary_policy.resolve_session_request(service_name, args)))
 				return service;
 
-			try {
-				Genode::Xml_node route_node = _default_route_node;
-				try {
-					route_node = _start_node.sub_node("route"); }
-				catch (...) { }
-				Genode::Xml_node service_node = route_node.sub_node();
+			typedef Routing_table::Target Target;
 
-				for (; ; service_node = service_node.next()) {
+			Genode::Session_label const label(skip_label_prefix(
+				name(), Genode::label_from_args(args).string()));
 
-					bool service_wildcard = service_node.has_type("any-service");
+			Routing_table::Rules const rules = _routing_table.rules(service_name);
 
-					if (!service_node_matches(service_node, args, name(), service_name))
-						continue;
+			for (unsigned i = 0; i < rules.num; i++) {
 
-					if (!service_node_args_condition_satisfied(service_node, args, name()))
-						continue;
+				Routing_table::Rule const &rule = *rules.rule[i];
 
-					Genode::Xml_node target = service_node.sub_node();
-					for (; ; target = target.next()) {
+				bool const service_wildcard = rule.any_service();
 
-						if (target.has_type("parent")) {
-							service = _parent_services.find(service_name);
-							if (service)
-								return service;
+				if (!rule.label_matches(label))
+					continue;
 
-							if (!service_wildcard) {
-								warning(name(), ": service lookup for "
-								        "\"", service_name, "\" at parent failed");
-								return 0;
-							}
+				if (!rule.args_condition_satisfied(args, label))
+					continue;
+
+				/* a rule without any sub node ends the route */
+				if (rule.empty())
+					break;
+
+				for (Target const *target = rule.first_target(); target;
+				     target = target->next()) {
+
+					if (target->type == Target::PARENT) {
+						service = _parent_services.find(service_name);
+						if (service)
+							return service;
+
+						if (!service_wildcard) {
+							warning(name(), ": service lookup for "
+							        "\"", service_name, "\" at parent failed");
+							return 0;
 						}
+					}
+
+					if (target->type == Target::CHILD) {
+						char const *server_name = target->name.string();
 
-						if (target.has_type("child")) {
-							char server_name[Name::MAX_NAME_LEN];
-							server_name[0] = 0;
-							target.attribute("name").value(server_name, sizeof(server_name));
-
-							Genode::Server *server = _name_registry.lookup_server(server_name);
-							if (!server) {
-								warning(name(), ": invalid route to non-existing "
-								        "server \"", Genode::Cstring(server_name), "\"");
-								return 0;
-							}
-
-							service = _child_services.find(service_name, server);
-							if (service)
-								return service;
-
-							if (!service_wildcard) {
-								Genode::warning(name(), ": lookup to child "
-								                "service \"", service_name, "\" failed");
-								return 0;
-							}
+						Genode::Server *server = _name_registry.lookup_server(server_name);
+						if (!server) {
+							warning(name(), ": invalid route to non-existing "
+							        "server \"", Genode::Cstring(server_name), "\"");
+							return 0;
 						}
 
-						if (target.has_type("any-child")) {
-							if (_child_services.is_ambiguous(service_name)) {
-								error(name(), ": ambiguous routes to "
-								      "service \"", service_name, "\"");
-								return 0;
-							}
-							service = _child_services.find(service_name);
-							if (service)
-								return service;
-
-							if (!service_wildcard) {
-								warning(name(), ": lookup for service "
-								        "\"", service_name, "\" failed");
-								return 0;
-							}
+						service = _child_services.find(service_name, server);
+						if (service)
+							return service;
+
+						if (!service_wildcard) {
+							Genode::warning(name(), ": lookup to child "
+							                "service \"", service_name, "\" failed");
+							return 0;
 						}
+					}
 
-						if (target.last())
-							break;
+					if (target->type == Target::ANY_CHILD) {
+						if (_child_services.is_ambiguous(service_name)) {
+							error(name(), ": ambiguous routes to "
+							      "service \"", service_name, "\"");
+							return 0;
+						}
+						service = _child_services.find(service_name);
+						if (service)
+							return service;
+
+						if (!service_wildcard) {
+							warning(name(), ": lookup for service "
+							        "\"", service_name, "\" failed");
+							return 0;
+						}
 					}
 				}
-			} catch (...) {
-				warning(name(), ": no route to service \"", service_name, "\"");
 			}
+
+			warning(name(), ": no route to service \"", service_name, "\"");
 			return service;
 		}
 
@@ -822,7 +921,7 @@ class Init::Child : Genode::Child_policy
 		void exit(int exit_value) override
 		{
 			try {
-				if (_start_node.sub_node("exit").attribute_value("propagate", false)) {
+				if (_start_node.xml().sub_node("exit").attribute_value("propagate", false)) {
 					Genode::env()->parent()->exit(exit_value);
 					return;
 				}
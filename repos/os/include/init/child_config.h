@@ -33,6 +33,65 @@ class Init::Child_config
 		Genode::Ram_session_capability   _ram_session_cap;
 		Genode::Ram_dataspace_capability _config_ram_ds;
 
+		/*
+		 * Dataspace of a replaced configuration, which is kept while the
+		 * child may still have it attached
+		 */
+		Genode::Ram_dataspace_capability _prev_config_ram_ds;
+
+		/**
+		 * Copy the start node's 'config' entry into a fresh dataspace
+		 *
+		 * \return  invalid capability if the start node has no 'config'
+		 *          entry or if the dataspace could not be allocated
+		 */
+		Genode::Ram_dataspace_capability _copy_config(Genode::Xml_node start_node)
+		{
+			using namespace Genode;
+
+			Ram_session_client rsc(_ram_session_cap);
+			Ram_dataspace_capability ds;
+			try {
+				Xml_node config_node = start_node.sub_node("config");
+
+				const char *config = config_node.addr();
+				Genode::size_t config_size = config_node.size();
+
+				if (!config || !config_size) return ds;
+
+				/*
+				 * Allocate RAM dataspace that is big enough to
+				 * hold the configuration and the null termination.
+				 */
+				ds = rsc.alloc(config_size + 1);
+
+				/*
+				 * Make dataspace locally accessible, copy
+				 * configuration into the dataspace, and append
+				 * a string-terminating zero.
+				 */
+				void *addr = env()->rm_session()->attach(ds);
+
+				Genode::memcpy(addr, config, config_size);
+				static_cast<char *>(addr)[config_size] = 0;
+				env()->rm_session()->detach(addr);
+
+			} catch (Region_map::Attach_failed) {
+				rsc.free(ds);
+				return Ram_dataspace_capability();
+			} catch (Ram_session::Alloc_failed) {
+				return Ram_dataspace_capability();
+			} catch (Xml_node::Nonexistent_sub_node) { }
+
+			return ds;
+		}
+
+		void _free(Genode::Ram_dataspace_capability ds)
+		{
+			if (ds.valid())
+				Genode::Ram_session_client(_ram_session_cap).free(ds);
+		}
+
 	public:
 
 		/**
@@ -67,38 +126,7 @@ class Init::Child_config
 			 * If the start node contains a 'config' entry, we copy this
 			 * entry into a fresh dataspace to be provided to our child.
 			 */
-			Ram_session_client rsc(_ram_session_cap);
-			try {
-				Xml_node config_node = start_node.sub_node("config");
-
-				const char *config = config_node.addr();
-				Genode::size_t config_size = config_node.size();
-
-				if (!config || !config_size) return;
-
-				/*
-				 * Allocate RAM dataspace that is big enough to
-				 * hold the configuration and the null termination.
-				 */
-				_config_ram_ds = rsc.alloc(config_size + 1);
-
-				/*
-				 * Make dataspace locally accessible, copy
-				 * configuration into the dataspace, and append
-				 * a string-terminating zero.
-				 */
-				void *addr = env()->rm_session()->attach(_config_ram_ds);
-
-				Genode::memcpy(addr, config, config_size);
-				static_cast<char *>(addr)[config_size] = 0;
-				env()->rm_session()->detach(addr);
-
-			} catch (Region_map::Attach_failed) {
-				rsc.free(_config_ram_ds);
-				return;
-			} catch (Ram_session::Alloc_failed) {
-				return;
-			} catch (Xml_node::Nonexistent_sub_node) { }
+			_config_ram_ds = _copy_config(start_node);
 		}
 
 		/**
@@ -106,8 +134,6 @@ class Init::Child_config
 		 */
 		~Child_config()
 		{
-			using namespace Genode;
-
 			/*
 			 * The configuration data is either provided as a ROM session
 			 * (holding a complete configfile) or as a RAM dataspace
@@ -115,8 +141,44 @@ class Init::Child_config
 			 * latter case, the child's configuration resides in a
 			 * shadow copy kept in '_config_ram_ds'.
 			 */
-			if (_config_ram_ds.valid())
-				Ram_session_client(_ram_session_cap).free(_config_ram_ds);
+			_free(_prev_config_ram_ds);
+			_free(_config_ram_ds);
+		}
+
+		/**
+		 * Replace inline configuration by the 'config' entry of 'start_node'
+		 *
+		 * \return  dataspace of the replaced configuration, which must be
+		 *          passed to 'release' once the child got the new one
+		 */
+		Genode::Ram_dataspace_capability update(Genode::Xml_node start_node)
+		{
+			Genode::Ram_dataspace_capability const old = _config_ram_ds;
+
+			_config_ram_ds = _copy_config(start_node);
+			return old;
+		}
+
+		/**
+		 * Release dataspace of a replaced configuration
+		 *
+		 * \param fetched  true if the child obtained 'ds' via its ROM
+		 *                 session
+		 *
+		 * A child that obtained 'ds' has detached the configuration it
+		 * used before, so this older dataspace is freed and 'ds' is kept
+		 * instead. A dataspace never obtained by the child is freed right
+		 * away.
+		 */
+		void release(Genode::Ram_dataspace_capability ds, bool fetched)
+		{
+			if (!fetched) {
+				_free(ds);
+				return;
+			}
+
+			_free(_prev_config_ram_ds);
+			_prev_config_ram_ds = ds;
 		}
 
 		/**
@@ -18,6 +18,7 @@
 #include <base/service.h>
 #include <base/child.h>
 #include <base/rpc_server.h>
+#include <base/signal.h>
 #include <base/session_label.h>
 #include <util/arg_string.h>
 #include <rom_session/connection.h>
@@ -154,7 +155,12 @@ class Init::Child_policy_provide_rom_file
 
 		struct Local_rom_session_component : Genode::Rpc_object<Genode::Rom_session>
 		{
-			Genode::Dataspace_capability ds_cap;
+			Genode::Lock                      lock;
+			Genode::Dataspace_capability      ds_cap;
+			Genode::Signal_context_capability sigh_cap;
+
+			/* true once the client requested the current dataspace */
+			bool fetched = false;
 
 			/**
 			 * Constructor
@@ -167,10 +173,18 @@ class Init::Child_policy_provide_rom_file
 			 ** ROM session interface **
 			 ***************************/
 
-			Genode::Rom_dataspace_capability dataspace() {
-				return Genode::static_cap_cast<Genode::Rom_dataspace>(ds_cap); }
+			Genode::Rom_dataspace_capability dataspace()
+			{
+				Genode::Lock::Guard guard(lock);
+				fetched = true;
+				return Genode::static_cap_cast<Genode::Rom_dataspace>(ds_cap);
+			}
 
-			void sigh(Genode::Signal_context_capability) { }
+			void sigh(Genode::Signal_context_capability sigh)
+			{
+				Genode::Lock::Guard guard(lock);
+				sigh_cap = sigh;
+			}
 
 		} _local_rom_session;
 
@@ -228,6 +242,32 @@ class Init::Child_policy_provide_rom_file
 		 */
 		~Child_policy_provide_rom_file() { _ep->dissolve(&_local_rom_session); }
 
+		/**
+		 * Replace the dataspace handed out to the child
+		 *
+		 * The child is notified via the signal handler registered at the
+		 * ROM session, if any.
+		 *
+		 * \return  true if the child had obtained the replaced dataspace
+		 */
+		bool update(Genode::Dataspace_capability ds_cap)
+		{
+			Genode::Signal_context_capability sigh;
+			bool fetched;
+			{
+				Genode::Lock::Guard guard(_local_rom_session.lock);
+				_local_rom_session.ds_cap = ds_cap;
+				sigh    = _local_rom_session.sigh_cap;
+				fetched = _local_rom_session.fetched;
+				_local_rom_session.fetched = false;
+			}
+
+			if (sigh.valid())
+				Genode::Signal_transmitter(sigh).submit();
+
+			return fetched;
+		}
+
 		Genode::Service *resolve_session_request(const char *service_name,
 		                                         const char *args)
 		{
@@ -0,0 +1,359 @@
+/*
+ * \brief  Precompiled routing rules of a child of init
+ * \author Genode Labs
+ * \date   2016-08-30
+ *
+ * The routing rules of a child are parsed once at the construction of the
+ * child. The rules are indexed by service name such that the resolution of
+ * a session request considers only the rules that may apply to the
+ * requested service, in the order of their declaration.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__INIT__ROUTING_TABLE_H_
+#define _INCLUDE__INIT__ROUTING_TABLE_H_
+
+/* Genode includes */
+#include <base/service.h>
+#include <base/session_label.h>
+#include <util/arg_string.h>
+#include <util/avl_string.h>
+#include <util/fifo.h>
+#include <util/xml_node.h>
+
+namespace Init { class Routing_table; }
+
+
+class Init::Routing_table
+{
+	public:
+
+		typedef Genode::String<Genode::Service::MAX_NAME_LEN>     Service_name;
+		typedef Genode::String<64>                                Child_name;
+		typedef Genode::String<Genode::Session_label::capacity()> Label;
+
+		/**
+		 * Target of a route, in the order of declaration
+		 */
+		struct Target : Genode::Fifo<Target>::Element
+		{
+			enum Type { PARENT, CHILD, ANY_CHILD };
+
+			Type       const type;
+			Child_name const name;
+
+			Target(Type type, Child_name const &name) : type(type), name(name) { }
+		};
+
+		/**
+		 * Routing rule as declared by a '<service>' or '<any-service>' node
+		 */
+		class Rule : public Genode::Fifo<Rule>::Element
+		{
+			private:
+
+				typedef Genode::String<64> Arg;
+
+				Genode::Allocator &_alloc;
+
+				bool const _any_service;
+
+				Service_name const _service;
+
+				bool const _label_present;
+				bool const _prefix_present;
+				bool const _suffix_present;
+
+				Label const _label;
+				Label const _prefix;
+				Label const _suffix;
+
+				bool const _if_arg_present;
+
+				Arg const _if_arg_key;
+				Arg const _if_arg_value;
+
+				Genode::Fifo<Target> _targets;
+
+				bool const _empty;
+
+				/*
+				 * An '<if-arg>' node lacking one of its attributes imposes no
+				 * condition
+				 */
+				static bool _if_arg_complete(Genode::Xml_node node)
+				{
+					try {
+						Genode::Xml_node if_arg = node.sub_node("if-arg");
+						return if_arg.has_attribute("key")
+						    && if_arg.has_attribute("value");
+					}
+					catch (Genode::Xml_node::Nonexistent_sub_node) { return false; }
+				}
+
+				static Arg _if_arg_attr(Genode::Xml_node node, char const *attr)
+				{
+					try {
+						return node.sub_node("if-arg").attribute_value(attr, Arg()); }
+					catch (Genode::Xml_node::Nonexistent_sub_node) { return Arg(); }
+				}
+
+			public:
+
+				Rule(Genode::Allocator &alloc, Genode::Xml_node node)
+				:
+					_alloc(alloc),
+					_any_service(node.has_type("any-service")),
+					_service(node.attribute_value("name", Service_name())),
+					_label_present (node.has_attribute("label")),
+					_prefix_present(node.has_attribute("label_prefix")),
+					_suffix_present(node.has_attribute("label_suffix")),
+					_label (node.attribute_value("label",        Label())),
+					_prefix(node.attribute_value("label_prefix", Label())),
+					_suffix(node.attribute_value("label_suffix", Label())),
+					_if_arg_present(_if_arg_complete(node)),
+					_if_arg_key  (_if_arg_attr(node, "key")),
+					_if_arg_value(_if_arg_attr(node, "value")),
+					_empty(node.num_sub_nodes() == 0)
+				{
+					node.for_each_sub_node([&] (Genode::Xml_node target) {
+
+						Child_name const name =
+							target.attribute_value("name", Child_name());
+
+						if (target.has_type("parent"))
+							_targets.enqueue(new (_alloc) Target(Target::PARENT, name));
+
+						if (target.has_type("child"))
+							_targets.enqueue(new (_alloc) Target(Target::CHILD, name));
+
+						if (target.has_type("any-child"))
+							_targets.enqueue(new (_alloc) Target(Target::ANY_CHILD, name));
+					});
+				}
+
+				~Rule()
+				{
+					while (Target *t = _targets.dequeue())
+						destroy(_alloc, t);
+				}
+
+				bool any_service() const { return _any_service; }
+
+				Service_name const &service() const { return _service; }
+
+				/**
+				 * Return true if rule applies to the service
+				 */
+				bool matches(char const *service_name) const {
+					return _any_service || _service == service_name; }
+
+				/**
+				 * Return true if the session label does not conflict with
+				 * the label constraints of the rule
+				 *
+				 * The semantics correspond to 'Xml_node_label_score::conflict'.
+				 */
+				bool label_matches(Genode::Session_label const &label) const
+				{
+					using Genode::strcmp;
+
+					if (_label_present && !(_label == label))
+						return false;
+
+					if (_prefix_present) {
+						Genode::size_t const len = _prefix.length() - 1;
+						if (!len || strcmp(label.string(), _prefix.string(), len))
+							return false;
+					}
+
+					if (_suffix_present) {
+						if (label.length() < _suffix.length() || _suffix.length() <= 1)
+							return false;
+
+						Genode::size_t const offset = label.length() - _suffix.length();
+						if (strcmp(label.string() + offset, _suffix.string()))
+							return false;
+					}
+					return true;
+				}
+
+				/**
+				 * Return true if the session arguments satisfy the '<if-arg>'
+				 * condition of the rule
+				 *
+				 * \param label  session label with the child-name prefix
+				 *               stripped
+				 */
+				bool args_condition_satisfied(char const *args,
+				                              Genode::Session_label const &label) const
+				{
+					if (!_if_arg_present)
+						return true;
+
+					if (_if_arg_key == "label")
+						return _if_arg_value == label.string();
+
+					char arg_value[Arg::capacity()];
+					Genode::Arg_string::find_arg(args, _if_arg_key.string())
+						.string(arg_value, sizeof(arg_value), "");
+
+					return _if_arg_value == arg_value;
+				}
+
+				Target const *first_target() const { return _targets.head(); }
+
+				/**
+				 * Return true if the rule node has no sub nodes at all
+				 *
+				 * Such a rule ends the route lookup whereas a rule with
+				 * sub nodes but no targets, e.g., only an '<if-arg>',
+				 * passes the lookup on to the next rule.
+				 */
+				bool empty() const { return _empty; }
+		};
+
+		/**
+		 * Rules applicable to a service, in the order of declaration
+		 */
+		struct Rules
+		{
+			Rule const * const *rule;
+			unsigned            num;
+		};
+
+	private:
+
+		Genode::Allocator &_alloc;
+
+		Genode::Fifo<Rule> _rules;
+
+		/**
+		 * Key storage of an index entry
+		 *
+		 * The name is kept in a base class so that it is constructed
+		 * before the 'Avl_string_base' referring to it.
+		 */
+		struct Index_name
+		{
+			Service_name const name;
+
+			Index_name(Service_name const &name) : name(name) { }
+		};
+
+		/**
+		 * Rules that apply to a service name mentioned in the route
+		 */
+		struct Index_entry : Index_name, Genode::Avl_string_base
+		{
+			Rules rules { nullptr, 0 };
+
+			Index_entry(Service_name const &name)
+			: Index_name(name), Avl_string_base(Index_name::name.string()) { }
+		};
+
+		Genode::Avl_tree<Genode::Avl_string_base> _index;
+
+		/*
+		 * Rules that apply to services not mentioned in the route
+		 */
+		Rules _any_service_rules { nullptr, 0 };
+
+		Index_entry *_lookup(char const *service_name) const
+		{
+			Genode::Avl_string_base *node = _index.first();
+			return node ? static_cast<Index_entry *>(node->find_by_name(service_name))
+			            : nullptr;
+		}
+
+		/**
+		 * Collect rules applicable to the service
+		 *
+		 * \param service_name  service name, or 0 for any-service rules only
+		 */
+		Rules _collect(char const *service_name)
+		{
+			auto applies = [&] (Rule const &rule) {
+				return service_name ? rule.matches(service_name) : rule.any_service(); };
+
+			unsigned num = 0;
+			for (Rule const *r = _rules.head(); r; r = r->next())
+				if (applies(*r)) num++;
+
+			if (num == 0)
+				return Rules { nullptr, 0 };
+
+			Rule const **rule = (Rule const **)_alloc.alloc(num*sizeof(Rule *));
+
+			unsigned i = 0;
+			for (Rule const *r = _rules.head(); r; r = r->next())
+				if (applies(*r)) rule[i++] = r;
+
+			return Rules { rule, num };
+		}
+
+		void _free(Rules const &rules)
+		{
+			if (rules.rule)
+				_alloc.free((void *)rules.rule, rules.num*sizeof(Rule *));
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param route_node  '<route>' node of the child or '<default-route>'
+		 */
+		Routing_table(Genode::Allocator &alloc, Genode::Xml_node route_node)
+		:
+			_alloc(alloc)
+		{
+			route_node.for_each_sub_node([&] (Genode::Xml_node node) {
+				if (node.has_type("service") || node.has_type("any-service"))
+					_rules.enqueue(new (_alloc) Rule(_alloc, node)); });
+
+			for (Rule const *r = _rules.head(); r; r = r->next()) {
+
+				if (r->any_service() || _lookup(r->service().string()))
+					continue;
+
+				Index_entry *entry = new (_alloc) Index_entry(r->service());
+				entry->rules = _collect(entry->Avl_string_base::name());
+				_index.insert(entry);
+			}
+
+			_any_service_rules = _collect(nullptr);
+		}
+
+		~Routing_table()
+		{
+			while (Index_entry *entry = static_cast<Index_entry *>(_index.first())) {
+				_index.remove(entry);
+				_free(entry->rules);
+				destroy(_alloc, entry);
+			}
+
+			_free(_any_service_rules);
+
+			while (Rule *r = _rules.dequeue())
+				destroy(_alloc, r);
+		}
+
+		/**
+		 * Return rules that apply to the service
+		 */
+		Rules rules(char const *service_name) const
+		{
+			Index_entry const *entry = _lookup(service_name);
+			return entry ? entry->rules : _any_service_rules;
+		}
+};
+
+#endif /* _INCLUDE__INIT__ROUTING_TABLE_H_ */
@@ -2,10 +2,16 @@
  * \brief   Timed event scheduler interface
  * \date    2005-10-24
  * \author  Norman Feske
+ *
+ * The scheduled alarms are kept in a pairing heap ordered by their
+ * deadlines. Scheduling an alarm takes constant time whereas removing the
+ * next pending alarm or discarding an arbitrary alarm takes amortized
+ * logarithmic time. Deadlines are compared relative to the current time of
+ * the scheduler, which accounts for the wraparound of 'Alarm::Time'.
  */
 
 /*
- * Copyright (C) 2005-2013 Genode Labs GmbH
+ * Copyright (C) 2005-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -35,15 +41,25 @@ class Genode::Alarm
 		Lock             _dispatch_lock;  /* taken during handle method   */
 		Time             _deadline;       /* next deadline                */
 		Time             _period;         /* duration between alarms      */
+		unsigned long    _order;          /* order of scheduling          */
 		int              _active;         /* set to one when active       */
-		Alarm           *_next;           /* next alarm in alarm list     */
 		Alarm_scheduler *_scheduler;      /* currently assigned scheduler */
 
+		/*
+		 * Links within the pairing heap of the scheduler, '_prev' refers to
+		 * the parent if the alarm is the first child
+		 */
+		Alarm *_child;
+		Alarm *_sibling;
+		Alarm *_prev;
+
 		void _assign(Time period, Time deadline, Alarm_scheduler *scheduler) {
 			_period = period, _deadline = deadline, _scheduler = scheduler; }
 
+		void _unlink() { _child = _sibling = _prev = 0; }
+
 		void _reset() {
-			_assign(0, 0, 0), _active = 0, _next = 0; }
+			_assign(0, 0, 0), _order = 0, _active = 0, _unlink(); }
 
 	protected:
 
@@ -68,24 +84,57 @@ class Genode::Alarm_scheduler
 {
 	private:
 
-		Lock         _lock;   /* protect alarm list                     */
-		Alarm       *_head;   /* head of alarm list                     */
-		Alarm::Time  _now;    /* recent time (updated by handle method) */
+		Lock          _lock;   /* protect alarm heap                      */
+		Alarm        *_head;   /* root of alarm heap, next deadline       */
+		Alarm::Time   _now;    /* recent time (updated by handle method)  */
+		unsigned long _order;  /* counter of enqueue operations           */
+
+		/**
+		 * Return true if alarm 'a' is due before alarm 'b'
+		 *
+		 * Alarms with equal deadlines are due in the order of their
+		 * scheduling.
+		 */
+		bool _earlier(Alarm const &a, Alarm const &b) const
+		{
+			long const da = (long)(a._deadline - _now);
+			long const db = (long)(b._deadline - _now);
+
+			if (da != db)
+				return da < db;
+
+			return (long)(a._order - b._order) < 0;
+		}
+
+		/**
+		 * Meld two detached heaps
+		 *
+		 * \return  root of resulting heap
+		 */
+		Alarm *_meld(Alarm *a, Alarm *b);
+
+		/**
+		 * Meld list of sibling heaps into a single heap
+		 *
+		 * \param first  first element of sibling list
+		 * \return       root of resulting heap
+		 */
+		Alarm *_merge_pairs(Alarm *first);
 
 		/**
-		 * Enqueue alarm into alarm queue
+		 * Enqueue alarm into alarm heap
 		 *
 		 * This is a helper for 'schedule' and 'handle'.
 		 */
 		void _unsynchronized_enqueue(Alarm *alarm);
 
 		/**
-		 * Dequeue alarm from alarm queue
+		 * Dequeue alarm from alarm heap
 		 */
 		void _unsynchronized_dequeue(Alarm *alarm);
 
 		/**
-		 * Dequeue next pending alarm from alarm list
+		 * Dequeue next pending alarm from alarm heap
 		 *
 		 * \return  dequeued pending alarm
 		 * \retval  0  no alarm pending
@@ -99,7 +148,7 @@ class Genode::Alarm_scheduler
 
 	public:
 
-		Alarm_scheduler() : _head(0), _now(0) { }
+		Alarm_scheduler() : _head(0), _now(0), _order(0) { }
 		~Alarm_scheduler();
 
 		/**
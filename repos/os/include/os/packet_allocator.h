@@ -6,7 +6,7 @@
  */
 
 /*
- * Copyright (C) 2012-2013 Genode Labs GmbH
+ * Copyright (C) 2012-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -26,11 +26,37 @@ namespace Genode { class Packet_allocator; }
  * packet stream interface. It uses a minimal block size, which is the
  * granularity packets will be allocated with. As backend, it uses a
  * simple bit array to manage free, and allocated blocks.
+ *
+ * Packet streams typically allocate packets of a few distinct sizes only.
+ * Therefore, the allocator keeps freed packets of up to 'NUM_SIZE_CLASSES'
+ * distinct block counts in per-size free lists instead of returning them
+ * to the bit array. A subsequent allocation of the same block count is
+ * served from the free list in constant time. The bit array is searched
+ * only if the free list of the requested size is empty. If the search
+ * fails, the free lists are returned to the bit array and the search is
+ * repeated. A second bit array marks the first block of each packet kept
+ * in a free list, which allows for dropping the release of a packet that is
+ * not allocated or already released.
  */
 class Genode::Packet_allocator : public Genode::Range_allocator
 {
 	private:
 
+		enum { NUM_SIZE_CLASSES = 8 };
+
+		typedef Genode::uint32_t Index;
+
+		enum { INVALID = ~0U };
+
+		/**
+		 * Free list of packets with a specific block count
+		 */
+		struct Size_class
+		{
+			addr_t cnt  = 0;        /* block count, 0 if unused */
+			Index  head = INVALID;  /* first block of first packet */
+		};
+
 		Allocator      *_md_alloc;   /* meta-data allocator                 */
 		size_t          _block_size; /* granularity of packet allocations   */
 		void           *_bits;       /* memory chunk containing the bits    */
@@ -38,6 +64,96 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 		addr_t          _base;       /* allocation base                     */
 		addr_t          _next;       /* next free bit index                 */
 
+		/*
+		 * Free-list links, indexed by the first block of a packet
+		 */
+		Index          *_links = nullptr;
+		size_t          _blocks = 0;
+
+		/*
+		 * Bits marking the first block of each packet in a free list
+		 */
+		void           *_cached_bits = nullptr;
+		Bit_array_base *_cached      = nullptr;
+
+		Size_class      _classes[NUM_SIZE_CLASSES];
+
+		size_t _cnt(size_t size) const {
+			return (size % _block_size) ? size / _block_size + 1
+			                            : size / _block_size; }
+
+		/**
+		 * Return size class for block count, assign a free one if 'assign'
+		 */
+		Size_class *_size_class(addr_t cnt, bool assign)
+		{
+			if (cnt == 0)
+				return nullptr;
+
+			for (unsigned i = 0; i < NUM_SIZE_CLASSES; i++) {
+
+				if (_classes[i].cnt == cnt)
+					return &_classes[i];
+
+				if (_classes[i].cnt == 0) {
+					if (!assign)
+						return nullptr;
+
+					_classes[i].cnt = cnt;
+					return &_classes[i];
+				}
+			}
+			return nullptr;
+		}
+
+		/**
+		 * Return the packets of all free lists to the bit array
+		 *
+		 * \return  true if at least one packet was returned
+		 */
+		bool _flush_size_classes()
+		{
+			bool flushed = false;
+			for (unsigned i = 0; i < NUM_SIZE_CLASSES; i++) {
+				Size_class &c = _classes[i];
+				for (; c.head != INVALID; c.head = _links[c.head]) {
+					try { _cached->clear(c.head, 1); } catch (...) { }
+					try { _array->clear(c.head, c.cnt); } catch (...) { }
+					flushed = true;
+				}
+			}
+			return flushed;
+		}
+
+		/**
+		 * Search bit array for 'cnt' free blocks
+		 */
+		bool _alloc_from_array(addr_t cnt, addr_t &index)
+		{
+			addr_t max = ~0UL;
+
+			do {
+				try {
+					/* throws exception if array is accessed outside bounds */
+					for (addr_t i = _next & ~(cnt - 1); i < max; i += cnt) {
+						if (_array->get(i, cnt))
+							continue;
+
+						_array->set(i, cnt);
+						_next = i + cnt;
+						index = i;
+						return true;
+					}
+				} catch (typename Bit_array_base::Invalid_index_access) { }
+
+				max = _next;
+				_next = 0;
+
+			} while (max != 0);
+
+			return false;
+		}
+
 		/*
 		 * Returns the count of blocks fitting the given size
 		 *
@@ -60,7 +176,7 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 		 */
 		Packet_allocator(Allocator *md_alloc, size_t block_size)
 		: _md_alloc(md_alloc), _block_size(block_size), _bits(0),
-		  _array(nullptr), _base(0) {}
+		  _array(nullptr), _base(0), _next(0) {}
 
 
 		/*******************************
@@ -76,6 +192,13 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 			_array = new (_md_alloc) Bit_array_base(_block_cnt(size),
 			                                        (addr_t*)_bits,
 			                                        true);
+			_blocks = _block_cnt(size);
+			_links  = (Index *)_md_alloc->alloc(_blocks*sizeof(Index));
+
+			_cached_bits = _md_alloc->alloc(_blocks/8);
+			_cached      = new (_md_alloc) Bit_array_base(_blocks,
+			                                              (addr_t*)_cached_bits,
+			                                              true);
 			return 0;
 		}
 
@@ -85,6 +208,19 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 
 			if (_array) destroy(_md_alloc, _array);
 			if (_bits)  _md_alloc->free(_bits, _block_cnt(size)/8);
+			if (_links) _md_alloc->free(_links, _blocks*sizeof(Index));
+
+			if (_cached)      destroy(_md_alloc, _cached);
+			if (_cached_bits) _md_alloc->free(_cached_bits, _blocks/8);
+
+			_links       = nullptr;
+			_cached      = nullptr;
+			_cached_bits = nullptr;
+			_blocks      = 0;
+
+			for (unsigned i = 0; i < NUM_SIZE_CLASSES; i++)
+				_classes[i] = Size_class();
+
 			return 0;
 		}
 
@@ -97,38 +233,50 @@ class Genode::Packet_allocator : public Genode::Range_allocator
 
 		bool alloc(size_t size, void **out_addr) override
 		{
-			addr_t const cnt = (size % _block_size) ? size / _block_size + 1
-			                                        : size / _block_size;
-			addr_t max = ~0UL;
+			addr_t const cnt = _cnt(size);
+			addr_t       i   = 0;
 
-			do {
-				try {
-					/* throws exception if array is accessed outside bounds */
-					for (addr_t i = _next & ~(cnt - 1); i < max; i += cnt) {
-						if (_array->get(i, cnt))
-							continue;
+			if (!_array)
+				return false;
 
-						_array->set(i, cnt);
-						_next = i + cnt;
-						*out_addr = reinterpret_cast<void *>(i * _block_size
-						                                     + _base);
-						return true;
-					}
-				} catch (typename Bit_array_base::Invalid_index_access) { }
+			Size_class *c = _size_class(cnt, false);
 
-				max = _next;
-				_next = 0;
+			if (c && c->head != INVALID) {
+				i       = c->head;
+				c->head = _links[i];
+				_cached->clear(i, 1);
 
-			} while (max != 0);
+			} else if (!_alloc_from_array(cnt, i)) {
 
-			return false;
+				if (!_flush_size_classes() || !_alloc_from_array(cnt, i))
+					return false;
+			}
+
+			*out_addr = reinterpret_cast<void *>(i * _block_size + _base);
+			return true;
 		}
 
 		void free(void *addr, size_t size) override
 		{
 			addr_t i   = (((addr_t)addr) - _base) / _block_size;
-			size_t cnt = (size % _block_size) ? size / _block_size + 1
-			                                  : size / _block_size;
+			size_t cnt = _cnt(size);
+
+			if (!_array || i >= _blocks || cnt > _blocks - i) return;
+
+			/*
+			 * Drop the release of a packet that is not allocated or already
+			 * kept in a free list. Linking it twice would create a cycle.
+			 */
+			if (!_array->get(i, 1) || _cached->get(i, 1)) return;
+
+			/* keep the blocks allocated in the free list of the size */
+			if (Size_class *c = _size_class(cnt, true)) {
+				_links[i] = c->head;
+				c->head   = i;
+				_cached->set(i, 1);
+				return;
+			}
+
 			try { _array->clear(i, cnt); } catch(...) { }
 			_next = i;
 		}
@@ -61,12 +61,24 @@
  * acknowledge buffers using the methods 'packet_avail',
  * 'ready_to_submit', 'ready_to_ack', and 'ack_avail'.
  *
+ * Signals are suppressed unless the receiving side actually waits for
+ * them. Each queue contains two event indices. The consumer of a queue
+ * publishes the queue position it waits for whenever it observes the queue
+ * as empty, the producer does the same whenever it observes the queue as
+ * full. The other side submits a signal only if its update of the queue
+ * passes the published position. Consequently, a party that keeps up with
+ * the stream by repeatedly querying the queue state receives no signals.
+ *
+ * Packets can be submitted, obtained, and acknowledged in batches via
+ * 'submit_packets', 'get_packets', 'acknowledge_packets', and
+ * 'get_acked_packets'. A batch results in at most one signal.
+ *
  * If bidirectional data exchange between two processes is desired, two pairs
  * of 'Packet_stream_source' and 'Packet_stream_sink' should be instantiated.
  */
 
 /*
- * Copyright (C) 2009-2013 Genode Labs GmbH
+ * Copyright (C) 2009-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -81,6 +93,8 @@
 #include <dataspace/client.h>
 #include <util/string.h>
 #include <util/construct_at.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
 
 namespace Genode {
 
@@ -156,10 +170,42 @@ class Genode::Packet_descriptor_queue
 {
 	private:
 
-		unsigned          _head;
-		unsigned          _tail;
+		enum { NO_EVENT = ~0U };
+
+		unsigned volatile _head;
+		unsigned volatile _tail;
+
+		/*
+		 * Event indices, '_avail_event' is written by the consumer,
+		 * '_space_event' is written by the producer
+		 */
+		unsigned volatile _avail_event;
+		unsigned volatile _space_event;
+
 		PACKET_DESCRIPTOR _queue[QUEUE_SIZE];
 
+		/**
+		 * Return number of queue positions from 'from' to 'to'
+		 */
+		static unsigned _distance(unsigned from, unsigned to) {
+			return (to + QUEUE_SIZE - from)%QUEUE_SIZE; }
+
+		/**
+		 * Store value with the semantics of a full memory barrier
+		 *
+		 * A store followed by a load of the index written by the other
+		 * side must not be reordered. Otherwise, both sides may miss the
+		 * update of the other side and wait forever.
+		 */
+		static void _publish(unsigned volatile &dst, unsigned value)
+		{
+			for (;;) {
+				int const old = (int)dst;
+				if (Genode::cmpxchg((int volatile *)&dst, old, (int)value))
+					return;
+			}
+		}
+
 	public:
 
 		typedef PACKET_DESCRIPTOR Packet_descriptor;
@@ -177,37 +223,77 @@ class Genode::Packet_descriptor_queue
 		Packet_descriptor_queue(Role role)
 		{
 			if (role == PRODUCER) {
-				_head = 0;
+				_head        = 0;
+				_space_event = NO_EVENT;
 				Genode::memset(_queue, 0, sizeof(_queue));
-			} else
-				_tail = 0;
+			} else {
+				_tail        = 0;
+				_avail_event = 0; /* wait for the first packet */
+			}
 		}
 
 		/**
-		 * Place packet descriptor into queue
+		 * Place packet descriptors into queue, called by the producer
 		 *
-		 * \return true on success, or
-		 *         false if queue is full
+		 * \param notify  set to true if the consumer must be signalled
+		 * \return        number of packet descriptors placed into the
+		 *                queue, which is less than 'num' if the queue
+		 *                becomes full
 		 */
-		bool add(PACKET_DESCRIPTOR packet)
+		unsigned add(PACKET_DESCRIPTOR const *packets, unsigned num, bool &notify)
 		{
-			if (full()) return false;
+			unsigned const head = _head;
+			unsigned const n    = num < slots_free() ? num : slots_free();
+
+			notify = false;
+			if (n == 0)
+				return 0;
 
-			_queue[_head%QUEUE_SIZE] = packet;
-			_head = (_head + 1)%QUEUE_SIZE;
-			return true;
+			for (unsigned i = 0; i < n; i++)
+				_queue[(head + i)%QUEUE_SIZE] = packets[i];
+
+			/* the queue is not full anymore from the producer's view */
+			if (_space_event != NO_EVENT)
+				_space_event = NO_EVENT;
+
+			_publish(_head, (head + n)%QUEUE_SIZE);
+
+			unsigned const event = _avail_event;
+			notify = (event != NO_EVENT) && _distance(head, event) < n;
+			return n;
 		}
 
 		/**
-		 * Take packet descriptor from queue
+		 * Take packet descriptors from queue, called by the consumer
 		 *
-		 * \return  packet descriptor
+		 * \param notify  set to true if the producer must be signalled
+		 * \return        number of packet descriptors taken from the queue
 		 */
-		PACKET_DESCRIPTOR get()
+		unsigned get(PACKET_DESCRIPTOR *packets, unsigned max, bool &notify)
 		{
-			PACKET_DESCRIPTOR packet = _queue[_tail%QUEUE_SIZE];
-			_tail = (_tail + 1)%QUEUE_SIZE;
-			return packet;
+			unsigned const tail  = _tail;
+			unsigned const avail = _distance(tail, _head);
+			unsigned const n     = max < avail ? max : avail;
+
+			notify = false;
+			if (n == 0)
+				return 0;
+
+			/* read the descriptors not before observing the head */
+			Genode::memory_barrier();
+
+			for (unsigned i = 0; i < n; i++)
+				packets[i] = _queue[(tail + i)%QUEUE_SIZE];
+
+			/* the queue is not empty anymore from the consumer's view */
+			if (_avail_event != NO_EVENT)
+				_avail_event = NO_EVENT;
+
+			_publish(_tail, (tail + n)%QUEUE_SIZE);
+
+			unsigned const event = _space_event;
+			notify = (event != NO_EVENT) && _distance(tail, event) < n;
+			return n;
 		}
 
 		/**
@@ -229,22 +315,44 @@ class Genode::Packet_descriptor_queue
 		bool full() { return (_head + 1)%QUEUE_SIZE == _tail; }
 
 		/**
-		 * Return true if a single element is stored in the queue
+		 * Return true if the queue is empty, called by the consumer
+		 *
+		 * If the queue is empty, the consumer wants to be signalled by the
+		 * producer when the next packet descriptor is placed into the queue.
 		 */
-		bool single_element() { return (_tail + 1)%QUEUE_SIZE == _head; }
+		bool empty_wait_for_avail()
+		{
+			if (!empty())
+				return false;
 
+			_publish(_avail_event, _tail);
+
+			/* the producer may have added a descriptor meanwhile */
+			return empty();
+		}
 
 		/**
-		 * Return true if a single slot is left to be put into the queue
+		 * Return true if the queue is full, called by the producer
+		 *
+		 * If the queue is full, the producer wants to be signalled by the
+		 * consumer when the next packet descriptor is taken from the queue.
 		 */
-		bool single_slot_free() { return (_head + 2)%QUEUE_SIZE == _tail; }
+		bool full_wait_for_space()
+		{
+			if (!full())
+				return false;
+
+			_publish(_space_event, _tail);
+
+			/* the consumer may have taken a descriptor meanwhile */
+			return full();
+		}
 
 		/**
 		 * Return number of slots left to be put into the queue
 		 */
 		unsigned slots_free() {
-			return ((_tail > _head) ? _tail - _head
-			                        : QUEUE_SIZE - _head + _tail) - 1; }
+			return QUEUE_SIZE - 1 - _distance(_tail, _head); }
 };
 
 
@@ -306,34 +414,62 @@ class Genode::Packet_descriptor_transmitter
 		bool ready_for_tx()
 		{
 			Genode::Lock::Guard lock_guard(_tx_queue_lock);
-			return !_tx_queue->full();
+			return !_tx_queue->full_wait_for_space();
 		}
 
-		void tx(typename TX_QUEUE::Packet_descriptor packet)
+		/**
+		 * Transmit packet descriptors
+		 *
+		 * The method blocks as long as the tx queue is full.
+		 */
+		void tx(typename TX_QUEUE::Packet_descriptor const *packets, unsigned num)
 		{
 			Genode::Lock::Guard lock_guard(_tx_queue_lock);
 
-			do {
-				/* block for signal if tx queue is full */
-				if (_tx_queue->full())
-					_tx_ready.wait_for_signal();
+			for (;;) {
 
-				/*
-				 * It could happen that pending signals do not refer to the
-				 * current queue situation. Therefore, we need to double check
-				 * if the queue insertion succeeds and retry if needed.
-				 */
+				bool notify = false;
+				unsigned const n = _tx_queue->add(packets, num, notify);
 
-			} while (_tx_queue->add(packet) == false);
+				if (notify)
+					_rx_ready.submit();
 
-			if (_tx_queue->single_element())
-				_rx_ready.submit();
+				packets += n;
+				num     -= n;
+
+				if (num == 0)
+					return;
+
+				/*
+				 * Block for signal if tx queue is full. It could happen that
+				 * pending signals do not refer to the current queue
+				 * situation. Therefore, we retry the queue insertion.
+				 */
+				if (_tx_queue->full_wait_for_space())
+					_tx_ready.wait_for_signal();
+			}
 		}
 
+		void tx(typename TX_QUEUE::Packet_descriptor packet) { tx(&packet, 1); }
+
 		/**
 		 * Return number of slots left to be put into the tx queue
+		 *
+		 * The queue indices are read without taking the tx-queue lock
+		 * because each of them has a single writer. Only if the queue
+		 * appears full, the lock is taken to request a signal for the
+		 * next free slot. In this case, the call blocks while another
+		 * thread waits in 'tx' for a free slot.
 		 */
-		unsigned tx_slots_free() { return _tx_queue->slots_free(); }
+		unsigned tx_slots_free()
+		{
+			unsigned const free = _tx_queue->slots_free();
+			if (free)
+				return free;
+
+			Genode::Lock::Guard lock_guard(_tx_queue_lock);
+			return _tx_queue->full_wait_for_space() ? 0 : _tx_queue->slots_free();
+		}
 };
 
 
@@ -395,22 +531,36 @@ class Genode::Packet_descriptor_receiver
 		bool ready_for_rx()
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
-			return !_rx_queue->empty();
+			return !_rx_queue->empty_wait_for_avail();
 		}
 
-		void rx(typename RX_QUEUE::Packet_descriptor *out_packet)
+		/**
+		 * Receive packet descriptors
+		 *
+		 * The method blocks until at least one packet descriptor is
+		 * available.
+		 *
+		 * \return  number of received packet descriptors
+		 */
+		unsigned rx(typename RX_QUEUE::Packet_descriptor *out_packets, unsigned max)
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
 
-			while (_rx_queue->empty())
+			while (_rx_queue->empty_wait_for_avail())
 				_rx_ready.wait_for_signal();
 
-			*out_packet = _rx_queue->get();
+			bool notify = false;
+			unsigned const n = _rx_queue->get(out_packets, max, notify);
 
-			if (_rx_queue->single_slot_free())
+			if (notify)
 				_tx_ready.submit();
+
+			return n;
 		}
 
+		void rx(typename RX_QUEUE::Packet_descriptor *out_packet) {
+			rx(out_packet, 1); }
+
 		typename RX_QUEUE::Packet_descriptor rx_peek() const
 		{
 			Genode::Lock::Guard lock_guard(_rx_queue_lock);
@@ -685,6 +835,16 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			_submit_transmitter.tx(packet);
 		}
 
+		/**
+		 * Tell sink about a batch of packets to process
+		 *
+		 * This method blocks as long as the submit queue is full.
+		 */
+		void submit_packets(Packet_descriptor const *packets, unsigned num)
+		{
+			_submit_transmitter.tx(packets, num);
+		}
+
 		/**
 		 * Returns true if one or more packet acknowledgements are available
 		 */
@@ -700,6 +860,19 @@ class Genode::Packet_stream_source : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get batch of acknowledged packets
+		 *
+		 * This method blocks until at least one acknowledgement is
+		 * available.
+		 *
+		 * \return  number of packets stored in 'packets'
+		 */
+		unsigned get_acked_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _ack_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Release bulk-buffer space consumed by the packet
 		 */
@@ -817,6 +990,18 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			return packet;
 		}
 
+		/**
+		 * Get batch of packets from source
+		 *
+		 * This method blocks until at least one packet is available.
+		 *
+		 * \return  number of packets stored in 'packets'
+		 */
+		unsigned get_packets(Packet_descriptor *packets, unsigned max)
+		{
+			return _submit_receiver.rx(packets, max);
+		}
+
 		/**
 		 * Return but do not dequeue next packet
 		 *
@@ -861,6 +1046,17 @@ class Genode::Packet_stream_sink : private Packet_stream_base
 			_ack_transmitter.tx(packet);
 		}
 
+		/**
+		 * Tell the source that the processing of a batch of packets is
+		 * completed
+		 *
+		 * This method blocks as long as the acknowledgement queue is full.
+		 */
+		void acknowledge_packets(Packet_descriptor const *packets, unsigned num)
+		{
+			_ack_transmitter.tx(packets, num);
+		}
+
 		void debug_print_buffers() {
 			Packet_stream_base::_debug_print_buffers(); }
 
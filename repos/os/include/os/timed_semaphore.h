@@ -62,7 +62,12 @@ class Genode::Timeout_thread : public Thread_deprecated<2048*sizeof(long)>,
 			start();
 		}
 
-		Genode::Alarm::Time time(void) { return _timer.elapsed_ms(); }
+		Genode::Alarm::Time time(void) { return _timer.now_us()/1000; }
+
+		/**
+		 * Return elapsed microseconds, obtained without RPC if possible
+		 */
+		Genode::uint64_t time_us() { return _timer.now_us(); }
 
 		/*
 		 * Returns the singleton timeout-thread used for all timeouts.
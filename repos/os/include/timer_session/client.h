@@ -34,6 +34,14 @@ struct Timer::Session_client : Genode::Rpc_client<Session>
 	void sigh(Signal_context_capability sigh) override { call<Rpc_sigh>(sigh); }
 
 	unsigned long elapsed_ms() const override { return call<Rpc_elapsed_ms>(); }
+
+	Genode::Dataspace_capability clock_page() override { return call<Rpc_clock_page>(); }
+
+	Genode::Dataspace_capability
+	timeout_table(Signal_context_capability sigh) override {
+		return call<Rpc_timeout_table>(sigh); }
+
+	void apply_timeouts() override { call<Rpc_apply_timeouts>(); }
 };
 
 #endif /* _INCLUDE__TIMER_SESSION__CLIENT_H_ */
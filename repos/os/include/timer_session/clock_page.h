@@ -0,0 +1,134 @@
+/*
+ * \brief  Clock page shared between timer driver and timer client
+ * \author Genode Labs
+ * \date   2016-08-31
+ *
+ * The clock page enables a timer client to determine the time elapsed since
+ * the creation of its timer session without performing an RPC. The timer
+ * driver publishes a pair of a CPU time-stamp-counter value and the
+ * corresponding session time along with the rate of the counter. The client
+ * extrapolates the current time from the counter value.
+ *
+ * The page is written by the driver only and updated via a sequence counter.
+ * A reader retries if the sequence counter is odd or changed while reading.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__TIMER_SESSION__CLOCK_PAGE_H_
+#define _INCLUDE__TIMER_SESSION__CLOCK_PAGE_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+#include <cpu/memory_barrier.h>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <trace/timestamp.h>
+#endif
+
+namespace Timer { struct Clock_page; }
+
+
+struct Timer::Clock_page
+{
+	typedef Genode::uint64_t uint64_t;
+
+	/*
+	 * Fractional bits of 'mul'
+	 */
+	enum { SHIFT = 32 };
+
+	Genode::uint32_t volatile seq;     /* odd while the page is updated   */
+	Genode::uint32_t          _pad;
+	uint64_t         volatile mul;     /* microseconds per counter tick   */
+	uint64_t         volatile base_ts; /* counter value at 'base_us'      */
+	uint64_t         volatile base_us; /* session time at 'base_ts'       */
+
+	/**
+	 * Return true if the counter is consistent across CPUs and accessible
+	 * by unprivileged components
+	 *
+	 * We assume this to be the case for the time-stamp counter of x86 CPUs
+	 * only. On other platforms, the clock page is never calibrated.
+	 */
+	static bool counter_available()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	static uint64_t counter()
+	{
+#if defined(__i386__) || defined(__x86_64__)
+		return Genode::Trace::timestamp();
+#else
+		return 0;
+#endif
+	}
+
+	/**
+	 * Extrapolate time at counter value 'ts' from the given calibration
+	 */
+	static uint64_t extrapolate(uint64_t ts, uint64_t base_ts,
+	                            uint64_t base_us, uint64_t mul)
+	{
+		/* counter values of different CPUs may slightly lag behind */
+		uint64_t const delta = ts > base_ts ? ts - base_ts : 0;
+
+		return base_us + ((delta * mul) >> SHIFT);
+	}
+
+	/**
+	 * Publish new calibration, called by the timer driver only
+	 */
+	void update(uint64_t new_base_ts, uint64_t new_base_us, uint64_t new_mul)
+	{
+		seq = seq + 1;
+		Genode::memory_barrier();
+
+		base_ts = new_base_ts;
+		base_us = new_base_us;
+		mul     = new_mul;
+
+		Genode::memory_barrier();
+		seq = seq + 1;
+	}
+
+	/**
+	 * Read current session time in microseconds
+	 *
+	 * \return  false if the page is not calibrated
+	 */
+	bool read_us(uint64_t &us) const
+	{
+		if (!counter_available())
+			return false;
+
+		for (;;) {
+			Genode::uint32_t const s = seq;
+			Genode::memory_barrier();
+
+			uint64_t const ts = base_ts, time = base_us, m = mul;
+
+			Genode::memory_barrier();
+			if ((s & 1) || s != seq)
+				continue;
+
+			if (m == 0)
+				return false;
+
+			us = extrapolate(counter(), ts, time, m);
+			return true;
+		}
+	}
+};
+
+#endif /* _INCLUDE__TIMER_SESSION__CLOCK_PAGE_H_ */
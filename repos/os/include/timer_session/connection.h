@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2008-2013 Genode Labs GmbH
+ * Copyright (C) 2008-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -15,7 +15,9 @@
 #define _INCLUDE__TIMER_SESSION__CONNECTION_H_
 
 #include <timer_session/client.h>
+#include <timer_session/clock_page.h>
 #include <base/connection.h>
+#include <region_map/region_map.h>
 
 namespace Timer { class Connection; }
 
@@ -33,6 +35,36 @@ class Timer::Connection : public Genode::Connection<Session>, public Session_cli
 
 		Genode::Signal_context_capability _custom_sigh_cap;
 
+		Genode::Region_map &_rm;
+
+		/*
+		 * Clock page, attached on the first call of 'now_us'
+		 */
+		Genode::Lock               _clock_lock;
+		Clock_page const * volatile _clock = nullptr;
+		bool                        _clock_requested = false;
+
+		Clock_page const *_clock_page()
+		{
+			if (_clock || !Clock_page::counter_available())
+				return _clock;
+
+			Genode::Lock::Guard guard(_clock_lock);
+
+			if (_clock_requested)
+				return _clock;
+
+			_clock_requested = true;
+
+			try {
+				Genode::Dataspace_capability ds = clock_page();
+				if (ds.valid())
+					_clock = _rm.attach(ds);
+			} catch (...) { }
+
+			return _clock;
+		}
+
 	public:
 
 		/**
@@ -40,8 +72,8 @@ class Timer::Connection : public Genode::Connection<Session>, public Session_cli
 		 */
 		Connection(Genode::Env &env)
 		:
-			Genode::Connection<Session>(env, session(env.parent(), "ram_quota=8K")),
-			Session_client(cap())
+			Genode::Connection<Session>(env, session(env.parent(), "ram_quota=32K")),
+			Session_client(cap()), _rm(env.rm())
 		{
 			/* register default signal handler */
 			Session_client::sigh(_default_sigh_cap);
@@ -56,14 +88,20 @@ class Timer::Connection : public Genode::Connection<Session>, public Session_cli
 		 */
 		Connection()
 		:
-			Genode::Connection<Session>(session("ram_quota=8K")),
-			Session_client(cap())
+			Genode::Connection<Session>(session("ram_quota=32K")),
+			Session_client(cap()), _rm(*Genode::env()->rm_session())
 		{
 			/* register default signal handler */
 			Session_client::sigh(_default_sigh_cap);
 		}
 
-		~Connection() { _sig_rec.dissolve(&_default_sigh_ctx); }
+		~Connection()
+		{
+			if (_clock)
+				_rm.detach((void *)_clock);
+
+			_sig_rec.dissolve(&_default_sigh_ctx);
+		}
 
 		/*
 		 * Intercept 'sigh' to keep track of customized signal handlers
@@ -107,6 +145,40 @@ class Timer::Connection : public Genode::Connection<Session>, public Session_cli
 		{
 			usleep(1000*ms);
 		}
+
+		/**
+		 * Return number of elapsed microseconds since session creation
+		 *
+		 * The time is computed locally from the clock page of the session.
+		 * If the clock page is not available or not yet calibrated by the
+		 * timer driver, the method falls back to 'elapsed_ms'.
+		 */
+		Genode::uint64_t now_us()
+		{
+			Genode::uint64_t us = 0;
+
+			Clock_page const *clock = _clock_page();
+			if (clock && clock->read_us(us))
+				return us;
+
+			return (Genode::uint64_t)elapsed_ms()*1000;
+		}
+
+		/**
+		 * Return true if 'now_us' has microsecond resolution
+		 *
+		 * This is the case once the clock page of the session is
+		 * calibrated by the timer driver, which takes about one second
+		 * after the first call of 'now_us'. Otherwise, 'now_us' has the
+		 * resolution of 'elapsed_ms'.
+		 */
+		bool clock_calibrated()
+		{
+			Genode::uint64_t us = 0;
+
+			Clock_page const *clock = _clock_page();
+			return clock && clock->read_us(us);
+		}
 };
 
 #endif /* _INCLUDE__TIMER_SESSION__CONNECTION_H_ */
@@ -0,0 +1,137 @@
+/*
+ * \brief  Client-side access to the timeout table of a timer session
+ * \author Genode Labs
+ * \date   2016-09-02
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__TIMER_SESSION__MULTI_TIMEOUT_H_
+#define _INCLUDE__TIMER_SESSION__MULTI_TIMEOUT_H_
+
+/* Genode includes */
+#include <timer_session/timer_session.h>
+#include <timer_session/timeout_table.h>
+#include <region_map/region_map.h>
+
+namespace Timer { class Multi_timeout; }
+
+
+/**
+ * Set of independent timeouts within one timer session
+ *
+ * Timeouts are identified by ids in the range of
+ * [0, 'Timeout_table::MAX_TIMEOUTS'). Programming or discarding a timeout
+ * takes effect with the next call of 'apply', which passes all changes to
+ * the timer driver at once. The signal handler is notified whenever
+ * timeouts trigger. The triggered timeouts are obtained via 'for_each_fired'.
+ */
+class Timer::Multi_timeout
+{
+	public:
+
+		class Unavailable : public Genode::Exception { };
+		class Invalid_id  : public Genode::Exception { };
+
+	private:
+
+		Genode::Region_map &_rm;
+		Session            &_session;
+
+		Timeout_table &_table;
+
+		bool _modified = false;
+
+		static Timeout_table &_attach(Genode::Region_map &rm, Session &session,
+		                              Genode::Signal_context_capability sigh)
+		{
+			Genode::Dataspace_capability ds = session.timeout_table(sigh);
+			if (!ds.valid())
+				throw Unavailable();
+
+			Timeout_table *table = rm.attach(ds);
+			return *table;
+		}
+
+		void _program(unsigned id, Timeout_table::Entry::Type type,
+		              Genode::uint32_t us)
+		{
+			if (!Timeout_table::valid(id))
+				throw Invalid_id();
+
+			_table.program(id, type, us);
+			_modified = true;
+		}
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \throw Unavailable  timer driver could not provide the table
+		 */
+		Multi_timeout(Genode::Region_map &rm, Session &session,
+		              Genode::Signal_context_capability sigh)
+		:
+			_rm(rm), _session(session), _table(_attach(rm, session, sigh))
+		{ }
+
+		~Multi_timeout()
+		{
+			for (unsigned id = 0; id < Timeout_table::MAX_TIMEOUTS; id++)
+				_table.program(id, Timeout_table::Entry::DISCARDED, 0);
+
+			_session.apply_timeouts();
+			_rm.detach(&_table);
+		}
+
+		/**
+		 * Program single timeout (relative to the next call of 'apply')
+		 *
+		 * \throw Invalid_id
+		 */
+		void trigger_once(unsigned id, unsigned us) {
+			_program(id, Timeout_table::Entry::ONE_SHOT, us); }
+
+		/**
+		 * Program periodic timeout
+		 *
+		 * \throw Invalid_id
+		 */
+		void trigger_periodic(unsigned id, unsigned us) {
+			_program(id, Timeout_table::Entry::PERIODIC, us); }
+
+		/**
+		 * Cancel timeout
+		 *
+		 * \throw Invalid_id
+		 */
+		void discard(unsigned id) {
+			_program(id, Timeout_table::Entry::DISCARDED, 0); }
+
+		/**
+		 * Pass the changes since the last call to the timer driver
+		 */
+		void apply()
+		{
+			if (!_modified)
+				return;
+
+			_modified = false;
+			_session.apply_timeouts();
+		}
+
+		/**
+		 * Call 'fn' with the id of each timeout triggered since the last call
+		 */
+		template <typename FN>
+		void for_each_fired(FN const &fn) {
+			Timeout_table::for_each(_table.fired, fn); }
+};
+
+#endif /* _INCLUDE__TIMER_SESSION__MULTI_TIMEOUT_H_ */
@@ -0,0 +1,116 @@
+/*
+ * \brief  Table of timeouts shared between timer driver and timer client
+ * \author Genode Labs
+ * \date   2016-09-02
+ *
+ * The timeout table enables a timer client to maintain many independent
+ * timeouts within a single timer session. The client programs a timeout by
+ * writing the entry of the timeout id and marking the id as pending. Once
+ * the client has updated all entries of a batch, it requests the timer
+ * driver to apply the pending entries. The driver marks each triggered
+ * timeout in the fired bitmap and submits one signal for all timeouts
+ * triggered at the same time.
+ *
+ * Both bitmaps are modified by the client and the driver concurrently and
+ * are therefore accessed with atomic operations only.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__TIMER_SESSION__TIMEOUT_TABLE_H_
+#define _INCLUDE__TIMER_SESSION__TIMEOUT_TABLE_H_
+
+/* Genode includes */
+#include <base/stdint.h>
+#include <cpu/atomic.h>
+#include <cpu/memory_barrier.h>
+
+namespace Timer { struct Timeout_table; }
+
+
+struct Timer::Timeout_table
+{
+	enum {
+		MAX_TIMEOUTS = 128,
+		WORD_BITS    = 8*sizeof(int),
+		WORDS        = MAX_TIMEOUTS/WORD_BITS,
+	};
+
+	struct Entry
+	{
+		enum Type { DISCARDED = 0, ONE_SHOT = 1, PERIODIC = 2 };
+
+		Genode::uint32_t volatile type;
+
+		/*
+		 * Timeout relative to the time the entry is applied, or period
+		 * of a periodic timeout, in microseconds
+		 */
+		Genode::uint32_t volatile us;
+	};
+
+	int volatile pending[WORDS];  /* entries modified by the client */
+	int volatile fired[WORDS];    /* timeouts triggered by the driver */
+
+	Entry entries[MAX_TIMEOUTS];
+
+	static bool valid(unsigned id) { return id < MAX_TIMEOUTS; }
+
+	/**
+	 * Atomically set bit of timeout 'id' in bitmap
+	 */
+	static void set(int volatile *bitmap, unsigned id)
+	{
+		int volatile &word = bitmap[id / WORD_BITS];
+		int const     mask = (int)(1U << (id % WORD_BITS));
+
+		for (;;) {
+			int const old = word;
+			if ((old & mask) || Genode::cmpxchg(&word, old, old | mask))
+				return;
+		}
+	}
+
+	/**
+	 * Atomically fetch and clear word 'i' of bitmap
+	 */
+	static unsigned fetch(int volatile *bitmap, unsigned i)
+	{
+		for (;;) {
+			int const old = bitmap[i];
+			if (old == 0 || Genode::cmpxchg(&bitmap[i], old, 0))
+				return (unsigned)old;
+		}
+	}
+
+	/**
+	 * Call 'fn' with the id of each bit set in the bitmap and clear the bits
+	 */
+	template <typename FN>
+	static void for_each(int volatile *bitmap, FN const &fn)
+	{
+		for (unsigned i = 0; i < WORDS; i++)
+			for (unsigned bits = fetch(bitmap, i); bits; bits &= bits - 1)
+				fn(i*WORD_BITS + __builtin_ctz(bits));
+	}
+
+	/**
+	 * Program timeout, called by the client
+	 */
+	void program(unsigned id, Entry::Type type, Genode::uint32_t us)
+	{
+		entries[id].type = type;
+		entries[id].us   = us;
+
+		/* make the entry visible before marking it as pending */
+		Genode::memory_barrier();
+		set(pending, id);
+	}
+};
+
+#endif /* _INCLUDE__TIMER_SESSION__TIMEOUT_TABLE_H_ */
@@ -17,6 +17,7 @@
 #define _INCLUDE__TIMER_SESSION__TIMER_SESSION_H_
 
 #include <base/signal.h>
+#include <dataspace/capability.h>
 #include <session/session.h>
 
 namespace Timer { struct Session; }
@@ -53,6 +54,36 @@ struct Timer::Session : Genode::Session
 	 */
 	virtual unsigned long elapsed_ms() const = 0;
 
+	/**
+	 * Return dataspace containing the 'Timer::Clock_page' of the session
+	 *
+	 * The clock page enables the client to determine the time elapsed since
+	 * session creation without performing an RPC. The client must not
+	 * modify the content of the dataspace.
+	 */
+	virtual Genode::Dataspace_capability clock_page() = 0;
+
+	/**
+	 * Return dataspace containing the 'Timer::Timeout_table' of the session
+	 *
+	 * \param sigh  signal handler notified about triggered timeouts of
+	 *              the table
+	 *
+	 * The timeouts of the table are independent from the timeout programmed
+	 * via 'trigger_once' and 'trigger_periodic'.
+	 */
+	virtual Genode::Dataspace_capability
+	timeout_table(Genode::Signal_context_capability sigh) = 0;
+
+	/**
+	 * Apply the entries of the timeout table marked as pending
+	 *
+	 * The timeouts of all pending entries are relative to the time of this
+	 * call. Periodic timeouts behave like the one programmed via
+	 * 'trigger_periodic'.
+	 */
+	virtual void apply_timeouts() = 0;
+
 	/**
 	 * Client-side convenience method for sleeping the specified number
 	 * of milliseconds
@@ -74,9 +105,14 @@ struct Timer::Session : Genode::Session
 	GENODE_RPC(Rpc_trigger_periodic, void, trigger_periodic, unsigned);
 	GENODE_RPC(Rpc_sigh, void, sigh, Genode::Signal_context_capability);
 	GENODE_RPC(Rpc_elapsed_ms, unsigned long, elapsed_ms);
+	GENODE_RPC(Rpc_clock_page, Genode::Dataspace_capability, clock_page);
+	GENODE_RPC(Rpc_timeout_table, Genode::Dataspace_capability, timeout_table,
+	           Genode::Signal_context_capability);
+	GENODE_RPC(Rpc_apply_timeouts, void, apply_timeouts);
 
 	GENODE_RPC_INTERFACE(Rpc_trigger_once, Rpc_trigger_periodic,
-	                     Rpc_sigh, Rpc_elapsed_ms);
+	                     Rpc_sigh, Rpc_elapsed_ms, Rpc_clock_page,
+	                     Rpc_timeout_table, Rpc_apply_timeouts);
 };
 
 #endif /* _INCLUDE__TIMER_SESSION__TIMER_SESSION_H_ */
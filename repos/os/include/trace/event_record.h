@@ -0,0 +1,93 @@
+/*
+ * \brief  Binary trace-event records
+ * \author Genode Labs
+ * \date   2016-08-31
+ *
+ * Records of this format are written by the 'event_record' trace policy and
+ * interpreted by trace-buffer consumers such as the 'trace_rpc_latency'
+ * component. Because each trace buffer belongs to a single thread, a record
+ * carries no thread ID. The consumer knows the thread from the trace
+ * subject the buffer belongs to.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _INCLUDE__TRACE__EVENT_RECORD_H_
+#define _INCLUDE__TRACE__EVENT_RECORD_H_
+
+#include <util/string.h>
+#include <trace/timestamp.h>
+
+namespace Genode { namespace Trace { struct Event_record; } }
+
+
+struct Genode::Trace::Event_record
+{
+	enum Type {
+		RPC_CALL = 1, RPC_RETURNED, RPC_DISPATCH, RPC_REPLY,
+		SIGNAL_SUBMIT, SIGNAL_RECEIVE,
+		LOCK_WAIT, LOCK_ACQUIRED, SEMAPHORE_BLOCK, SEMAPHORE_WOKEN,
+		REGION_MAP_FAULT
+	};
+
+	enum { MAGIC = 0x7265 };
+
+	uint16_t  magic;
+	uint16_t  type;
+	uint32_t  value;     /* type-specific, e.g., number of signals */
+	Timestamp timestamp; /* cycle counter at the time of the event */
+	uint64_t  object;    /* address of lock or semaphore, fault address */
+	uint64_t  arg;       /* type-specific, e.g., lock holder */
+	char      name[0];   /* not null-terminated */
+
+	/**
+	 * Write record to trace-buffer entry
+	 *
+	 * \param dst      destination buffer as handed to the policy
+	 * \param max_len  size of the destination buffer
+	 * \param name     event name, truncated if it does not fit
+	 *
+	 * \return  length of the record in bytes
+	 */
+	static size_t write(char *dst, size_t max_len, Type type,
+	                    char const *name, uint32_t value,
+	                    uint64_t object = 0, uint64_t arg = 0)
+	{
+		Event_record &r = *(Event_record *)dst;
+
+		r.magic     = MAGIC;
+		r.type      = type;
+		r.value     = value;
+		r.timestamp = Trace::timestamp();
+		r.object    = object;
+		r.arg       = arg;
+
+		size_t const name_len = min(strlen(name), max_len - sizeof(Event_record));
+		memcpy(r.name, name, name_len);
+
+		return sizeof(Event_record) + name_len;
+	}
+
+	/**
+	 * Return record contained in trace-buffer entry, or nullptr
+	 */
+	static Event_record const *from_entry(char const *data, size_t len)
+	{
+		Event_record const *r = (Event_record const *)data;
+
+		if (len < sizeof(Event_record) || r->magic != MAGIC)
+			return nullptr;
+
+		return r;
+	}
+
+	size_t name_len(size_t entry_len) const {
+		return entry_len - sizeof(Event_record); }
+};
+
+#endif /* _INCLUDE__TRACE__EVENT_RECORD_H_ */
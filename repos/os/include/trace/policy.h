@@ -28,3 +28,8 @@ extern "C" size_t rpc_dispatch   (char *dst, char const *rpc_name);
 extern "C" size_t rpc_reply      (char *dst, char const *rpc_name);
 extern "C" size_t signal_submit  (char *dst, unsigned const);
 extern "C" size_t signal_receive (char *dst, Genode::Signal_context const &, unsigned);
+extern "C" size_t lock_wait      (char *dst, void const *lock, void const *holder);
+extern "C" size_t lock_acquired  (char *dst, void const *lock);
+extern "C" size_t semaphore_block(char *dst, void const *semaphore);
+extern "C" size_t semaphore_woken(char *dst, void const *semaphore);
+extern "C" size_t region_map_fault(char *dst, Genode::addr_t addr, bool write);
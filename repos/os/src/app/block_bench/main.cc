@@ -0,0 +1,571 @@
+/*
+ * \brief  Block-session benchmark
+ * \author Genode Labs
+ * \date   2016-09-08
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/snprintf.h>
+#include <base/allocator_avl.h>
+#include <base/attached_rom_dataspace.h>
+#include <block_session/connection.h>
+#include <timer_session/connection.h>
+#include <os/reporter.h>
+#include <util/volatile_object.h>
+
+namespace Block_bench {
+
+	using namespace Genode;
+
+	typedef String<32> Name;
+
+	struct Histogram;
+	struct Job_config;
+	struct Result;
+	class  Job;
+	struct Main;
+}
+
+
+/**
+ * Latency distribution in microseconds
+ *
+ * Values below 64 are counted exactly. Each larger power-of-two range is
+ * split into 32 buckets, which bounds the error of a reported percentile
+ * to about 3 percent.
+ */
+struct Block_bench::Histogram
+{
+	enum {
+		SUB_BITS    = 5,
+		SUB         = 1 << SUB_BITS,
+		NUM_BUCKETS = (32 - SUB_BITS + 1)*SUB,
+	};
+
+	unsigned long buckets[NUM_BUCKETS];
+	unsigned long count = 0;
+	uint64_t      total = 0;
+	uint64_t      min   = ~0ULL;
+	uint64_t      max   = 0;
+
+	Histogram() { for (unsigned i = 0; i < NUM_BUCKETS; i++) buckets[i] = 0; }
+
+	static unsigned _index(uint64_t us)
+	{
+		if (us < 2*SUB)
+			return us;
+
+		if (us >> 32)
+			return NUM_BUCKETS - 1;
+
+		unsigned const shift = log2((unsigned long)us) - SUB_BITS;
+		return (shift + 1)*SUB + (us >> shift) - SUB;
+	}
+
+	/**
+	 * Return lower bound of bucket
+	 */
+	static uint64_t _value(unsigned index)
+	{
+		if (index < 2*SUB)
+			return index;
+
+		unsigned const shift = index/SUB - 1;
+		return (uint64_t)(index % SUB + SUB) << shift;
+	}
+
+	void record(uint64_t us)
+	{
+		buckets[_index(us)]++;
+		count++;
+		total += us;
+		min    = Genode::min(min, us);
+		max    = Genode::max(max, us);
+	}
+
+	/**
+	 * Return latency not exceeded by the given fraction of requests
+	 *
+	 * \param permille  fraction in 1/1000
+	 */
+	uint64_t percentile(unsigned permille) const
+	{
+		uint64_t const target = ((uint64_t)count*permille + 999)/1000;
+		uint64_t       sum    = 0;
+
+		for (unsigned i = 0; i < NUM_BUCKETS; i++) {
+			sum += buckets[i];
+			if (sum >= target)
+				return Genode::min(max, _value(i + 1) - 1);
+		}
+		return max;
+	}
+
+	void report(Xml_generator &xml, char const *op) const
+	{
+		if (!count)
+			return;
+
+		xml.node("latency", [&] () {
+			xml.attribute("op",    op);
+			xml.attribute("count", count);
+			xml.attribute("min",   min);
+			xml.attribute("avg",   total / count);
+			xml.attribute("p50",   percentile(500));
+			xml.attribute("p99",   percentile(990));
+			xml.attribute("p999",  percentile(999));
+			xml.attribute("max",   max);
+		});
+	}
+};
+
+
+struct Block_bench::Job_config
+{
+	Name     name;
+	bool     random;
+	unsigned read_percent;
+	size_t   request_size;
+	unsigned queue_depth;
+	uint64_t length;
+	uint64_t seed;
+
+	Job_config(Xml_node node)
+	:
+		name(node.attribute_value("name", Name("job"))),
+		random(node.attribute_value("pattern", Name("sequential")) == "random"),
+		read_percent(min(100U, node.attribute_value("read_percent", 100U))),
+		request_size(node.attribute_value("request_size", Number_of_bytes(4096))),
+		queue_depth(max(1U, min((unsigned)Block::Session::TX_QUEUE_SIZE - 1,
+		                        node.attribute_value("queue_depth", 1U)))),
+		length(node.attribute_value("length", Number_of_bytes(16*1024*1024))),
+		seed(node.attribute_value("seed", 1ULL))
+	{ }
+};
+
+
+/**
+ * Measurements of a job
+ */
+struct Block_bench::Result
+{
+	Job_config const config;
+
+	uint64_t      bytes    = 0;
+	uint64_t      start_us = 0;
+	uint64_t      end_us   = 0;
+	unsigned long errors   = 0;
+
+	Histogram read_latency;
+	Histogram write_latency;
+
+	Result(Job_config const &config) : config(config) { }
+
+	static String<16> _fraction(uint64_t value, uint64_t divisor)
+	{
+		uint64_t const hundredths = divisor ? value*100 / divisor : 0;
+
+		char buf[16];
+		snprintf(buf, sizeof(buf), "%llu.%02u",
+		         (unsigned long long)(hundredths / 100),
+		         (unsigned)(hundredths % 100));
+		return String<16>(buf);
+	}
+
+	uint64_t duration_us() const { return end_us - start_us; }
+
+	uint64_t iops() const
+	{
+		uint64_t const us = duration_us();
+		return us ? (read_latency.count + write_latency.count)*1000*1000 / us : 0;
+	}
+
+	String<16> mib_per_s() const {
+		return _fraction(bytes*1000*1000 / (1024*1024), duration_us()); }
+
+	void log_summary() const
+	{
+		Histogram const &l = read_latency.count ? read_latency : write_latency;
+
+		log(config.name, ": ", bytes / 1024, " KiB in ",
+		    duration_us() / 1000, " ms, ", mib_per_s(), " MiB/s, ",
+		    iops(), " IOPS, latency p50/p99/p999 ",
+		    l.percentile(500), "/", l.percentile(990), "/",
+		    l.percentile(999), " us", errors ? ", failed requests" : "");
+	}
+
+	void report(Xml_generator &xml) const
+	{
+		xml.node("job", [&] () {
+			xml.attribute("name",         config.name);
+			xml.attribute("pattern",      config.random ? "random" : "sequential");
+			xml.attribute("read_percent", config.read_percent);
+			xml.attribute("request_size", config.request_size);
+			xml.attribute("queue_depth",  config.queue_depth);
+			xml.attribute("bytes",        bytes);
+			xml.attribute("duration_us",  duration_us());
+			xml.attribute("iops",         iops());
+			xml.attribute("mib_per_s",    mib_per_s());
+			xml.attribute("errors",       errors);
+
+			read_latency .report(xml, "read");
+			write_latency.report(xml, "write");
+		});
+	}
+};
+
+
+/**
+ * Execution of one benchmark job
+ *
+ * The job keeps 'queue_depth' requests in flight until 'length' bytes
+ * were transferred. Each request slot owns a fixed region of the bulk
+ * buffer, which is reused by all requests issued via the slot.
+ */
+class Block_bench::Job
+{
+	public:
+
+		class Invalid : Exception { };
+
+	private:
+
+		enum {
+			ALIGN     = 1 << Block::Packet_descriptor::PACKET_ALIGNMENT,
+			MAX_SLOTS = Block::Session::TX_QUEUE_SIZE,
+		};
+
+		struct Slot
+		{
+			Block::Packet_descriptor packet;
+			uint64_t                 start_us = 0;
+		};
+
+		Job_config const  &_config;
+		Result            &_result;
+		Timer::Connection &_timer;
+
+		Signal_context_capability const _done_sigh;
+
+		Allocator_avl     _tx_alloc;
+		Block::Connection _session;
+
+		Block::sector_t            _blk_count = 0;
+		size_t                     _blk_size  = 0;
+		Block::Session::Operations _ops;
+
+		size_t          _blk_per_req = 0;
+		Block::sector_t _next_blk    = 0;
+		uint64_t        _random      = _config.seed ? _config.seed : 1;
+
+		/* slots sorted by packet offset, and stack of free slot indices */
+		Slot     _slots[MAX_SLOTS];
+		unsigned _free[MAX_SLOTS];
+		unsigned _num_free = 0;
+
+		uint64_t _submitted = 0;
+
+		Signal_handler<Job> _ack_handler;
+		Signal_handler<Job> _submit_handler;
+
+		static size_t _tx_buf_size(Job_config const &config)
+		{
+			size_t const slot_size = align_addr(config.request_size,
+			                                    Block::Packet_descriptor::PACKET_ALIGNMENT);
+
+			/* account for the packet queues and the alignment of the buffer */
+			return config.queue_depth*slot_size
+			     + sizeof(Block::Session::Tx_policy::Ack_queue)
+			     + sizeof(Block::Session::Tx_policy::Submit_queue)
+			     + ALIGN;
+		}
+
+		/**
+		 * Xorshift pseudo-random number generator
+		 */
+		uint64_t _rand()
+		{
+			_random ^= _random << 13;
+			_random ^= _random >> 7;
+			_random ^= _random << 17;
+			return _random;
+		}
+
+		Block::sector_t _block_number()
+		{
+			if (_config.random)
+				return (_rand() % (_blk_count / _blk_per_req))*_blk_per_req;
+
+			Block::sector_t const nr = _next_blk;
+			_next_blk = (nr + 2*_blk_per_req > _blk_count) ? 0 : nr + _blk_per_req;
+			return nr;
+		}
+
+		bool _read()
+		{
+			return _config.read_percent == 100
+			    || (_rand() % 100) < _config.read_percent;
+		}
+
+		Slot &_slot_by_offset(off_t offset)
+		{
+			unsigned lo = 0, hi = _config.queue_depth - 1;
+			while (lo < hi) {
+				unsigned const mid = (lo + hi) / 2;
+				if (_slots[mid].packet.offset() < offset)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return _slots[lo];
+		}
+
+		void _submit()
+		{
+			while (_num_free && _submitted < _config.length
+			       && _session.tx()->ready_to_submit()) {
+
+				Slot &slot = _slots[_free[--_num_free]];
+
+				Block::Packet_descriptor::Opcode const op = _read()
+					? Block::Packet_descriptor::READ
+					: Block::Packet_descriptor::WRITE;
+
+				slot.packet = Block::Packet_descriptor(slot.packet, op,
+				                                       _block_number(),
+				                                       _blk_per_req);
+				slot.start_us = _timer.now_us();
+
+				_session.tx()->submit_packet(slot.packet);
+				_submitted += _config.request_size;
+			}
+		}
+
+		void _handle_ack()
+		{
+			while (_session.tx()->ack_avail()) {
+
+				Block::Packet_descriptor const p = _session.tx()->get_acked_packet();
+
+				uint64_t const now  = _timer.now_us();
+				Slot          &slot = _slot_by_offset(p.offset());
+
+				if (!p.succeeded())
+					_result.errors++;
+
+				if (p.operation() == Block::Packet_descriptor::READ)
+					_result.read_latency.record(now - slot.start_us);
+				else
+					_result.write_latency.record(now - slot.start_us);
+
+				_result.bytes += _config.request_size;
+				_free[_num_free++] = &slot - _slots;
+			}
+
+			_submit();
+
+			if (_result.bytes >= _config.length && !_result.end_us) {
+				_result.end_us = _timer.now_us();
+				Signal_transmitter(_done_sigh).submit();
+			}
+		}
+
+		void _handle_submit() { _submit(); }
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param result     measurements of the job
+		 * \param done_sigh  signal handler notified when the job finished
+		 *
+		 * \throw Invalid  job does not fit the device
+		 */
+		Job(Env &env, Allocator &alloc, Timer::Connection &timer,
+		    Result &result, Signal_context_capability done_sigh)
+		:
+			_config(result.config), _result(result), _timer(timer),
+			_done_sigh(done_sigh), _tx_alloc(&alloc),
+			_session(env, &_tx_alloc, _tx_buf_size(_config),
+			         _config.name.string()),
+			_ack_handler(env.ep(), *this, &Job::_handle_ack),
+			_submit_handler(env.ep(), *this, &Job::_handle_submit)
+		{
+			_session.info(&_blk_count, &_blk_size, &_ops);
+
+			_blk_per_req = _config.request_size / _blk_size;
+
+			if (!_blk_per_req || _config.request_size % _blk_size
+			 || _blk_per_req > _blk_count
+			 || !_ops.supported(Block::Packet_descriptor::READ)
+			 || (_config.read_percent < 100
+			  && !_ops.supported(Block::Packet_descriptor::WRITE))) {
+				error("job '", _config.name, "' not applicable to device "
+				      "with ", _blk_count, " blocks of ", _blk_size, " bytes");
+				throw Invalid();
+			}
+
+			/* allocate the packet of each slot once, sorted by offset */
+			unsigned const qd = _config.queue_depth;
+			for (unsigned i = 0; i < qd; i++) {
+				Slot s;
+				s.packet = _session.dma_alloc_packet(_config.request_size);
+				memset(_session.tx()->packet_content(s.packet), i,
+				       _config.request_size);
+
+				unsigned j = i;
+				for (; j > 0 && _slots[j - 1].packet.offset() > s.packet.offset(); j--)
+					_slots[j] = _slots[j - 1];
+				_slots[j] = s;
+
+				_free[_num_free++] = i;
+			}
+
+			_session.tx_channel()->sigh_ack_avail(_ack_handler);
+			_session.tx_channel()->sigh_ready_to_submit(_submit_handler);
+
+			_result.start_us = _timer.now_us();
+			_submit();
+		}
+
+		~Job()
+		{
+			for (unsigned i = 0; i < _config.queue_depth; i++)
+				_session.tx()->release_packet(_slots[i].packet);
+		}
+};
+
+
+struct Block_bench::Main
+{
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	Attached_rom_dataspace config { env, "config" };
+
+	Timer::Connection timer { env };
+
+	Reporter reporter { "block_bench", "block_bench", 16*1024 };
+
+	/*
+	 * The jobs are executed one after another. Only one job is connected
+	 * to the block server at a time because block servers usually accept
+	 * a single session only. The results are kept for the final report.
+	 */
+	enum { MAX_JOBS = 16 };
+	Result  *results[MAX_JOBS];
+	unsigned num_results = 0;
+	unsigned next_job    = 0;
+
+	Lazy_volatile_object<Job> job;
+
+	/*
+	 * Effective resolution of the latency samples
+	 */
+	unsigned timer_resolution_us = 1000;
+
+	Signal_handler<Main> done_handler { env.ep(), *this, &Main::_handle_done };
+
+	void _report()
+	{
+		if (!config.xml().attribute_value("report", false))
+			return;
+
+		reporter.enabled(true);
+		Reporter::Xml_generator xml(reporter, [&] () {
+			xml.attribute("timer_resolution_us", timer_resolution_us);
+			for (unsigned i = 0; i < num_results; i++)
+				results[i]->report(xml);
+		});
+	}
+
+	/**
+	 * Start the next applicable job, return false if there is none
+	 */
+	bool _start_next_job()
+	{
+		bool started = false;
+
+		unsigned index = 0;
+		config.xml().for_each_sub_node("job", [&] (Xml_node node) {
+			if (started || index++ < next_job || num_results == MAX_JOBS)
+				return;
+
+			next_job++;
+
+			Result *result = new (heap) Result(Job_config(node));
+			try {
+				job.construct(env, heap, timer, *result, done_handler);
+				results[num_results++] = result;
+				started = true;
+			} catch (Job::Invalid) {
+				destroy(heap, result);
+			}
+		});
+		return started;
+	}
+
+	void _finish()
+	{
+		_report();
+		log("--- block benchmark finished ---");
+	}
+
+	void _handle_done()
+	{
+		job.destruct();
+		results[num_results - 1]->log_summary();
+
+		if (!_start_next_job())
+			_finish();
+	}
+
+	/**
+	 * Wait until the clock page of the timer session is calibrated
+	 *
+	 * Until then, the latencies could be sampled with millisecond
+	 * resolution only. The clock page is never calibrated on platforms
+	 * without a usable CPU counter.
+	 */
+	void _wait_for_clock_calibration()
+	{
+		enum { STEP_MS = 50, MAX_WAIT_MS = 3000 };
+
+		for (unsigned ms = 0; ms < MAX_WAIT_MS; ms += STEP_MS) {
+			if (timer.clock_calibrated()) {
+				timer_resolution_us = 1;
+				break;
+			}
+			timer.msleep(STEP_MS);
+		}
+
+		if (timer_resolution_us > 1)
+			warning("timer clock not calibrated, latencies have a "
+			        "resolution of ", timer_resolution_us, " us");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- block benchmark started ---");
+
+		_wait_for_clock_calibration();
+
+		if (!_start_next_job())
+			_finish();
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Block_bench::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = block_bench
+SRC_CC = main.cc
+LIBS  += base
@@ -0,0 +1,420 @@
+/*
+ * \brief  Report RPC latencies obtained from binary trace-event records
+ * \author Genode Labs
+ * \date   2016-08-31
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/attached_rom_dataspace.h>
+#include <base/trace/buffer.h>
+#include <dataspace/client.h>
+#include <trace_session/connection.h>
+#include <timer_session/connection.h>
+#include <trace/event_record.h>
+#include <os/reporter.h>
+#include <util/misc_math.h>
+
+namespace Trace_rpc_latency {
+
+	using namespace Genode;
+
+	typedef Trace::Event_record Record;
+	typedef String<48>          Rpc_name;
+
+	struct Histogram;
+	struct Rpc_stats;
+	class  Rpc_registry;
+	class  Buffer_reader;
+	struct Subject;
+	struct Main;
+}
+
+
+/**
+ * Latency distribution in power-of-two buckets of cycles
+ */
+struct Trace_rpc_latency::Histogram
+{
+	enum { NUM_BUCKETS = 48 };
+
+	unsigned long      buckets[NUM_BUCKETS];
+	unsigned long      count = 0;
+	Trace::Timestamp   total = 0;
+	Trace::Timestamp   max   = 0;
+
+	Histogram() { for (unsigned i = 0; i < NUM_BUCKETS; i++) buckets[i] = 0; }
+
+	void record(Trace::Timestamp cycles)
+	{
+		buckets[min(cycles ? log2(cycles) : 0, (unsigned)NUM_BUCKETS - 1)]++;
+		count++;
+		total += cycles;
+		max    = Genode::max(max, cycles);
+	}
+
+	void report(Xml_generator &xml, char const *node_name) const
+	{
+		if (!count)
+			return;
+
+		xml.node(node_name, [&] () {
+			xml.attribute("count", count);
+			xml.attribute("avg",   total / count);
+			xml.attribute("max",   max);
+
+			for (unsigned i = 0; i < NUM_BUCKETS; i++) {
+				if (!buckets[i])
+					continue;
+
+				xml.node("bucket", [&] () {
+					xml.attribute("below", 2ULL << i);
+					xml.attribute("count", buckets[i]);
+				});
+			}
+		});
+	}
+};
+
+
+/**
+ * Latencies of one RPC function
+ *
+ * The 'call' histogram covers the time from issuing the call until the
+ * reply arrived at the client. The 'dispatch' histogram covers the time
+ * spent by the server from dispatching the request until replying.
+ */
+struct Trace_rpc_latency::Rpc_stats : List<Rpc_stats>::Element
+{
+	Rpc_name const name;
+
+	Histogram call;
+	Histogram dispatch;
+
+	Rpc_stats(Rpc_name const &name) : name(name) { }
+};
+
+
+class Trace_rpc_latency::Rpc_registry
+{
+	private:
+
+		Allocator       &_alloc;
+		List<Rpc_stats>  _stats;
+
+	public:
+
+		Rpc_registry(Allocator &alloc) : _alloc(alloc) { }
+
+		~Rpc_registry() { reset(); }
+
+		Rpc_stats &lookup(Rpc_name const &name)
+		{
+			for (Rpc_stats *s = _stats.first(); s; s = s->next())
+				if (s->name == name)
+					return *s;
+
+			Rpc_stats *s = new (_alloc) Rpc_stats(name);
+			_stats.insert(s);
+			return *s;
+		}
+
+		void reset()
+		{
+			while (Rpc_stats *s = _stats.first()) {
+				_stats.remove(s);
+				destroy(_alloc, s);
+			}
+		}
+
+		void report(Xml_generator &xml) const
+		{
+			for (Rpc_stats const *s = _stats.first(); s; s = s->next()) {
+				xml.node("rpc", [&] () {
+					xml.attribute("name", s->name);
+					s->call.report(xml, "call");
+					s->dispatch.report(xml, "dispatch");
+				});
+			}
+		}
+};
+
+
+/**
+ * Reader of the records not yet consumed from a trace buffer
+ *
+ * The trace buffer is a ring buffer without a read pointer. Entries
+ * following the most recent entry stem from the previous lap of the
+ * writer. The reader tells them apart by their timestamps.
+ */
+class Trace_rpc_latency::Buffer_reader
+{
+	private:
+
+		Region_map          &_rm;
+		Trace::Buffer const &_buffer;
+		Trace::Buffer::Entry _last          = _buffer.first();
+		bool                 _consumed      = false;
+		unsigned             _wrapped       = 0;
+		Trace::Timestamp     _last_ts       = 0;
+
+		/**
+		 * Return true if timestamp 'a' precedes timestamp 'b'
+		 */
+		static bool _older(Trace::Timestamp a, Trace::Timestamp b)
+		{
+			Trace::Timestamp const diff = a - b;
+			return diff >> (sizeof(diff)*8 - 1);
+		}
+
+		template <typename FN>
+		void _consume_from(Trace::Buffer::Entry e, FN const &fn)
+		{
+			for (; !e.last() && e.length(); e = _buffer.next(e)) {
+
+				Record const *r = Record::from_entry(e.data(), e.length());
+				if (!r)
+					continue;
+
+				/*
+				 * Reached stale entry of the previous lap. The timestamps
+				 * are compared modulo wrap-around because the counter is
+				 * only 32 bit wide on some platforms.
+				 */
+				if (_consumed && _older(r->timestamp, _last_ts))
+					return;
+
+				fn(*r, Rpc_name(Cstring(r->name, r->name_len(e.length()))));
+
+				_last     = e;
+				_last_ts  = r->timestamp;
+				_consumed = true;
+			}
+		}
+
+	public:
+
+		Buffer_reader(Region_map &rm, Dataspace_capability ds)
+		:
+			_rm(rm), _buffer(*static_cast<Trace::Buffer *>(_rm.attach(ds)))
+		{ }
+
+		~Buffer_reader() { _rm.detach(&_buffer); }
+
+		/**
+		 * Call 'fn' with each record committed since the last call
+		 */
+		template <typename FN>
+		void for_each_new_record(FN const &fn)
+		{
+			unsigned const wrapped = _buffer.wrapped();
+
+			/* finish the lap we stopped reading at */
+			if (_consumed)
+				_consume_from(_buffer.next(_last), fn);
+
+			/* continue at the start of the buffer for each new lap */
+			if (wrapped != _wrapped || !_consumed)
+				_consume_from(_buffer.first(), fn);
+
+			_wrapped = wrapped;
+		}
+};
+
+
+struct Trace_rpc_latency::Subject : List<Subject>::Element
+{
+	Trace::Subject_id const id;
+
+	Buffer_reader reader;
+
+	struct Pending
+	{
+		Rpc_name         name;
+		Trace::Timestamp start = 0;
+		bool             valid = false;
+
+		void begin(Rpc_name const &n, Trace::Timestamp t) {
+			name = n; start = t; valid = true; }
+
+		template <typename FN>
+		void end(Rpc_name const &n, Trace::Timestamp t, FN const &fn)
+		{
+			if (valid && name == n)
+				fn(t - start);
+
+			valid = false;
+		}
+	};
+
+	Pending call, dispatch;
+
+	Subject(Region_map &rm, Trace::Subject_id id, Dataspace_capability buffer)
+	: id(id), reader(rm, buffer) { }
+
+	void update(Rpc_registry &registry)
+	{
+		reader.for_each_new_record([&] (Record const &r, Rpc_name const &name) {
+
+			Trace::Timestamp const t = r.timestamp;
+
+			switch (r.type) {
+
+			case Record::RPC_CALL:     call.begin(name, t);     break;
+			case Record::RPC_DISPATCH: dispatch.begin(name, t); break;
+
+			case Record::RPC_RETURNED:
+				call.end(name, t, [&] (Trace::Timestamp cycles) {
+					registry.lookup(name).call.record(cycles); });
+				break;
+
+			case Record::RPC_REPLY:
+				dispatch.end(name, t, [&] (Trace::Timestamp cycles) {
+					registry.lookup(name).dispatch.record(cycles); });
+				break;
+
+			default: break;
+			}
+		});
+	}
+};
+
+
+struct Trace_rpc_latency::Main
+{
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	Attached_rom_dataspace config { env, "config" };
+
+	Trace::Connection trace { env, 512*1024, 32*1024, 0 };
+
+	Timer::Connection timer { env };
+
+	Reporter reporter { "rpc_latency", "rpc_latency", 64*1024 };
+
+	Rpc_registry registry { heap };
+
+	List<Subject> subjects;
+
+	Trace::Policy_id policy_id;
+
+	size_t buffer_size = 64*1024;
+
+	enum { MAX_SUBJECTS = 512 };
+	Trace::Subject_id subject_ids[MAX_SUBJECTS];
+
+	void _load_policy()
+	{
+		Attached_rom_dataspace policy_rom(env, "event_record");
+
+		size_t const size = policy_rom.size();
+
+		policy_id = trace.alloc_policy(size);
+
+		void *dst = env.rm().attach(trace.policy(policy_id));
+		memcpy(dst, policy_rom.local_addr<void>(), size);
+		env.rm().detach(dst);
+	}
+
+	bool _selected(Trace::Subject_info const &info) const
+	{
+		typedef String<Session_label::capacity()> Label;
+
+		bool result = false;
+		config.xml().for_each_sub_node("trace", [&] (Xml_node node) {
+			if (!node.has_attribute("label_prefix"))
+				return;
+
+			Label const prefix = node.attribute_value("label_prefix", Label());
+			if (!strcmp(info.session_label().string(), prefix.string(),
+			            strlen(prefix.string())))
+				result = true;
+		});
+		return result;
+	}
+
+	Subject *_lookup(Trace::Subject_id id)
+	{
+		for (Subject *s = subjects.first(); s; s = s->next())
+			if (s->id == id)
+				return s;
+
+		return nullptr;
+	}
+
+	void _update_subjects()
+	{
+		unsigned const num = trace.subjects(subject_ids, MAX_SUBJECTS);
+
+		for (unsigned i = 0; i < num; i++) {
+
+			Trace::Subject_id const id   = subject_ids[i];
+			Trace::Subject_info const info = trace.subject_info(id);
+			Subject *s = _lookup(id);
+
+			if (info.state() == Trace::Subject_info::DEAD) {
+				if (s) {
+					s->update(registry);
+					subjects.remove(s);
+					destroy(heap, s);
+				}
+				trace.free(id);
+				continue;
+			}
+
+			if (s || info.state() != Trace::Subject_info::UNTRACED
+			 || !_selected(info))
+				continue;
+
+			try {
+				trace.trace(id, policy_id, buffer_size);
+				subjects.insert(new (heap) Subject(env.rm(), id, trace.buffer(id)));
+			} catch (...) {
+				warning("could not trace thread '", info.thread_name(), "' "
+				        "of '", info.session_label(), "'");
+			}
+		}
+	}
+
+	Signal_handler<Main> period_handler { env.ep(), *this, &Main::_handle_period };
+
+	void _handle_period()
+	{
+		_update_subjects();
+
+		for (Subject *s = subjects.first(); s; s = s->next())
+			s->update(registry);
+
+		reporter.clear();
+		Reporter::Xml_generator xml(reporter, [&] () { registry.report(xml); });
+
+		if (config.xml().attribute_value("reset", false))
+			registry.reset();
+	}
+
+	Main(Env &env) : env(env)
+	{
+		buffer_size = config.xml().attribute_value("buffer_size", buffer_size);
+
+		_load_policy();
+
+		reporter.enabled(true);
+
+		timer.sigh(period_handler);
+		timer.trigger_periodic(1000*config.xml().attribute_value("period_ms", 5000UL));
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Trace_rpc_latency::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = trace_rpc_latency
+SRC_CC = main.cc
+LIBS  += base
@@ -0,0 +1,199 @@
+/*
+ * \brief  Calibration of the clock pages of the timer sessions
+ * \author Genode Labs
+ * \date   2016-08-31
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _TIMER_CLOCK_H_
+#define _TIMER_CLOCK_H_
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/env.h>
+#include <util/list.h>
+#include <os/alarm.h>
+#include <timer_session/clock_page.h>
+
+/* local includes */
+#include "platform_timer.h"
+
+namespace Timer {
+
+	class Clock_page_dataspace;
+	class Clock;
+}
+
+
+/**
+ * Clock page of a timer session
+ */
+class Timer::Clock_page_dataspace : public Genode::List<Clock_page_dataspace>::Element
+{
+	private:
+
+		typedef Genode::uint64_t uint64_t;
+
+		Genode::Attached_ram_dataspace _ds { Genode::env()->ram_session(),
+		                                     sizeof(Clock_page) };
+
+		Clock_page &_page = *_ds.local_addr<Clock_page>();
+
+		/* time of session creation */
+		uint64_t const _initial_us;
+
+	public:
+
+		Clock_page_dataspace(uint64_t initial_us) : _initial_us(initial_us) { }
+
+		/**
+		 * RAM quota consumed by the dataspace shared with the client
+		 */
+		static Genode::size_t ds_quota() {
+			return Genode::align_addr(sizeof(Clock_page), 12); }
+
+		Genode::Dataspace_capability cap() const { return _ds.cap(); }
+
+		void update(uint64_t base_ts, uint64_t base_us, uint64_t mul)
+		{
+			_page.update(base_ts, base_us - _initial_us, mul);
+		}
+};
+
+
+/**
+ * Driver-global clock
+ *
+ * The clock extends the platform time to 64 bit and determines the rate of
+ * the CPU counter by comparing it to the platform time. The calibration is
+ * periodically refined and published to the clock pages of all sessions.
+ * Between two calibrations, the published clock is slewed towards the
+ * platform time such that the time observed by the clients never goes
+ * backwards.
+ */
+class Timer::Clock
+{
+	private:
+
+		typedef Genode::uint64_t uint64_t;
+
+		Platform_timer &_platform_timer;
+
+		/* platform time extended to 64 bit */
+		unsigned long _last_raw_us = _platform_timer.curr_time();
+		uint64_t      _now_us      = 0;
+
+		/* begin of the current measurement window */
+		uint64_t _window_ts = 0;
+		uint64_t _window_us = 0;
+
+		/* published calibration */
+		uint64_t _base_ts = 0;
+		uint64_t _base_us = 0;
+		uint64_t _mul     = 0;
+
+		Genode::List<Clock_page_dataspace> _pages;
+
+		/*
+		 * Restart the measurement window once it covers enough time for
+		 * a precise rate, which also keeps the fixed-point arithmetics from
+		 * overflowing.
+		 */
+		enum { MAX_WINDOW_US = 60*1000*1000 };
+
+		void _publish(Clock_page_dataspace &page) {
+			page.update(_base_ts, _base_us, _mul); }
+
+	public:
+
+		/*
+		 * Interval between two calibrations
+		 */
+		enum { PERIOD_US = 1000*1000 };
+
+		Clock(Platform_timer &platform_timer) : _platform_timer(platform_timer) { }
+
+		/**
+		 * Return platform time in microseconds, extended to 64 bit
+		 */
+		uint64_t now_us()
+		{
+			unsigned long const raw = _platform_timer.curr_time();
+
+			_now_us     += raw - _last_raw_us;
+			_last_raw_us = raw;
+
+			return _now_us;
+		}
+
+		void insert(Clock_page_dataspace &page)
+		{
+			/* restart the measurement window after a time without pages */
+			if (!_pages.first())
+				_window_ts = 0;
+
+			_pages.insert(&page);
+			_publish(page);
+		}
+
+		void remove(Clock_page_dataspace &page) { _pages.remove(&page); }
+
+		bool has_pages() const { return _pages.first() != nullptr; }
+
+		/**
+		 * Refine calibration and publish it to the clock pages
+		 */
+		void calibrate()
+		{
+			if (!Clock_page::counter_available())
+				return;
+
+			uint64_t const ts = Clock_page::counter();
+			uint64_t const us = now_us();
+
+			/* start the first measurement window */
+			if (_window_ts == 0 || ts <= _window_ts || us <= _window_us) {
+				_window_ts = ts;
+				_window_us = us;
+				return;
+			}
+
+			/* nominal rate of the counter measured over the window */
+			uint64_t const rate = ((us - _window_us) << Clock_page::SHIFT)
+			                    / (ts - _window_ts);
+
+			/* time according to the published calibration */
+			uint64_t const published = _mul
+			                         ? Clock_page::extrapolate(ts, _base_ts, _base_us, _mul)
+			                         : us;
+
+			/*
+			 * Never publish a time before the time observable with the
+			 * previous calibration. Slew the rate such that the published
+			 * time meets the platform time at the next calibration.
+			 */
+			uint64_t const base   = published > us ? published : us;
+			uint64_t const target = us + PERIOD_US;
+			uint64_t const slew   = target > base + PERIOD_US/2 ? target - base
+			                                                    : PERIOD_US/2;
+			_base_ts = ts;
+			_base_us = base;
+			_mul     = rate*slew/PERIOD_US;
+
+			if (us - _window_us > MAX_WINDOW_US) {
+				_window_ts = ts;
+				_window_us = us;
+			}
+
+			for (Clock_page_dataspace *p = _pages.first(); p; p = p->next())
+				_publish(*p);
+		}
+};
+
+#endif /* _TIMER_CLOCK_H_ */
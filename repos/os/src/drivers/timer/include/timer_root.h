@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2006-2013 Genode Labs GmbH
+ * Copyright (C) 2006-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -42,13 +42,20 @@ class Timer::Root_component : public Genode::Root_component<Session_component>
 		{
 			Genode::size_t ram_quota = Genode::Arg_string::find_arg(args, "ram_quota").ulong_value(0);
 
-			if (ram_quota < sizeof(Session_component)) {
-				PWRN("Insufficient donated ram_quota (%ld bytes), require %zd bytes",
-				     ram_quota, sizeof(Session_component));
+			/*
+			 * The session object itself is already accounted by the
+			 * generic root component, the remaining quota must cover the
+			 * session meta data.
+			 */
+			Genode::size_t const needed = Session_component::quota_needed();
+			if (ram_quota < needed) {
+				PERR("Insufficient donated ram_quota (%ld bytes), require %zd bytes",
+				     ram_quota, needed);
+				throw Genode::Root::Quota_exceeded();
 			}
 
 			return new (md_alloc())
-				Session_component(_timeout_scheduler);
+				Session_component(_timeout_scheduler, ram_quota);
 		}
 
 	public:
@@ -6,7 +6,7 @@
  */
 
 /*
- * Copyright (C) 2006-2013 Genode Labs GmbH
+ * Copyright (C) 2006-2016 Genode Labs GmbH
  * Copyright (C) 2012 Intel Corporation
  *
  * This file is part of the Genode OS framework, which is distributed
@@ -18,12 +18,16 @@
 
 /* Genode includes */
 #include <util/list.h>
+#include <util/volatile_object.h>
+#include <base/allocator_guard.h>
 #include <os/alarm.h>
 #include <base/rpc_server.h>
 #include <timer_session/timer_session.h>
 
 /* local includes */
 #include "platform_timer.h"
+#include "timer_clock.h"
+#include "timer_timeout_table.h"
 
 
 namespace Timer {
@@ -62,6 +66,7 @@ class Timer::Irq_dispatcher_component : public Genode::Rpc_object<Irq_dispatcher
 
 		Genode::Alarm_scheduler *_alarm_scheduler;
 		Platform_timer          *_platform_timer;
+		Signal_batch            &_signal_batch;
 
 	public:
 
@@ -69,8 +74,9 @@ class Timer::Irq_dispatcher_component : public Genode::Rpc_object<Irq_dispatcher
 		 * Constructor
 		 */
 		Irq_dispatcher_component(Genode::Alarm_scheduler *as,
-		                         Platform_timer          *pt)
-		: _alarm_scheduler(as), _platform_timer(pt) { }
+		                         Platform_timer          *pt,
+		                         Signal_batch            &batch)
+		: _alarm_scheduler(as), _platform_timer(pt), _signal_batch(batch) { }
 
 
 		/******************************
@@ -86,6 +92,7 @@ class Timer::Irq_dispatcher_component : public Genode::Rpc_object<Irq_dispatcher
 
 			/* trigger timeout alarms */
 			_alarm_scheduler->handle(now);
+			_signal_batch.flush();
 
 			/* determine duration for next one-shot timer event */
 			Alarm::Time deadline;
@@ -148,9 +155,31 @@ class Timer::Timeout_scheduler : public Genode::Alarm_scheduler,
 		        Irq_dispatcher_capability;
 
 		Platform_timer           *_platform_timer;
+		Signal_batch              _signal_batch;
 		Irq_dispatcher_component  _irq_dispatcher_component;
 		Irq_dispatcher_capability _irq_dispatcher_cap;
 
+		Clock _clock { *_platform_timer };
+
+		/**
+		 * Alarm for periodically calibrating the clock pages
+		 *
+		 * The alarm is scheduled only while at least one clock page exists
+		 * and the CPU counter is available.
+		 */
+		struct Calibration_alarm : Genode::Alarm
+		{
+			Clock &clock;
+
+			Calibration_alarm(Clock &clock) : clock(clock) { }
+
+			bool on_alarm(unsigned) override
+			{
+				clock.calibrate();
+				return true;
+			}
+		} _calibration_alarm { _clock };
+
 		/**
 		 * Timer-interrupt thread
 		 *
@@ -182,7 +211,7 @@ class Timer::Timeout_scheduler : public Genode::Alarm_scheduler,
 		:
 			Thread_deprecated("timeout_scheduler"),
 			_platform_timer(pt),
-			_irq_dispatcher_component(this, pt),
+			_irq_dispatcher_component(this, pt, _signal_batch),
 			_irq_dispatcher_cap(ep->manage(&_irq_dispatcher_component))
 		{
 			_platform_timer->schedule_timeout(0);
@@ -205,10 +234,70 @@ class Timer::Timeout_scheduler : public Genode::Alarm_scheduler,
 				_platform_timer->schedule_timeout(0);
 		}
 
+		/**
+		 * Apply pending entries of a timeout table
+		 *
+		 * The platform timer is reprogrammed at most once for all entries.
+		 */
+		void apply_timeouts(Timeout_table_component &table)
+		{
+			Genode::Alarm::Time const now = _platform_timer->curr_time();
+
+			/* update '_now' in 'Alarm_scheduler' */
+			handle(now);
+			_signal_batch.flush();
+
+			Genode::Alarm::Time old_deadline = 0;
+			bool const old_valid = next_deadline(&old_deadline);
+
+			table.apply(*this, now);
+
+			/* interrupt current 'wait_for_timeout' if the next deadline moved up */
+			Genode::Alarm::Time deadline = 0;
+			if (next_deadline(&deadline)
+			 && (!old_valid || (long)(deadline - now) < (long)(old_deadline - now)))
+				_platform_timer->schedule_timeout(0);
+		}
+
 		unsigned long curr_time() const
 		{
 			return _platform_timer->curr_time();
 		}
+
+		Clock &clock() { return _clock; }
+
+		/**
+		 * Publish the clock to a new clock page
+		 */
+		void insert_clock_page(Clock_page_dataspace &page)
+		{
+			bool const first = !_clock.has_pages();
+
+			_clock.insert(page);
+
+			if (!first || !Clock_page::counter_available())
+				return;
+
+			/* start the measurement window and the periodic calibration */
+			_clock.calibrate();
+
+			handle(_platform_timer->curr_time()); /* update '_now' */
+			schedule(&_calibration_alarm, Clock::PERIOD_US);
+
+			/* interrupt current 'wait_for_timeout' */
+			if (head_timeout(&_calibration_alarm))
+				_platform_timer->schedule_timeout(0);
+		}
+
+		void remove_clock_page(Clock_page_dataspace &page)
+		{
+			_clock.remove(page);
+
+			if (!_clock.has_pages())
+				discard(&_calibration_alarm);
+		}
+
+		Signal_batch &signal_batch() { return _signal_batch; }
 };
 
 
@@ -221,8 +310,26 @@ class Timer::Session_component : public Genode::Rpc_object<Session>,
 	private:
 
 		Timeout_scheduler  &_timeout_scheduler;
+
+		/*
+		 * Allocator for the session meta data, limited to the RAM quota
+		 * donated by the client
+		 */
+		Genode::Allocator_guard _md_alloc;
+
 		Wake_up_alarm       _wake_up_alarm;
 		unsigned long const _initial_time;
+		Genode::uint64_t const _initial_us;
+
+		/*
+		 * Clock page, allocated on the first request by the client
+		 */
+		Genode::Lazy_volatile_object<Clock_page_dataspace> _clock_page;
+
+		/*
+		 * Timeout table, allocated on the first request by the client
+		 */
+		Timeout_table_component *_timeout_table = nullptr;
 
 		void _trigger(unsigned us, bool periodic)
 		{
@@ -232,13 +339,33 @@ class Timer::Session_component : public Genode::Rpc_object<Session>,
 
 	public:
 
+		/**
+		 * RAM quota needed for the meta data of a session
+		 *
+		 * This covers the clock page as well as the timeout table and its
+		 * dataspace, which are allocated on demand.
+		 */
+		static Genode::size_t quota_needed()
+		{
+			Genode::size_t const size = sizeof(Timeout_table_component);
+
+			return size + Genode::env()->heap()->overhead(size)
+			     + Timeout_table_component::ds_quota()
+			     + Clock_page_dataspace::ds_quota();
+		}
+
 		/**
 		 * Constructor
+		 *
+		 * \param ram_quota  RAM quota donated by the client for the
+		 *                   session meta data
 		 */
-		Session_component(Timeout_scheduler &ts)
+		Session_component(Timeout_scheduler &ts, Genode::size_t ram_quota)
 		:
 			_timeout_scheduler(ts),
-			_initial_time(_timeout_scheduler.curr_time())
+			_md_alloc(Genode::env()->heap(), ram_quota),
+			_initial_time(_timeout_scheduler.curr_time()),
+			_initial_us(_timeout_scheduler.clock().now_us())
 		{ }
 
 		/**
@@ -247,6 +374,12 @@ class Timer::Session_component : public Genode::Rpc_object<Session>,
 		~Session_component()
 		{
 			_timeout_scheduler.discard(&_wake_up_alarm);
+
+			if (_clock_page.constructed())
+				_timeout_scheduler.remove_clock_page(*_clock_page);
+
+			if (_timeout_table)
+				Genode::destroy(&_md_alloc, _timeout_table);
 		}
 
 
@@ -275,6 +408,48 @@ class Timer::Session_component : public Genode::Rpc_object<Session>,
 			return (now - _initial_time) / 1000;
 		}
 
+		Genode::Dataspace_capability clock_page()
+		{
+			if (!_clock_page.constructed()) {
+
+				/* account the dataspace shared with the client */
+				if (!_md_alloc.withdraw(Clock_page_dataspace::ds_quota()))
+					return Genode::Dataspace_capability();
+
+				try { _clock_page.construct(_initial_us); }
+				catch (...) { return Genode::Dataspace_capability(); }
+
+				_timeout_scheduler.insert_clock_page(*_clock_page);
+			}
+			return _clock_page->cap();
+		}
+
+		Genode::Dataspace_capability
+		timeout_table(Signal_context_capability sigh)
+		{
+			if (_timeout_table) {
+				_timeout_table->sigh(sigh);
+				return _timeout_table->cap();
+			}
+
+			/* account the dataspace shared with the client */
+			if (!_md_alloc.withdraw(Timeout_table_component::ds_quota()))
+				return Genode::Dataspace_capability();
+
+			try {
+				_timeout_table = new (&_md_alloc)
+					Timeout_table_component(_timeout_scheduler.signal_batch(), sigh);
+			} catch (...) { return Genode::Dataspace_capability(); }
+
+			return _timeout_table->cap();
+		}
+
+		void apply_timeouts()
+		{
+			if (_timeout_table)
+				_timeout_scheduler.apply_timeouts(*_timeout_table);
+		}
+
 		void msleep(unsigned) { /* never called at the server side */ }
 		void usleep(unsigned) { /* never called at the server side */ }
 };
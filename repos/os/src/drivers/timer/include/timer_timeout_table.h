@@ -0,0 +1,196 @@
+/*
+ * \brief  Timeout tables of the timer sessions
+ * \author Genode Labs
+ * \date   2016-09-02
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _TIMER_TIMEOUT_TABLE_H_
+#define _TIMER_TIMEOUT_TABLE_H_
+
+/* Genode includes */
+#include <base/attached_ram_dataspace.h>
+#include <base/env.h>
+#include <base/signal.h>
+#include <util/list.h>
+#include <os/alarm.h>
+#include <timer_session/timeout_table.h>
+
+namespace Timer {
+
+	class Timeout_table_component;
+	class Signal_batch;
+}
+
+
+/**
+ * Timeout tables with triggered timeouts not yet signalled to the client
+ *
+ * The signals are submitted once after handling all alarms that triggered
+ * at the same time such that each client receives a single signal per
+ * batch of triggered timeouts.
+ */
+class Timer::Signal_batch
+{
+	private:
+
+		Genode::List<Timeout_table_component> _pending;
+
+	public:
+
+		inline void mark(Timeout_table_component &table);
+
+		inline void remove(Timeout_table_component &table);
+
+		/**
+		 * Submit signals for all marked tables
+		 */
+		inline void flush();
+};
+
+
+/**
+ * Timeout table of a timer session
+ */
+class Timer::Timeout_table_component
+:
+	public Genode::List<Timeout_table_component>::Element
+{
+	private:
+
+		friend class Signal_batch;
+
+		/**
+		 * Alarm of one entry of the table
+		 */
+		struct Entry_alarm : Genode::Alarm
+		{
+			Timeout_table_component *owner    = nullptr;
+			unsigned                 id       = 0;
+			bool                     periodic = false;
+
+			bool on_alarm(unsigned) override
+			{
+				owner->_fired(id);
+				return periodic;
+			}
+		};
+
+		Signal_batch                     &_batch;
+		Genode::Signal_context_capability _sigh;
+
+		Genode::Attached_ram_dataspace _ds { Genode::env()->ram_session(),
+		                                     sizeof(Timeout_table) };
+
+		Timeout_table &_table = *_ds.local_addr<Timeout_table>();
+
+		Entry_alarm _alarms[Timeout_table::MAX_TIMEOUTS];
+
+		bool _signal_pending = false;
+
+		void _fired(unsigned id)
+		{
+			Timeout_table::set(_table.fired, id);
+
+			if (!_signal_pending) {
+				_signal_pending = true;
+				_batch.mark(*this);
+			}
+		}
+
+		void _submit_signal()
+		{
+			_signal_pending = false;
+
+			if (_sigh.valid())
+				Genode::Signal_transmitter(_sigh).submit();
+		}
+
+	public:
+
+		Timeout_table_component(Signal_batch &batch,
+		                        Genode::Signal_context_capability sigh)
+		:
+			_batch(batch), _sigh(sigh)
+		{
+			for (unsigned i = 0; i < Timeout_table::MAX_TIMEOUTS; i++) {
+				_alarms[i].owner = this;
+				_alarms[i].id    = i;
+			}
+		}
+
+		~Timeout_table_component()
+		{
+			if (_signal_pending)
+				_batch.remove(*this);
+		}
+
+		/**
+		 * RAM quota consumed by the dataspace shared with the client
+		 */
+		static Genode::size_t ds_quota() {
+			return Genode::align_addr(sizeof(Timeout_table), 12); }
+
+		Genode::Dataspace_capability cap() const { return _ds.cap(); }
+
+		void sigh(Genode::Signal_context_capability sigh) { _sigh = sigh; }
+
+		/**
+		 * Schedule the alarms of all pending entries
+		 *
+		 * \param now  current time of the scheduler
+		 */
+		void apply(Genode::Alarm_scheduler &scheduler, Genode::Alarm::Time now)
+		{
+			Timeout_table::for_each(_table.pending, [&] (unsigned id) {
+
+				Timeout_table::Entry const &entry = _table.entries[id];
+				Genode::uint32_t     const  type  = entry.type;
+				Genode::Alarm::Time  const  us    = entry.us;
+
+				Entry_alarm &alarm = _alarms[id];
+
+				switch (type) {
+
+				case Timeout_table::Entry::ONE_SHOT:
+					alarm.periodic = false;
+					scheduler.schedule_absolute(&alarm, now + us);
+					return;
+
+				case Timeout_table::Entry::PERIODIC:
+					alarm.periodic = true;
+					scheduler.schedule(&alarm, us);
+					return;
+
+				default:
+					scheduler.discard(&alarm);
+					return;
+				}
+			});
+		}
+};
+
+
+void Timer::Signal_batch::mark(Timeout_table_component &table) {
+	_pending.insert(&table); }
+
+
+void Timer::Signal_batch::remove(Timeout_table_component &table) {
+	_pending.remove(&table); }
+
+
+void Timer::Signal_batch::flush()
+{
+	while (Timeout_table_component *table = _pending.first()) {
+		_pending.remove(table);
+		table->_submit_signal();
+	}
+}
+
+#endif /* _TIMER_TIMEOUT_TABLE_H_ */
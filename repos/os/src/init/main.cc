@@ -14,6 +14,8 @@
 #include <init/child.h>
 #include <base/sleep.h>
 #include <os/config.h>
+#include <util/volatile_object.h>
+#include <trace/timestamp.h>
 
 
 namespace Init { bool config_verbose = false; }
@@ -88,6 +90,45 @@ inline void determine_parent_services(Genode::Service_registry *services)
 }
 
 
+/**
+ * Return '<parent-provides>' node of config, or an empty node
+ */
+inline Genode::Xml_node parent_provides_node()
+{
+	try { return Genode::config()->xml_node().sub_node("parent-provides"); }
+	catch (...) { return Genode::Xml_node("<parent-provides/>"); }
+}
+
+
+namespace Init { struct Global_settings; }
+
+
+/**
+ * Config settings that affect all children
+ *
+ * A change of these settings cannot be applied incrementally but requires
+ * the restart of all children.
+ */
+struct Init::Global_settings
+{
+	long const prio_levels = read_prio_levels();
+
+	Genode::Affinity::Space const affinity_space = read_affinity_space();
+
+	Buffered_xml const parent_provides { parent_provides_node() };
+
+	bool differ_from_config() const
+	{
+		Genode::Affinity::Space const space = read_affinity_space();
+
+		return prio_levels           != read_prio_levels()
+		    || affinity_space.width()  != space.width()
+		    || affinity_space.height() != space.height()
+		    || parent_provides.differs_from(parent_provides_node());
+	}
+};
+
+
 /********************
  ** Child registry **
  ********************/
@@ -235,7 +276,28 @@ class Init::Child_registry : public Name_registry, Child_list
 		{
 			Genode::List_element<Child> *curr = first();
 			for (; curr; curr = curr->next())
-				curr->object()->_child.revoke_server(server);
+				curr->object()->revoke_server(server);
+		}
+
+		/**
+		 * Return child with the specified name, or 0 if no such child exists
+		 */
+		Child *child(char const *name)
+		{
+			Genode::List_element<Child> *curr = first();
+			for (; curr; curr = curr->next())
+				if (curr->object()->has_name(name))
+					return curr->object();
+
+			return 0;
+		}
+
+		template <typename FN>
+		void for_each_child(FN const &fn)
+		{
+			Genode::List_element<Child> *curr = first();
+			for (; curr; curr = curr->next())
+				fn(*curr->object());
 		}
 
 
@@ -281,6 +343,53 @@ class Init::Child_registry : public Name_registry, Child_list
 };
 
 
+/**
+ * Look up start node with the specified name in the config
+ *
+ * \return  true if the start node exists
+ */
+static bool lookup_start_node(char const *name, Genode::Xml_node &start_node)
+{
+	using namespace Genode;
+
+	bool found = false;
+	config()->xml_node().for_each_sub_node("start", [&] (Xml_node node) {
+		if (!found && node.attribute_value("name", String<64>()) == name) {
+			start_node = node;
+			found = true;
+		}
+	});
+	return found;
+}
+
+
+/**
+ * Kill child and revoke the sessions the other children have at the child
+ */
+static void destroy_child(Init::Child_registry &children, Init::Child *child)
+{
+	using namespace Genode;
+
+	children.remove(child);
+	Genode::Server const *server = child->server();
+	destroy(env()->heap(), child);
+
+	/*
+	 * The killed child may have provided services to other children.
+	 * Since the server is dead by now, we cannot close its sessions
+	 * in the cooperative way. Instead, we need to instruct each
+	 * other child to forget about session associated with the dead
+	 * server. Note that the 'child' pointer points a a no-more
+	 * existing object. It is only used to identify the corresponding
+	 * session. It must never by de-referenced!
+	 *
+	 * The clients become abandoned and are restarted by the next
+	 * reconfiguration step.
+	 */
+	children.revoke_server(server);
+}
+
+
 int main(int, char **)
 {
 	using namespace Init;
@@ -298,6 +407,8 @@ int main(int, char **)
 	static Child_registry   children;
 	static Cap_connection   cap;
 
+	static Lazy_volatile_object<Global_settings> global_settings;
+
 	/*
 	 * Signal receiver for config changes
 	 */
@@ -308,13 +419,33 @@ int main(int, char **)
 	/* prevent init to block for resource upgrades (never satisfied by core) */
 	env()->parent()->resource_avail_sigh(sig_rec.manage(&sig_ctx_res_avail));
 
-	for (;;) {
+	for (bool initial = true; ; initial = false) {
+
+		Trace::Timestamp const start_time = Trace::timestamp();
 
 		config_verbose =
 			config()->xml_node().attribute_value("verbose", false);
 
-		try { determine_parent_services(&parent_services); }
-		catch (...) { }
+		unsigned num_stopped = 0, num_updated = 0, num_started = 0;
+
+		/*
+		 * Restart the whole scenario if settings changed that affect all
+		 * children
+		 */
+		if (!global_settings.constructed() || global_settings->differ_from_config()) {
+
+			/* kill all currently running children */
+			for (; children.any(); num_stopped++)
+				destroy_child(children, children.any());
+
+			/* reset knowledge about parent services */
+			parent_services.remove_all();
+
+			try { determine_parent_services(&parent_services); }
+			catch (...) { }
+
+			global_settings.construct();
+		}
 
 		/* determine default route for resolving service requests */
 		Xml_node default_route_node("<empty/>");
@@ -323,7 +454,16 @@ int main(int, char **)
 			config()->xml_node().sub_node("default-route"); }
 		catch (...) { }
 
-		/* create aliases */
+		/*
+		 * Re-create aliases, sessions requested from now on are routed
+		 * according to the new aliases
+		 */
+		while (children.any_alias()) {
+			Init::Alias *alias = children.any_alias();
+			children.remove_alias(alias);
+			destroy(env()->heap(), alias);
+		}
+
 		config()->xml_node().for_each_sub_node("alias", [&] (Xml_node alias_node) {
 
 			try {
@@ -333,13 +473,64 @@ int main(int, char **)
 				warning("missing 'name' attribute in '<alias>' entry"); }
 			catch (Alias::Child_is_missing) {
 				warning("missing 'child' attribute in '<alias>' entry"); }
+			catch (Init::Child_registry::Alias_name_is_not_unique) { }
+		});
+
+		/*
+		 * Stop children that vanished from the config or cannot be
+		 * reconfigured while running. Because stopping a server abandons
+		 * its clients, we repeat until no child is to be stopped anymore.
+		 */
+		for (;;) {
+			Init::Child *victim = 0;
+
+			children.for_each_child([&] (Init::Child &child) {
+
+				if (victim) return;
 
+				Xml_node start_node("<start/>");
+				if (!lookup_start_node(child.name(), start_node)
+				 || child.reconfiguration(start_node, default_route_node)
+				    == Init::Child::RESTART_REQUIRED)
+					victim = &child;
+			});
+
+			if (!victim)
+				break;
+
+			if (config_verbose)
+				log("stop child \"", victim->name(), "\"");
+
+			destroy_child(children, victim);
+			num_stopped++;
+		}
+
+		/* forward changed '<config>' entries to the remaining children */
+		children.for_each_child([&] (Init::Child &child) {
+
+			Xml_node start_node("<start/>");
+			if (lookup_start_node(child.name(), start_node)
+			 && child.reconfiguration(start_node, default_route_node)
+			    == Init::Child::CONFIG_CHANGED) {
+
+				if (config_verbose)
+					log("update config of child \"", child.name(), "\"");
+
+				child.update_config(start_node);
+				num_updated++;
+			}
 		});
 
-		/* create children */
+		/* create children that are not running yet */
 		try {
 			config()->xml_node().for_each_sub_node("start", [&] (Xml_node start_node) {
 
+				/* skip children that survived the reconfiguration */
+				Init::Child const *existing =
+					children.child(start_node.attribute_value("name", String<64>()).string());
+				if (existing && existing->started())
+					return;
+
 				try {
 					children.insert(new (env()->heap())
 					                Init::Child(start_node, default_route_node,
@@ -347,6 +538,7 @@ int main(int, char **)
 					                            read_affinity_space(),
 					                            parent_services, child_services, cap,
 					                            ldso_ds));
+					num_started++;
 				}
 				catch (Rom_connection::Rom_connection_failed) {
 					/*
@@ -354,23 +546,27 @@ int main(int, char **)
 					 * by the Rom_connection constructor.
 					 */
 				}
+				catch (Init::Child::Child_name_is_not_unique) { }
+				catch (Xml_node::Nonexistent_attribute) { }
 			});
 
 			/* start children */
 			children.start();
 		}
-		catch (Xml_node::Nonexistent_sub_node) {
-			error("no children to start"); }
 		catch (Xml_node::Invalid_syntax) {
 			error("no children to start"); }
-		catch (Init::Child::Child_name_is_not_unique) { }
-		catch (Init::Child_registry::Alias_name_is_not_unique) { }
+
+		if (!initial)
+			log("reconfiguration: ", num_started, " started, ",
+			    num_stopped, " stopped, ", num_updated, " updated, took ",
+			    Trace::timestamp() - start_time, " cycles");
 
 		/*
 		 * Respond to config changes at runtime
 		 *
-		 * If the config gets updated to a new version, we kill the current
-		 * scenario and start again with the new config.
+		 * If the config gets updated to a new version, we apply the
+		 * differences between the old and the new config to the current
+		 * scenario.
 		 */
 
 		/* wait for config change */
@@ -382,39 +578,9 @@ int main(int, char **)
 			warning("unexpected signal received - drop it");
 		}
 
-		/* kill all currently running children */
-		while (children.any()) {
-			Init::Child *child = children.any();
-			children.remove(child);
-			Genode::Server const *server = child->server();
-			destroy(env()->heap(), child);
-
-			/*
-			 * The killed child may have provided services to other children.
-			 * Since the server is dead by now, we cannot close its sessions
-			 * in the cooperative way. Instead, we need to instruct each
-			 * other child to forget about session associated with the dead
-			 * server. Note that the 'child' pointer points a a no-more
-			 * existing object. It is only used to identify the corresponding
-			 * session. It must never by de-referenced!
-			 */
-			children.revoke_server(server);
-		}
-
-		/* remove all known aliases */
-		while (children.any_alias()) {
-			Init::Alias *alias = children.any_alias();
-			children.remove_alias(alias);
-			destroy(env()->heap(), alias);
-		}
-
-		/* reset knowledge about parent services */
-		parent_services.remove_all();
-
 		/* reload config */
 		try { config()->reload(); } catch (...) { }
 	}
 
 	return 0;
 }
-
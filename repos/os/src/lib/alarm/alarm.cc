@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2005-2013 Genode Labs GmbH
+ * Copyright (C) 2005-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -17,66 +17,109 @@
 using namespace Genode;
 
 
-void Alarm_scheduler::_unsynchronized_enqueue(Alarm *alarm)
+Alarm *Alarm_scheduler::_meld(Alarm *a, Alarm *b)
 {
-	if (alarm->_active) {
-		error("trying to insert the same alarm twice!");
-		return;
-	}
+	if (!a) return b;
+	if (!b) return a;
 
-	alarm->_active++;
+	/* the earlier alarm becomes the root, the other one its first child */
+	if (_earlier(*b, *a)) {
+		Alarm *tmp = a; a = b; b = tmp; }
 
-	/* if alarmlist is empty add first element */
-	if (!_head) {
-		alarm->_next = 0;
-		_head = alarm;
-		return;
+	b->_prev    = a;
+	b->_sibling = a->_child;
+
+	if (a->_child)
+		a->_child->_prev = b;
+
+	a->_child   = b;
+	a->_sibling = 0;
+	a->_prev    = 0;
+
+	return a;
+}
+
+
+Alarm *Alarm_scheduler::_merge_pairs(Alarm *first)
+{
+	/*
+	 * First pass: meld pairs of siblings from left to right and stack the
+	 * results using the sibling link.
+	 */
+	Alarm *pairs = 0;
+	while (first) {
+
+		Alarm *a = first;
+		Alarm *b = a->_sibling;
+
+		first = b ? b->_sibling : 0;
+
+		a->_sibling = a->_prev = 0;
+		if (b)
+			b->_sibling = b->_prev = 0;
+
+		Alarm *pair = _meld(a, b);
+		pair->_sibling = pairs;
+		pairs = pair;
 	}
 
-	/* if deadline is smaller than any other deadline, put it on the head */
-	if ((int)alarm->_deadline - (int)_now < (int)_head->_deadline - (int)_now) {
-		alarm->_next = _head;
-		_head = alarm;
-		return;
+	/* second pass: meld the pairs from right to left */
+	Alarm *root = 0;
+	while (pairs) {
+
+		Alarm *next = pairs->_sibling;
+		pairs->_sibling = 0;
+
+		root  = _meld(root, pairs);
+		pairs = next;
 	}
+	return root;
+}
 
-	/* find list element with a higher deadline */
-	Alarm *curr = _head;
-	while (curr->_next &&
-	       (int)curr->_next->_deadline - (int)_now < (int)alarm->_deadline - (int)_now)
-		curr = curr->_next;
 
-	/* if end of list is reached, append new element */
-	if (curr->_next == 0) {
-		curr->_next = alarm;
+void Alarm_scheduler::_unsynchronized_enqueue(Alarm *alarm)
+{
+	if (alarm->_active) {
+		error("trying to insert the same alarm twice!");
 		return;
 	}
 
-	/* insert element in middle of list */
-	alarm->_next = curr->_next;
-	curr->_next  = alarm;
+	alarm->_active++;
+	alarm->_order = _order++;
+	alarm->_unlink();
+
+	_head = _meld(_head, alarm);
 }
 
 
 void Alarm_scheduler::_unsynchronized_dequeue(Alarm *alarm)
 {
-	if (!_head) return;
+	/* alarm belongs to another scheduler */
+	if (alarm->_scheduler != this) return;
+
+	/* alarm is not enqueued, e.g., it already triggered */
+	if (!_head || !alarm->_active) {
+		alarm->_reset();
+		return;
+	}
 
 	if (_head == alarm) {
-		_head = alarm->_next;
+		_head = _merge_pairs(alarm->_child);
 		alarm->_reset();
 		return;
 	}
 
-	/* find predecessor in alarm queue */
-	Alarm *curr;
-	for (curr = _head; curr && (curr->_next != alarm); curr = curr->_next);
+	/* cut subtree of alarm from its parent or left sibling */
+	if (alarm->_prev->_child == alarm)
+		alarm->_prev->_child = alarm->_sibling;
+	else
+		alarm->_prev->_sibling = alarm->_sibling;
 
-	/* alarm is not enqueued */
-	if (!curr) return;
+	if (alarm->_sibling)
+		alarm->_sibling->_prev = alarm->_prev;
 
-	/* remove alarm from alarm queue */
-	curr->_next = alarm->_next;
+	/* re-insert the children of the alarm */
+	_head = _meld(_head, _merge_pairs(alarm->_child));
 	alarm->_reset();
 }
 
@@ -85,12 +128,12 @@ Alarm *Alarm_scheduler::_get_pending_alarm()
 {
 	Lock::Guard lock_guard(_lock);
 
-	if (!_head || ((int)_head->_deadline - (int)_now >= 0))
+	if (!_head || ((long)(_head->_deadline - _now) >= 0))
 		return 0;
 
-	/* remove alarm from head of the list */
+	/* remove alarm from root of the heap */
 	Alarm *pending_alarm = _head;
-	_head = _head->_next;
+	_head = _merge_pairs(_head->_child);
 
 	/*
 	 * Acquire dispatch lock to defer destruction until the call of 'on_alarm'
@@ -99,7 +142,7 @@ Alarm *Alarm_scheduler::_get_pending_alarm()
 	pending_alarm->_dispatch_lock.lock();
 
 	/* reset alarm object */
-	pending_alarm->_next = 0;
+	pending_alarm->_unlink();
 	pending_alarm->_active--;
 
 	return pending_alarm;
@@ -230,13 +273,13 @@ Alarm_scheduler::~Alarm_scheduler()
 
 	while (_head) {
 
-		Alarm *next = _head->_next;
+		Alarm *alarm = _head;
 
-		/* reset alarm object */
-		_head->_reset();
+		/* remove from heap */
+		_head = _merge_pairs(alarm->_child);
 
-		/* remove from list */
-		_head = next;
+		/* reset alarm object */
+		alarm->_reset();
 	}
 }
 
@@ -0,0 +1,73 @@
+#include <trace/policy.h>
+#include <trace/event_record.h>
+
+using namespace Genode;
+
+typedef Trace::Event_record Record;
+
+enum { MAX_EVENT_SIZE = 64 };
+
+size_t max_event_size()
+{
+	return MAX_EVENT_SIZE;
+}
+
+size_t rpc_call(char *dst, char const *rpc_name, Msgbuf_base const &)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::RPC_CALL, rpc_name, 0);
+}
+
+size_t rpc_returned(char *dst, char const *rpc_name, Msgbuf_base const &)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::RPC_RETURNED, rpc_name, 0);
+}
+
+size_t rpc_dispatch(char *dst, char const *rpc_name)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::RPC_DISPATCH, rpc_name, 0);
+}
+
+size_t rpc_reply(char *dst, char const *rpc_name)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::RPC_REPLY, rpc_name, 0);
+}
+
+size_t signal_submit(char *dst, unsigned const num)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::SIGNAL_SUBMIT, "", num);
+}
+
+size_t signal_receive(char *dst, Signal_context const &, unsigned num)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::SIGNAL_RECEIVE, "", num);
+}
+
+size_t lock_wait(char *dst, void const *lock, void const *holder)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::LOCK_WAIT, "", 0,
+	                     (addr_t)lock, (addr_t)holder);
+}
+
+size_t lock_acquired(char *dst, void const *lock)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::LOCK_ACQUIRED, "", 0,
+	                     (addr_t)lock);
+}
+
+size_t semaphore_block(char *dst, void const *semaphore)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::SEMAPHORE_BLOCK, "", 0,
+	                     (addr_t)semaphore);
+}
+
+size_t semaphore_woken(char *dst, void const *semaphore)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::SEMAPHORE_WOKEN, "", 0,
+	                     (addr_t)semaphore);
+}
+
+size_t region_map_fault(char *dst, addr_t addr, bool write)
+{
+	return Record::write(dst, MAX_EVENT_SIZE, Record::REGION_MAP_FAULT, "", write,
+	                     addr);
+}
@@ -0,0 +1,7 @@
+REQUIRES = bugfix_for_riscv_toolchain
+
+TARGET = event_record_policy
+
+TARGET_POLICY = event_record
+
+include $(PRG_DIR)/../policy.inc
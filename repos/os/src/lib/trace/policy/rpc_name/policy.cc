@@ -51,3 +51,28 @@ size_t signal_receive(char *dst, Signal_context const &, unsigned)
 {
 	return 0;
 }
+
+size_t lock_wait(char *dst, void const *, void const *)
+{
+	return 0;
+}
+
+size_t lock_acquired(char *dst, void const *)
+{
+	return 0;
+}
+
+size_t semaphore_block(char *dst, void const *)
+{
+	return 0;
+}
+
+size_t semaphore_woken(char *dst, void const *)
+{
+	return 0;
+}
+
+size_t region_map_fault(char *dst, addr_t, bool)
+{
+	return 0;
+}
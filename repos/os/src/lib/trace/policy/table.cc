@@ -24,6 +24,11 @@ extern "C" {
 		rpc_dispatch,
 		rpc_reply,
 		signal_submit,
-		signal_receive
+		signal_receive,
+		lock_wait,
+		lock_acquired,
+		semaphore_block,
+		semaphore_woken,
+		region_map_fault
 	};
 }
@@ -8,7 +8,7 @@
  */
 
 /*
- * Copyright (C) 2014 Genode Labs GmbH
+ * Copyright (C) 2014-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -24,6 +24,9 @@
 #include <util/list.h>
 #include <util/string.h>
 
+/* local includes */
+#include "stats.h"
+
 namespace Cache {
 
 	typedef Genode::uint64_t offset_t;
@@ -108,7 +111,16 @@ namespace Cache {
 		private:
 
 			char        _data[CHUNK_SIZE];
-			unsigned    _writes;
+			bool        _valid; /* content was read or written      */
+			bool        _dirty; /* content not yet written back      */
+
+			void _mark_dirty()
+			{
+				if (_dirty) return;
+
+				_dirty = true;
+				stats().dirty++;
+			}
 
 		public:
 
@@ -126,12 +138,12 @@ namespace Cache {
 			 * of 'Chunk_index'.
 			 */
 			Chunk(Genode::Allocator &, offset_t base_offset, Chunk_base *p)
-			: Chunk_base(base_offset, p), _writes(0) { }
+			: Chunk_base(base_offset, p), _valid(false), _dirty(false) { }
 
 			/**
 			 * Construct zero chunk
 			 */
-			Chunk() : _writes(0) { }
+			Chunk() : _valid(false), _dirty(false) { }
 
 			/**
 			 * Return number of used entries
@@ -142,6 +154,8 @@ namespace Cache {
 			 */
 			size_t used_size() const { return _num_entries; }
 
+			bool dirty() const { return _dirty; }
+
 			void write(char const *src, size_t len, offset_t seek_offset)
 			{
 				assert_valid_range(seek_offset, len, SIZE);
@@ -155,7 +169,31 @@ namespace Cache {
 
 				_num_entries = Genode::max(_num_entries, local_offset + len);
 
-				_writes++;
+				_valid = true;
+				_mark_dirty();
+			}
+
+			/**
+			 * Fill chunk with content read from the backend
+			 *
+			 * Content written by the client in the meantime is retained.
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset)
+			{
+				assert_valid_range(seek_offset, len, SIZE);
+
+				if (_valid)
+					return;
+
+				POLICY::write(this);
+
+				offset_t const local_offset = seek_offset - base_offset();
+
+				Genode::memcpy(&_data[local_offset], src, len);
+
+				_num_entries = Genode::max(_num_entries, local_offset + len);
+
+				_valid = true;
 			}
 
 			void read(char *dst, size_t len, offset_t seek_offset) const
@@ -171,15 +209,27 @@ namespace Cache {
 			{
 				assert_valid_range(seek_offset, len, SIZE);
 
-				if (_writes == 0)
+				if (!_valid)
 					throw Range_incomplete(base_offset(), SIZE);
 			}
 
 			void sync(size_t len, offset_t seek_offset)
 			{
-				if (_writes > 1) {
+				if (_dirty) {
 					POLICY::sync(this, (char*)_data);
-					_writes = 1;
+					_dirty = false;
+					stats().dirty--;
+				}
+			}
+
+			/**
+			 * Drop dirty state without writing back the content
+			 */
+			void clean(size_t len, offset_t seek_offset)
+			{
+				if (_dirty) {
+					_dirty = false;
+					stats().dirty--;
 				}
 			}
 
@@ -205,7 +255,7 @@ namespace Cache {
 
 			void free(size_t, offset_t)
 			{
-				if (_writes > 1) throw Dirty_chunk(_base_offset, SIZE);
+				if (_dirty) throw Dirty_chunk(_base_offset, SIZE);
 
 				_num_entries = 0;
 				if (_parent) _parent->free(SIZE, _base_offset);
@@ -393,6 +443,20 @@ namespace Cache {
 				}
 			};
 
+			struct Fill_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index &chunk, unsigned i) {
+					return chunk._alloc_entry(i); }
+
+				void operator () (Entry &entry, char const *src, size_t len,
+				                  offset_t seek_offset) const
+				{
+					entry.fill(src, len, seek_offset);
+				}
+			};
+
 			struct Read_func
 			{
 				typedef ENTRY_TYPE const Entry;
@@ -431,6 +495,20 @@ namespace Cache {
 				}
 			};
 
+			struct Clean_func
+			{
+				typedef ENTRY_TYPE Entry;
+
+				static Entry &lookup(Chunk_index const &chunk, unsigned i) {
+					return chunk._entry_for_syncing(i); }
+
+				void operator () (Entry &entry, char*, size_t len,
+				                  offset_t seek_offset) const
+				{
+					entry.clean(len, seek_offset);
+				}
+			};
+
 			void _init_entries()
 			{
 				for (unsigned i = 0; i < NUM_ENTRIES; i++)
@@ -499,6 +577,12 @@ namespace Cache {
 			void write(char const *src, size_t len, offset_t seek_offset) {
 				_range_op(*this, src, len, seek_offset, Write_func()); }
 
+			/**
+			 * Fill chunk with content read from the backend
+			 */
+			void fill(char const *src, size_t len, offset_t seek_offset) {
+				_range_op(*this, src, len, seek_offset, Fill_func()); }
+
 			/**
 			 * Allocate needed chunks
 			 */
@@ -524,6 +608,13 @@ namespace Cache {
 				if (zero()) return;
 				_range_op(*this, (char*)0, len, seek_offset, Sync_func()); }
 
+			/**
+			 * Drop dirty state of chunks without writing them back
+			 */
+			void clean(size_t len, offset_t seek_offset) const {
+				if (zero()) return;
+				_range_op(*this, (char*)0, len, seek_offset, Clean_func()); }
+
 			/**
 			 * Free chunks
 			 */
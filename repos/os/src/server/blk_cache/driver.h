@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2013 Genode Labs GmbH
+ * Copyright (C) 2013-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -18,6 +18,8 @@
 #include <os/server.h>
 
 #include "chunk.h"
+#include "read_ahead.h"
+#include "stats.h"
 
 /**
  * Cache driver used by the generic block driver framework
@@ -100,7 +102,32 @@ class Driver : public Block::Driver
 
 		enum {
 			SLAB_SZ = Block::Session::TX_QUEUE_SIZE*sizeof(Request),
-			CACHE_BLK_SIZE = 4096
+			CACHE_BLK_SIZE = 4096,
+
+			/* maximum size of a write-back request to the backend */
+			MAX_WRITE_BACK = 16*CACHE_BLK_SIZE,
+
+			/*
+			 * Maximum number of write-back requests in flight
+			 *
+			 * Along with the request being assembled, write backs occupy
+			 * at most a quarter of the TX buffer, which leaves space for
+			 * the requests of the client.
+			 */
+			MAX_WRITE_BACKS_IN_FLIGHT = 3,
+
+			/* maximum size of a single read-ahead request */
+			MAX_READ_AHEAD = 16*CACHE_BLK_SIZE,
+
+			/*
+			 * Upper bounds of the read-ahead configuration
+			 *
+			 * Read aheads occupy at most a quarter of the TX buffer. Along
+			 * with the write backs, at least half of the buffer remains
+			 * for the requests of the client.
+			 */
+			MAX_READ_AHEAD_WINDOW     = 512*1024,
+			MAX_READ_AHEADS_IN_FLIGHT = 4,
 		};
 
 		/**
@@ -128,6 +155,38 @@ class Driver : public Block::Driver
 		Genode::Signal_handler<Driver>    _source_submit;
 		Genode::Signal_handler<Driver>    _yield;
 
+		/*
+		 * Dirty chunks are written back in requests covering adjacent
+		 * chunks. The request being assembled is submitted when the next
+		 * dirty chunk is not adjacent, or when the synchronization of a
+		 * range is finished.
+		 */
+		struct Write_back
+		{
+			Block::Packet_descriptor packet;
+			Cache::offset_t          start  = 0;
+			Cache::size_t            size   = 0;
+			bool                     active = false;
+		} _wb;
+
+		/* write-back requests submitted but not yet acknowledged */
+		Block::Packet_descriptor _wb_in_flight[MAX_WRITE_BACKS_IN_FLIGHT];
+		unsigned                 _wb_in_flight_cnt = 0;
+
+		/* read-ahead requests submitted but not yet acknowledged */
+		Cache::Read_ahead        _ra;
+		Block::Packet_descriptor _ra_in_flight[MAX_READ_AHEADS_IN_FLIGHT];
+		unsigned                 _ra_in_flight_cnt = 0;
+
+		/* true while re-handling a request after a backend reply */
+		bool _replaying = false;
+
+		static Driver *&_instance()
+		{
+			static Driver *instance = nullptr;
+			return instance;
+		}
+
 		Driver(Driver const&);            /* singleton pattern */
 		Driver& operator=(Driver const&); /* singleton pattern */
 
@@ -158,8 +217,17 @@ class Driver : public Block::Driver
 		 */
 		inline void _handle_reply(Block::Packet_descriptor &srv, Request *r)
 		{
+			_replaying = true;
 			try {
-			if (r->cli.operation() == Block::Packet_descriptor::READ)
+			if (r->cli.operation() == Block::Packet_descriptor::TRIM) {
+
+				/* a trim waiting for a write back is issued now */
+				if (srv.operation() == Block::Packet_descriptor::TRIM)
+					ack_packet(r->cli, srv.succeeded());
+				else
+					trim(r->cli.block_number(), r->cli.block_count(), r->cli);
+			}
+			else if (r->cli.operation() == Block::Packet_descriptor::READ)
 				read(r->cli.block_number(), r->cli.block_count(),
 				     r->buffer, r->cli);
 			else
@@ -171,6 +239,7 @@ class Driver : public Block::Driver
 				                "srv (", r->srv.block_number(), " ",
 				                         r->srv.block_count(), ")");
 			}
+			_replaying = false;
 		}
 
 		/*
@@ -182,10 +251,19 @@ class Driver : public Block::Driver
 				Block::Packet_descriptor p = _blk.tx()->get_acked_packet();
 
 				/* when reading, write result into cache */
-				if (p.operation() == Block::Packet_descriptor::READ)
-					_cache.write(_blk.tx()->packet_content(p),
-					             p.block_count() * _blk_sz,
-					             p.block_number() * _blk_sz);
+				if (p.operation() == Block::Packet_descriptor::READ) {
+					_read_ahead_acked(p);
+					try {
+						_cache.fill(_blk.tx()->packet_content(p),
+						            p.block_count() * _blk_sz,
+						            p.block_number() * _blk_sz);
+					} catch(Request_congestion) {
+						/* no memory left, waiting requests read again */
+					}
+				}
+
+				if (p.operation() == Block::Packet_descriptor::WRITE)
+					_write_back_acked(p);
 
 				/* loop through the list of requests, and ack all related */
 				for (Request *r = _r_list.first(), *r_to_handle = r; r;
@@ -200,12 +278,74 @@ class Driver : public Block::Driver
 
 				_blk.tx()->release_packet(p);
 			}
+
+			_ready_to_submit();
 		}
 
 		/*
 		 * Handle that the backend device is ready to receive again
 		 */
-		void _ready_to_submit() { }
+		void _ready_to_submit()
+		{
+			/* submit write back that was assembled but not yet sent */
+			try { _submit_write_back(0); } catch(Write_failed) { }
+		}
+
+		/*
+		 * Defer client request that cannot be processed right now
+		 *
+		 * The session replays a rejected request only when another client
+		 * request is acknowledged. If the congestion is caused by write
+		 * backs or read aheads, there may be no such request. Hence, the
+		 * request is queued on a write back or read ahead in flight and
+		 * replayed once it is acknowledged.
+		 *
+		 * \throw Request_congestion  if neither is in flight
+		 */
+		void _defer(Block::Packet_descriptor &packet, char * const buffer)
+		{
+			Block::Packet_descriptor *p = _wb_in_flight_cnt ? &_wb_in_flight[0]
+			                            : _ra_in_flight_cnt ? &_ra_in_flight[0]
+			                            : nullptr;
+			if (!p)
+				throw Request_congestion();
+
+			_r_list.insert(new (&_r_slab) Request(*p, packet, buffer));
+		}
+
+		/*
+		 * Return read ahead in flight overlapping the given blocks, if any
+		 */
+		Block::Packet_descriptor *_read_ahead_in_flight(Block::sector_t nr,
+		                                                Genode::size_t  cnt)
+		{
+			for (unsigned i = 0; i < _ra_in_flight_cnt; i++) {
+				Block::Packet_descriptor &ra = _ra_in_flight[i];
+				if (nr < ra.block_number() + ra.block_count()
+				 && ra.block_number() < nr + cnt)
+					return &ra;
+			}
+			return nullptr;
+		}
+
+		/*
+		 * Return true if a read of the given blocks from the backend is in
+		 * flight
+		 */
+		bool _read_in_flight(Block::sector_t nr, Genode::size_t cnt)
+		{
+			if (_read_ahead_in_flight(nr, cnt))
+				return true;
+
+			for (Request *r = _r_list.first(); r; r = r->next()) {
+				Block::Packet_descriptor const &s = r->srv;
+				if (s.operation() == Block::Packet_descriptor::READ
+				 && nr < s.block_number() + s.block_count()
+				 && s.block_number() < nr + cnt)
+					return true;
+			}
+			return false;
+		}
 
 		/*
 		 * Setup a request to the backend device
@@ -222,6 +362,27 @@ class Driver : public Block::Driver
 			Block::Packet_descriptor p_to_dev;
 
 			try {
+				/* the backend must not return data older than written back */
+				_submit_write_back(block_number * _blk_sz);
+
+				/* wait for write backs of the requested blocks */
+				if (Block::Packet_descriptor *w =
+				    _write_back_in_flight(block_number, block_count)) {
+					_r_list.insert(new (&_r_slab) Request(*w, packet, buffer));
+					return;
+				}
+
+				/*
+				 * Wait for the first read ahead overlapping the requested
+				 * blocks, the replay waits for further ones or requests the
+				 * remainder
+				 */
+				if (Block::Packet_descriptor *ra =
+				    _read_ahead_in_flight(block_number, block_count)) {
+					_r_list.insert(new (&_r_slab) Request(*ra, packet, buffer));
+					return;
+				}
+
 				/* we've to look whether the request is already pending */
 				for (Request *r = _r_list.first(); r; r = r->next()) {
 					if (r->match(false, block_number, block_count)) {
@@ -237,7 +398,7 @@ class Driver : public Block::Driver
 					throw Request_congestion();
 				}
 
-				/* read ahead CACHE_BLK_SIZE */
+				/* read whole chunks, the read ahead follows in 'read' */
 				Block::sector_t nr = _cache_blk_round_off(block_number);
 				Genode::size_t cnt = _cache_blk_round_up(block_count +
 				                                         (block_number - nr));
@@ -254,6 +415,8 @@ class Driver : public Block::Driver
 				_blk.tx()->submit_packet(p_to_dev);
 			} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
 				throw Request_congestion();
+			} catch(Write_failed) {
+				throw Request_congestion();
 			} catch(Genode::Allocator::Out_of_memory) {
 				/* clean up */
 				_blk.tx()->release_packet(p_to_dev);
@@ -262,29 +425,212 @@ class Driver : public Block::Driver
 		}
 
 		/*
-		 * Synchronize dirty chunks with backend device
+		 * Read ahead of the client's read stream
+		 *
+		 * The requests are not bound to a client request. Their content is
+		 * filled into the cache when acknowledged. Chunks already cached are
+		 * not read again.
 		 */
-		void _sync()
+		void _read_ahead()
 		{
-			Cache::offset_t off = 0;
-			Cache::size_t len   = _blk_sz * _blk_cnt;
+			if (!_ra.due())
+				return;
+
+			/* the backend must not return data older than written back */
+			try { _submit_write_back(0); } catch(Write_failed) { return; }
 
-			while (len > 0) {
+			Cache::offset_t const dev_end = _blk_sz*_blk_cnt;
+			Cache::offset_t const limit   =
+				Genode::min(Genode::align_addr(_ra.limit(),
+				                               Genode::log2((int)CACHE_BLK_SIZE)),
+				            dev_end);
+			Cache::offset_t       pos     = _ra.start(CACHE_BLK_SIZE);
+
+			while (pos < limit
+			    && _ra_in_flight_cnt < _ra.config().max_requests
+			    && _blk.tx()->ready_to_submit()) {
+
+				/* the last chunk may exceed the end of the device */
+				Cache::size_t const size =
+					Genode::min(pos + MAX_READ_AHEAD, limit) - pos;
+
+				if (_write_back_in_flight(pos / _blk_sz, size / _blk_sz))
+					break;
+
+				try {
+					_cache.stat(size, pos);
+					pos += size;
+					continue;
+				} catch(Cache::Chunk_base::Range_incomplete) { }
+
+				Block::Packet_descriptor p;
 				try {
-					_cache.sync(len, off);
-					len = 0;
+					p = Block::Packet_descriptor(_blk.dma_alloc_packet(size),
+					                             Block::Packet_descriptor::READ,
+					                             pos / _blk_sz, size / _blk_sz);
+				} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+					break;
+				}
+
+				_blk.tx()->submit_packet(p);
+				_ra_in_flight[_ra_in_flight_cnt++] = p;
+
+				Cache::stats().read_aheads++;
+				Cache::stats().read_ahead_bytes += size;
+
+				pos += size;
+			}
+
+			_ra.issued(pos);
+		}
+
+		void _read_ahead_acked(Block::Packet_descriptor &p)
+		{
+			for (unsigned i = 0; i < _ra_in_flight_cnt; i++) {
+				if (_ra_in_flight[i].offset() != p.offset())
+					continue;
+
+				_ra_in_flight[i] = _ra_in_flight[--_ra_in_flight_cnt];
+				break;
+			}
+		}
+
+		/*
+		 * Append chunk to the write-back request being assembled
+		 *
+		 * \throw Write_failed
+		 */
+		void _write_back(Cache::offset_t off, char const *data)
+		{
+			if (_wb.active && (off != _wb.start + _wb.size
+			                || _wb.size == MAX_WRITE_BACK))
+				_submit_write_back(off);
+
+			if (!_wb.active) {
+				try {
+					_wb.packet = _blk.dma_alloc_packet(MAX_WRITE_BACK);
+				} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
+					throw Write_failed(off);
+				}
+				_wb.start  = off;
+				_wb.size   = 0;
+				_wb.active = true;
+			}
+
+			/* the last chunk may exceed the end of the device */
+			Cache::size_t const size =
+				Genode::min((Cache::size_t)CACHE_BLK_SIZE,
+				            (Cache::size_t)_blk_sz*_blk_cnt - off);
+
+			Genode::memcpy(_blk.tx()->packet_content(_wb.packet) + _wb.size,
+			               data, size);
+			_wb.size += size;
+		}
+
+		/*
+		 * Submit the write-back request being assembled
+		 *
+		 * \param off  offset reported when the request cannot be submitted
+		 *
+		 * \throw Write_failed
+		 */
+		void _submit_write_back(Cache::offset_t off)
+		{
+			if (!_wb.active)
+				return;
+
+			if (_wb_in_flight_cnt == MAX_WRITE_BACKS_IN_FLIGHT
+			 || !_blk.tx()->ready_to_submit())
+				throw Write_failed(off);
+
+			Block::Packet_descriptor p(_wb.packet,
+			                           Block::Packet_descriptor::WRITE,
+			                           _wb.start / _blk_sz, _wb.size / _blk_sz);
+			_blk.tx()->submit_packet(p);
+
+			_wb_in_flight[_wb_in_flight_cnt++] = p;
+			_wb.active = false;
+
+			Cache::stats().write_backs++;
+			Cache::stats().written_bytes += _wb.size;
+		}
+
+		/*
+		 * Return write back in flight overlapping the given blocks, if any
+		 */
+		Block::Packet_descriptor *_write_back_in_flight(Block::sector_t nr,
+		                                                Genode::size_t  cnt)
+		{
+			for (unsigned i = 0; i < _wb_in_flight_cnt; i++) {
+				Block::Packet_descriptor &w = _wb_in_flight[i];
+				if (nr < w.block_number() + w.block_count()
+				 && w.block_number() < nr + cnt)
+					return &w;
+			}
+			return nullptr;
+		}
+
+		void _write_back_acked(Block::Packet_descriptor &p)
+		{
+			if (!p.succeeded())
+				Genode::error("write back of blocks ", p.block_number(), "-",
+				              p.block_number() + p.block_count() - 1,
+				              " failed");
+
+			for (unsigned i = 0; i < _wb_in_flight_cnt; i++) {
+				if (_wb_in_flight[i].offset() != p.offset())
+					continue;
+
+				_wb_in_flight[i] = _wb_in_flight[--_wb_in_flight_cnt];
+				break;
+			}
+		}
+
+		/*
+		 * Write back dirty chunks of the given range
+		 *
+		 * \param wait  if true, wait until the backend is ready to take
+		 *              all write-back requests, otherwise give up
+		 *
+		 * \return true if all dirty chunks of the range were written back
+		 */
+		bool _sync(Cache::offset_t off, Cache::size_t len, bool wait)
+		{
+			Cache::offset_t const end = off + len;
+
+			for (;;) {
+				try {
+					_cache.sync(end - off, off);
+					_submit_write_back(end);
+					return true;
 				} catch(Write_failed &e) {
+					if (!wait)
+						return false;
+
 					/**
 					 * Write to backend failed when backend device isn't ready
 					 * to proceed, so handle signals, until it's ready again
 					 */
-					off = e.off;
-					len = _blk_sz * _blk_cnt - off;
+					off = Genode::min(e.off, end);
 					_env.ep().wait_and_dispatch_one_signal();
 				}
 			}
 		}
 
+		/*
+		 * Synchronize dirty chunks with backend device
+		 */
+		void _sync()
+		{
+			_sync(0, _blk_sz * _blk_cnt, true);
+
+			/* wait until the backend acknowledged all write backs */
+			while (_wb_in_flight_cnt)
+				_env.ep().wait_and_dispatch_one_signal();
+
+			_blk.sync();
+		}
+
 		/*
 		 * Check for chunk availability
 		 *
@@ -331,9 +677,12 @@ class Driver : public Block::Driver
 		/*
 		 * Constructor
 		 *
-		 * \param ep  server entrypoint
+		 * \param env        environment of the component
+		 * \param heap       backing store of the cache
+		 * \param ra_config  bounds of the read ahead
 		 */
-		Driver(Genode::Env &env, Genode::Heap &heap)
+		Driver(Genode::Env &env, Genode::Heap &heap,
+		       Cache::Read_ahead::Config const &ra_config)
 		: _env(env),
 		  _r_slab(&heap),
 		  _alloc(&heap, CACHE_BLK_SIZE),
@@ -343,7 +692,12 @@ class Driver : public Block::Driver
 		  _cache(heap, 0),
 		  _source_ack(env.ep(), *this, &Driver::_ack_avail),
 		  _source_submit(env.ep(), *this, &Driver::_ready_to_submit),
-		  _yield(env.ep(), *this, &Driver::_parent_yield)
+		  _yield(env.ep(), *this, &Driver::_parent_yield),
+		  _ra(Cache::Read_ahead::Config {
+		      Genode::min(ra_config.max_window,
+		                  (Cache::size_t)MAX_READ_AHEAD_WINDOW),
+		      Genode::min(ra_config.max_requests,
+		                  (unsigned)MAX_READ_AHEADS_IN_FLIGHT) })
 		{
 			using namespace Genode;
 
@@ -360,6 +714,8 @@ class Driver : public Block::Driver
 
 			/* truncate chunk structure to real size of the device */
 			_cache.truncate(_blk_sz*_blk_cnt);
+
+			_instance() = this;
 		}
 
 		~Driver()
@@ -367,6 +723,43 @@ class Driver : public Block::Driver
 			/* when session gets closed, synchronize and flush the cache */
 			_sync();
 			POLICY::flush();
+
+			_instance() = nullptr;
+		}
+
+		/**
+		 * Write back chunk, called by the policy before evicting it
+		 *
+		 * Adjacent dirty chunks are written back along with the chunk.
+		 * A chunk is kept while a read from the backend covering it is in
+		 * flight. Otherwise, the read would fill the evicted chunk with
+		 * content older than the one written by the client.
+		 *
+		 * \return true if the chunk is clean and can be freed
+		 */
+		static bool write_back(Chunk_level_4 &chunk)
+		{
+			Driver *driver = _instance();
+
+			if (driver && driver->_read_in_flight(
+			              chunk.base_offset() / driver->_blk_sz,
+			              CACHE_BLK_SIZE / driver->_blk_sz))
+				return false;
+
+			if (!chunk.dirty())
+				return true;
+
+			if (!driver)
+				return false;
+
+			Cache::offset_t const dev_size = driver->_blk_sz*driver->_blk_cnt;
+			Cache::offset_t const start    = chunk.base_offset()
+			                               - chunk.base_offset() % MAX_WRITE_BACK;
+
+			driver->_sync(start, Genode::min((Cache::offset_t)MAX_WRITE_BACK,
+			                                 dev_size - start), false);
+
+			return !chunk.dirty();
 		}
 
 		Block::Session_client* blk()    { return &_blk;   }
@@ -389,7 +782,22 @@ class Driver : public Block::Driver
 			if (!_ops.supported(Block::Packet_descriptor::READ))
 				throw Io_error();
 
-			if (!_stat(block_number, block_count, buffer, packet))
+			bool hit = false;
+			try {
+				hit = _stat(block_number, block_count, buffer, packet);
+			} catch(Request_congestion) {
+				_defer(packet, buffer);
+			}
+
+			if (!_replaying) {
+				(hit ? Cache::stats().hits : Cache::stats().misses)++;
+
+				_ra.access(block_number*_blk_sz, block_count*_blk_sz,
+				           CACHE_BLK_SIZE);
+				_read_ahead();
+			}
+
+			if (!hit)
 				return;
 
 			_cache.read(buffer, block_count*_blk_sz, block_number*_blk_sz);
@@ -404,15 +812,27 @@ class Driver : public Block::Driver
 			if (!_ops.supported(Block::Packet_descriptor::WRITE))
 				throw Io_error();
 
-			_cache.alloc(block_count * _blk_sz, block_number * _blk_sz);
+			char * const buf = const_cast<char * const>(buffer);
 
-			if ((block_number % _cache_blk_mod()) &&
-			    !_stat(block_number, 1, const_cast<char* const>(buffer), packet))
-				return;
+			bool hit = false;
+			try {
+				_cache.alloc(block_count * _blk_sz, block_number * _blk_sz);
+
+				/* partially written chunks must be read from the backend */
+				hit = (!(block_number % _cache_blk_mod()) ||
+				       _stat(block_number, 1, buf, packet))
+				      &&
+				      (!((block_number+block_count) % _cache_blk_mod()) ||
+				       _stat(block_number+block_count-1, 1, buf, packet));
+
+			} catch(Request_congestion) {
+				_defer(packet, buf);
+			}
+
+			if (!_replaying)
+				(hit ? Cache::stats().hits : Cache::stats().misses)++;
 
-			if (((block_number+block_count) % _cache_blk_mod())
-				&& !_stat(block_number+block_count-1, 1,
-				          const_cast<char* const>(buffer), packet))
+			if (!hit)
 				return;
 
 			_cache.write(buffer, block_count * _blk_sz,
@@ -420,5 +840,73 @@ class Driver : public Block::Driver
 			ack_packet(packet);
 		}
 
+		/*
+		 * The trim request is passed to the backend device. A later write
+		 * back of a dirty chunk would undo the trim. Hence, dirty chunks
+		 * completely covered by the trimmed range are cleaned without
+		 * being written back. Partially covered dirty chunks are written
+		 * back, and the trim is issued after all write backs of the range
+		 * are acknowledged. Cached chunks keep their content, which is
+		 * valid for trimmed blocks too.
+		 */
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet)
+		{
+			if (!_ops.supported(Block::Packet_descriptor::TRIM))
+				throw Io_error();
+
+			Cache::offset_t const off = block_number * _blk_sz;
+			Cache::offset_t const end = off + block_count * _blk_sz;
+
+			/* chunks completely within the range, the last may be partial */
+			Cache::offset_t const inner_off =
+				Genode::align_addr(off, Genode::log2((int)CACHE_BLK_SIZE));
+			Cache::offset_t const inner_end = end - end % CACHE_BLK_SIZE;
+
+			if (inner_off < inner_end)
+				_cache.clean(inner_end - inner_off, inner_off);
+
+			/* write back the remaining dirty chunks of the range */
+			if (!_sync(off, end - off, false)) {
+				_defer(packet, nullptr);
+				return;
+			}
+
+			/* wait for write backs of the range */
+			if (Block::Packet_descriptor *w =
+			    _write_back_in_flight(block_number, block_count)) {
+				_r_list.insert(new (&_r_slab) Request(*w, packet, nullptr));
+				return;
+			}
+
+			if (!_blk.tx()->ready_to_submit()) {
+				_defer(packet, nullptr);
+				return;
+			}
+
+			Block::Packet_descriptor p_to_dev(Block::Packet_descriptor(),
+			                                  Block::Packet_descriptor::TRIM,
+			                                  block_number, block_count);
+			_r_list.insert(new (&_r_slab) Request(p_to_dev, packet, nullptr));
+			_blk.tx()->submit_packet(p_to_dev);
+		}
+
 		void sync() { _sync(); }
 };
+
+
+/**
+ * Synchronize a chunk with the backend device
+ */
+template <typename POLICY>
+void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *src)
+{
+	Cache::offset_t off =
+		static_cast<const Driver<POLICY>::Chunk_level_4*>(e)->base_offset();
+
+	Driver *driver = _instance();
+	if (!driver) throw Write_failed(off);
+
+	driver->_write_back(off, src);
+}
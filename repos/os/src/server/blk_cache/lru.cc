@@ -5,29 +5,30 @@
  */
 
 /*
- * Copyright (C) 2013 Genode Labs GmbH
+ * Copyright (C) 2013-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
  */
-#include <base/printf.h>
 #include "lru.h"
 #include "driver.h"
 
 typedef Driver<Lru_policy>::Chunk_level_4 Chunk;
 
-static const Lru_policy::Element        *lru = 0;
-static Genode::List<Lru_policy::Element> lru_list;
+static Cache::Policy_queue lru_queue(1);
 
 
-static void lru_access(const Lru_policy::Element *e)
+static void lru_access(const Lru_policy::Element *elem)
 {
-	if (e == lru) return;
+	Lru_policy::Element &e = *const_cast<Lru_policy::Element*>(elem);
 
-	if (e->next()) lru_list.remove(e);
+	if (lru_queue.contains(e)) {
+		lru_queue.move_to_head(e);
+		return;
+	}
 
-	lru_list.insert(e, lru);
-	lru = e;
+	lru_queue.insert_head(e);
+	Cache::stats().chunks++;
 }
 
 
@@ -42,21 +43,24 @@ void Lru_policy::write(const Lru_policy::Element *e) {
 void Lru_policy::flush(Cache::size_t size)
 {
 	Cache::size_t s = 0;
-	for (Lru_policy::Element *e = lru_list.first();
-		 e && ((size == 0) || (s < size));
-		 e = lru_list.first(), s += sizeof(Chunk)) {
+
+	/* walk from the least recently used chunk, skip the ones still dirty */
+	for (Lru_policy::Element *e = lru_queue.tail();
+	     e && ((size == 0) || (s < size)); ) {
+
 		Chunk *cb = static_cast<Chunk*>(e);
-		e = e->next();
-		try {
-			cb->free(Driver<Lru_policy>::CACHE_BLK_SIZE,
-			         cb->base_offset());
-			lru_list.remove(cb);
-		} catch(Chunk::Dirty_chunk &e) {
-			cb->sync(e.size, e.off);
-		}
-	}
+		e = e->prev();
 
-	if (!lru_list.first()) lru = 0;
+		if (!Driver<Lru_policy>::write_back(*cb))
+			continue;
+
+		lru_queue.remove(*cb);
+		Cache::stats().chunks--;
+		Cache::stats().evictions++;
+
+		cb->free(Driver<Lru_policy>::CACHE_BLK_SIZE, cb->base_offset());
+		s += sizeof(Chunk);
+	}
 
 	if (s < size) throw Block::Driver::Request_congestion();
 }
@@ -5,19 +5,20 @@
  */
 
 /*
- * Copyright (C) 2013 Genode Labs GmbH
+ * Copyright (C) 2013-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
  */
 
-#include <util/list.h>
-
 #include "chunk.h"
+#include "policy_queue.h"
 
 struct Lru_policy
 {
-	class Element : public Genode::List<Element>::Element {};
+	typedef Cache::Policy_element Element;
+
+	static char const *name() { return "lru"; }
 
 	static void read(const Element  *e);
 	static void write(const Element *e);
@@ -12,70 +12,116 @@
  */
 
 #include <base/component.h>
+#include <os/attached_rom_dataspace.h>
+#include <os/reporter.h>
+#include <timer_session/connection.h>
 
 #include "lru.h"
+#include "two_queue.h"
 #include "driver.h"
 
-using Policy = Lru_policy;
-static Driver<Policy> * driver = nullptr;
-
-
-/**
- * Synchronize a chunk with the backend device
- */
-template <typename POLICY>
-void Driver<POLICY>::Policy::sync(const typename POLICY::Element *e, char *dst)
-{
-	Cache::offset_t off =
-		static_cast<const Driver<POLICY>::Chunk_level_4*>(e)->base_offset();
-
-	if (!driver) throw Write_failed(off);
-
-	if (!driver->blk()->tx()->ready_to_submit())
-		throw Write_failed(off);
-	try {
-		Block::Packet_descriptor
-			p(driver->blk()->dma_alloc_packet(Driver::CACHE_BLK_SIZE),
-		      Block::Packet_descriptor::WRITE, off / driver->blk_sz(),
-		      Driver::CACHE_BLK_SIZE / driver->blk_sz());
-		driver->blk()->tx()->submit_packet(p);
-	} catch(Block::Session::Tx::Source::Packet_alloc_failed) {
-		throw Write_failed(off);
-	}
-}
-
 
 struct Main
 {
 	template <typename T>
 	struct Factory : Block::Driver_factory
 	{
-		Genode::Env  &env;
-		Genode::Heap &heap;
+		Genode::Env                     &env;
+		Genode::Heap                    &heap;
+		Cache::Read_ahead::Config const &ra_config;
 
-		Factory(Genode::Env &env, Genode::Heap &heap) : env(env), heap(heap) {}
+		Factory(Genode::Env &env, Genode::Heap &heap,
+		        Cache::Read_ahead::Config const &ra_config)
+		: env(env), heap(heap), ra_config(ra_config) {}
 
-		Block::Driver *create()
-		{
-			driver = new (&heap) ::Driver<T>(env, heap);
-			return driver;
-		}
+		Block::Driver *create() {
+			return new (&heap) ::Driver<T>(env, heap, ra_config); }
 
 		void destroy(Block::Driver *driver) {
 			Genode::destroy(&heap, static_cast<::Driver<T>*>(driver)); }
 	};
 
+	struct Config
+	{
+		typedef Genode::String<8> Policy_name;
+
+		Policy_name policy { Lru_policy::name() };
+		bool        report      = false;
+		unsigned    interval_ms = 1000;
+
+		Cache::Read_ahead::Config read_ahead { 256*1024, 4 };
+
+		Config(Genode::Env &env)
+		{
+			try {
+				Genode::Attached_rom_dataspace rom(env, "config");
+				Genode::Xml_node node = rom.xml();
+
+				policy      = node.attribute_value("policy", policy);
+				report      = node.attribute_value("report", report);
+				interval_ms = node.attribute_value("report_interval_ms",
+				                                   interval_ms);
+
+				Genode::Number_of_bytes const max_window(read_ahead.max_window);
+				read_ahead.max_window =
+					node.attribute_value("read_ahead_max", max_window);
+				read_ahead.max_requests =
+					node.attribute_value("read_ahead_requests",
+					                     read_ahead.max_requests);
+			} catch (...) { }
+		}
+	};
+
 	void resource_handler() { }
 
 	Genode::Env                 &env;
 	Genode::Heap                 heap    { env.ram(), env.rm()     };
-	Factory<Lru_policy>          factory { env, heap               };
-	Block::Root                  root    { env.ep(), heap, factory };
+	Config                       config  { env                     };
+	Factory<Lru_policy>          lru     { env, heap, config.read_ahead };
+	Factory<Two_queue_policy>    two_q   { env, heap, config.read_ahead };
+
+	bool const two_q_selected =
+		config.policy == Config::Policy_name(Two_queue_policy::name());
+
+	Block::Root                  root    { env.ep(), heap,
+	                                       two_q_selected
+	                                       ? (Block::Driver_factory &)two_q
+	                                       : (Block::Driver_factory &)lru };
 	Genode::Signal_handler<Main> resource_dispatcher {
 		env.ep(), *this, &Main::resource_handler };
 
+	/*
+	 * Statistics report, updated periodically if enabled
+	 */
+	Genode::Lazy_volatile_object<Timer::Connection> timer;
+	Genode::Reporter reporter { "blk_cache", "blk_cache" };
+
+	void report_handler()
+	{
+		Genode::Reporter::Xml_generator xml(reporter, [&] () {
+			xml.attribute("policy", two_q_selected ? Two_queue_policy::name()
+			                                       : Lru_policy::name());
+			Cache::stats().report(xml);
+		});
+	}
+
+	Genode::Signal_handler<Main> report_dispatcher {
+		env.ep(), *this, &Main::report_handler };
+
 	Main(Genode::Env &env) : env(env)
 	{
+		if (!two_q_selected
+		 && config.policy != Config::Policy_name(Lru_policy::name()))
+			Genode::warning("unknown policy \"", config.policy, "\", using ",
+			                Lru_policy::name());
+
+		if (config.report) {
+			reporter.enabled(true);
+			timer.construct(env);
+			timer->sigh(report_dispatcher);
+			timer->trigger_periodic(config.interval_ms*1000);
+		}
+
 		env.parent().announce(env.ep().manage(root));
 		env.parent().resource_avail_sigh(resource_dispatcher);
 	}
@@ -0,0 +1,108 @@
+/*
+ * \brief  Queue of cache chunks used by the replacement policies
+ * \author Genode Labs
+ * \date   2016-09-12
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _POLICY_QUEUE_H_
+#define _POLICY_QUEUE_H_
+
+namespace Cache {
+
+	class Policy_element;
+	class Policy_queue;
+}
+
+
+/**
+ * Queue membership of a chunk
+ *
+ * The replacement policies move chunks between queues on each access.
+ * Hence, the queues are doubly linked to remove elements in constant time.
+ */
+class Cache::Policy_element
+{
+	private:
+
+		friend class Policy_queue;
+
+		Policy_element *_prev  = nullptr;
+		Policy_element *_next  = nullptr;
+		unsigned        _queue = 0;      /* id of queue, 0 if not queued */
+
+	public:
+
+		unsigned queue() const { return _queue; }
+
+		Policy_element *prev() const { return _prev; }
+};
+
+
+class Cache::Policy_queue
+{
+	private:
+
+		unsigned const  _id;
+		Policy_element *_head  = nullptr; /* most recently inserted */
+		Policy_element *_tail  = nullptr; /* least recently inserted */
+		unsigned long   _count = 0;
+
+	public:
+
+		/**
+		 * Constructor
+		 *
+		 * \param id  non-zero id stored in the queued elements
+		 */
+		Policy_queue(unsigned id) : _id(id) { }
+
+		unsigned long count() const { return _count; }
+
+		bool contains(Policy_element const &e) const { return e._queue == _id; }
+
+		Policy_element *tail() const { return _tail; }
+
+		void insert_head(Policy_element &e)
+		{
+			e._queue = _id;
+			e._prev  = nullptr;
+			e._next  = _head;
+
+			if (_head) _head->_prev = &e;
+			else       _tail        = &e;
+
+			_head = &e;
+			_count++;
+		}
+
+		void remove(Policy_element &e)
+		{
+			if (e._prev) e._prev->_next = e._next;
+			else         _head          = e._next;
+
+			if (e._next) e._next->_prev = e._prev;
+			else         _tail          = e._prev;
+
+			e._prev  = e._next = nullptr;
+			e._queue = 0;
+			_count--;
+		}
+
+		void move_to_head(Policy_element &e)
+		{
+			if (_head == &e)
+				return;
+
+			remove(e);
+			insert_head(e);
+		}
+};
+
+#endif /* _POLICY_QUEUE_H_ */
@@ -0,0 +1,94 @@
+/*
+ * \brief  Detection of sequential reads for the read-ahead of the cache
+ * \author Genode Labs
+ * \date   2016-09-14
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _READ_AHEAD_H_
+#define _READ_AHEAD_H_
+
+#include <util/misc_math.h>
+
+#include "chunk.h"
+
+namespace Cache { class Read_ahead; }
+
+
+/**
+ * Read-ahead window of the client's read stream
+ *
+ * Each read that continues the previous one doubles the window, up to the
+ * configured maximum. Any other read closes the window. The driver reads
+ * the window ahead of the stream once less than half of it is left.
+ */
+class Cache::Read_ahead
+{
+	public:
+
+		struct Config
+		{
+			size_t   max_window;   /* upper bound of the window in bytes  */
+			unsigned max_requests; /* read-ahead requests in flight       */
+		};
+
+	private:
+
+		Config const _config;
+
+		offset_t _next   = 0; /* end of the last read of the client     */
+		size_t   _window = 0; /* current size of the window in bytes    */
+		offset_t _end    = 0; /* end of the read ahead issued so far    */
+
+	public:
+
+		Read_ahead(Config const &config) : _config(config) { }
+
+		Config const &config() const { return _config; }
+
+		/**
+		 * Account read of the client
+		 */
+		void access(offset_t off, size_t len, size_t chunk_size)
+		{
+			if (off == _next && _config.max_window)
+				_window = Genode::min(_window ? _window*2 : 2*chunk_size,
+				                      _config.max_window);
+			else {
+				_window = 0;
+				_end    = 0;
+			}
+
+			_next = off + len;
+		}
+
+		/**
+		 * Return true if the window should be refilled
+		 */
+		bool due() const { return _window && _end < _next + _window/2; }
+
+		/**
+		 * Offset where to continue the read ahead
+		 */
+		offset_t start(size_t chunk_size) const {
+			return Genode::max(_end, Genode::align_addr(_next,
+			                         Genode::log2(chunk_size))); }
+
+		/**
+		 * End of the window
+		 */
+		offset_t limit() const { return _next + _window; }
+
+		/**
+		 * Record the end of the read ahead issued
+		 */
+		void issued(offset_t end) { _end = Genode::max(_end, end); }
+};
+
+#endif /* _READ_AHEAD_H_ */
@@ -0,0 +1,65 @@
+/*
+ * \brief  Statistics of the block cache
+ * \author Genode Labs
+ * \date   2016-09-12
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+#include <base/stdint.h>
+#include <util/xml_generator.h>
+
+namespace Cache {
+
+	struct Stats;
+
+	inline Stats &stats();
+}
+
+
+struct Cache::Stats
+{
+	typedef Genode::uint64_t uint64_t;
+
+	uint64_t hits          = 0; /* requests served from the cache        */
+	uint64_t misses        = 0; /* requests that needed the backend      */
+	uint64_t evictions     = 0; /* chunks dropped by the policy          */
+	uint64_t ghost_hits    = 0; /* re-accesses of recently evicted chunks */
+	uint64_t chunks        = 0; /* chunks tracked by the policy          */
+	uint64_t dirty         = 0; /* chunks not yet written back           */
+	uint64_t write_backs   = 0; /* write requests to the backend         */
+	uint64_t written_bytes = 0; /* bytes written back                    */
+	uint64_t read_aheads      = 0; /* read-ahead requests to the backend */
+	uint64_t read_ahead_bytes = 0; /* bytes read ahead                   */
+
+	void report(Genode::Xml_generator &xml) const
+	{
+		xml.attribute("hits",          hits);
+		xml.attribute("misses",        misses);
+		xml.attribute("evictions",     evictions);
+		xml.attribute("ghost_hits",    ghost_hits);
+		xml.attribute("chunks",        chunks);
+		xml.attribute("dirty",         dirty);
+		xml.attribute("write_backs",   write_backs);
+		xml.attribute("written_bytes", written_bytes);
+		xml.attribute("read_aheads",      read_aheads);
+		xml.attribute("read_ahead_bytes", read_ahead_bytes);
+	}
+};
+
+
+Cache::Stats &Cache::stats()
+{
+	static Stats s;
+	return s;
+}
+
+#endif /* _STATS_H_ */
@@ -0,0 +1,121 @@
+/*
+ * \brief  2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2016-09-12
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#include "two_queue.h"
+#include "driver.h"
+
+typedef Driver<Two_queue_policy>::Chunk_level_4 Chunk;
+
+enum {
+	KIN_PERCENT = 25,   /* share of chunks held in A1in before eviction */
+	GHOST_SLOTS = 4096, /* number of remembered offsets of A1in victims */
+};
+
+static Cache::Policy_queue a1in(1); /* chunks accessed once, FIFO */
+static Cache::Policy_queue am(2);   /* chunks accessed again, LRU */
+
+
+/*
+ * Offsets of chunks recently evicted from A1in (A1out)
+ *
+ * The table is direct mapped, so a new entry may replace an older one
+ * before its time. This merely weakens the promotion of the older chunk.
+ */
+static Cache::offset_t ghosts[GHOST_SLOTS];
+
+static Cache::offset_t *ghost_slot(Cache::offset_t off)
+{
+	Cache::offset_t const chunk = off / Driver<Two_queue_policy>::CACHE_BLK_SIZE;
+	return &ghosts[chunk % GHOST_SLOTS];
+}
+
+/* entries are stored incremented by one, so zero denotes an empty slot */
+static void ghost_insert(Cache::offset_t off) { *ghost_slot(off) = off + 1; }
+
+static bool ghost_remove(Cache::offset_t off)
+{
+	Cache::offset_t *slot = ghost_slot(off);
+	if (*slot != off + 1)
+		return false;
+
+	*slot = 0;
+	return true;
+}
+
+
+static void two_queue_access(const Two_queue_policy::Element *elem)
+{
+	Two_queue_policy::Element &e = *const_cast<Two_queue_policy::Element*>(elem);
+
+	if (am.contains(e)) {
+		am.move_to_head(e);
+		return;
+	}
+
+	/* correlated re-accesses of chunks in A1in don't count */
+	if (a1in.contains(e))
+		return;
+
+	Cache::stats().chunks++;
+
+	if (ghost_remove(static_cast<Chunk&>(e).base_offset())) {
+		Cache::stats().ghost_hits++;
+		am.insert_head(e);
+	} else
+		a1in.insert_head(e);
+}
+
+
+void Two_queue_policy::read(const Two_queue_policy::Element  *e) {
+	two_queue_access(e); }
+
+
+void Two_queue_policy::write(const Two_queue_policy::Element *e) {
+	two_queue_access(e); }
+
+
+void Two_queue_policy::flush(Cache::size_t size)
+{
+	Cache::size_t s = 0;
+
+	/* candidates of both queues, dirty chunks are skipped */
+	Two_queue_policy::Element *in = a1in.tail();
+	Two_queue_policy::Element *m  = am.tail();
+
+	while ((in || m) && ((size == 0) || (s < size))) {
+
+		unsigned long const total = a1in.count() + am.count();
+		bool const from_in = in && (!m || a1in.count()*100 > total*KIN_PERCENT);
+
+		Two_queue_policy::Element *&e = from_in ? in : m;
+		Chunk *cb = static_cast<Chunk*>(e);
+		e = e->prev();
+
+		if (!Driver<Two_queue_policy>::write_back(*cb))
+			continue;
+
+		if (from_in) {
+			a1in.remove(*cb);
+			ghost_insert(cb->base_offset());
+		} else
+			am.remove(*cb);
+
+		Cache::stats().chunks--;
+		Cache::stats().evictions++;
+
+		cb->free(Driver<Two_queue_policy>::CACHE_BLK_SIZE, cb->base_offset());
+		s += sizeof(Chunk);
+	}
+
+	if (s < size) throw Block::Driver::Request_congestion();
+}
@@ -0,0 +1,34 @@
+/*
+ * \brief  2Q cache replacement strategy
+ * \author Genode Labs
+ * \date   2016-09-12
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#include "chunk.h"
+#include "policy_queue.h"
+
+/**
+ * Scan-resistant replacement policy
+ *
+ * Chunks accessed for the first time enter a FIFO queue (A1in). Only
+ * chunks accessed again shortly after their eviction from that queue are
+ * promoted to the LRU queue (Am). Hence, a single pass over a large range
+ * of the device evicts nothing but the chunks of the pass itself.
+ */
+struct Two_queue_policy
+{
+	typedef Cache::Policy_element Element;
+
+	static char const *name() { return "2q"; }
+
+	static void read(const Element  *e);
+	static void write(const Element *e);
+	static void flush(Cache::size_t size = 0);
+};
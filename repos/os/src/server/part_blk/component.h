@@ -48,6 +48,9 @@ class Block::Session_component : public Block::Session_rpc_object,
 		unsigned                          _p_in_fly;
 		Block::Driver                    &_driver;
 
+		/* translated range table of the current multi-range request */
+		Range _ranges[Packet_descriptor::MAX_RANGES];
+
 		/**
 		 * Acknowledge a packet already handled
 		 */
@@ -66,6 +69,45 @@ class Block::Session_component : public Block::Session_rpc_object,
 		inline bool _range_check(Packet_descriptor &p) {
 			return p.block_number() + p.block_count() <= _partition->sectors; }
 
+		/**
+		 * Translate the range table of a multi-range request to the device
+		 *
+		 * \return number of ranges, or 0 if the request is invalid
+		 */
+		unsigned _translate_ranges(Packet_descriptor &p, Range *ranges)
+		{
+			unsigned const num = p.range_count();
+			Range const *table = (Range const *)tx_sink()->packet_content(p);
+
+			if (!table || num > Packet_descriptor::MAX_RANGES
+			 || p.size() < Packet_descriptor::RANGE_TABLE_SIZE
+			 || !_driver.ops().multi_range())
+				return 0;
+
+			Genode::uint64_t blocks = 0;
+			for (unsigned i = 0; i < num; i++) {
+				Range const r = table[i];
+				if (!r.block_count || r.block_number >= _partition->sectors
+				 || r.block_count > _partition->sectors - r.block_number)
+					return 0;
+
+				ranges[i].block_number = r.block_number + _partition->lba;
+				ranges[i].block_count  = r.block_count;
+				blocks += r.block_count;
+			}
+
+			/* the block count of the request is used when dispatching */
+			if (blocks != p.block_count())
+				return 0;
+
+			if (p.operation() != Packet_descriptor::TRIM
+			 && blocks > (p.size() - Packet_descriptor::RANGE_TABLE_SIZE)
+			             / _driver.blk_size())
+				return 0;
+
+			return num;
+		}
+
 		/**
 		 * Handle a single request
 		 */
@@ -74,18 +116,30 @@ class Block::Session_component : public Block::Session_rpc_object,
 			_p_to_handle = packet;
 			_p_to_handle.succeeded(false);
 
+			Packet_descriptor::Opcode const op = _p_to_handle.operation();
+			bool const payload = op != Packet_descriptor::TRIM;
+
+			unsigned num = 0;
+
 			/* ignore invalid packets */
-			if (!packet.size() || !_range_check(_p_to_handle)) {
+			if ((payload && !packet.size())
+			 || (packet.multi_range() ? !(num = _translate_ranges(packet, _ranges))
+			                          : !_range_check(_p_to_handle))) {
 				_ack_packet(_p_to_handle);
 				return;
 			}
 
-			bool write   = _p_to_handle.operation() == Packet_descriptor::WRITE;
 			sector_t off = _p_to_handle.block_number() + _partition->lba;
 			size_t cnt   = _p_to_handle.block_count();
-			void* addr   = tx_sink()->packet_content(_p_to_handle);
+			char* addr   = tx_sink()->packet_content(_p_to_handle);
 			try {
-				_driver.io(write, off, cnt, addr, *this, _p_to_handle);
+				if (num)
+					_driver.io(op, _ranges, num, _p_to_handle.flags(),
+					           addr + _p_to_handle.data_offset(),
+					           *this, _p_to_handle);
+				else
+					_driver.io(op, off, cnt, _p_to_handle.flags(),
+					           addr, *this, _p_to_handle);
 			} catch (Block::Session::Tx::Source::Packet_alloc_failed) {
 				_req_queue_full = true;
 				Session_component::wait_queue().insert(this);
@@ -144,11 +198,13 @@ class Block::Session_component : public Block::Session_rpc_object,
 		void dispatch(Packet_descriptor &request, Packet_descriptor &reply)
 		{
 			if (request.operation() == Block::Packet_descriptor::READ) {
-				void *src =
+				char *src =
 					_driver.session().tx()->packet_content(reply);
+				char *dst = tx_sink()->packet_content(request);
 				Genode::size_t sz =
 					request.block_count() * _driver.blk_size();
-				Genode::memcpy(tx_sink()->packet_content(request), src, sz);
+				Genode::memcpy(dst + request.data_offset(),
+				               src + reply.data_offset(), sz);
 			}
 			request.succeeded(reply.succeeded());
 			_ack_packet(request);
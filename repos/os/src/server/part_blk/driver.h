@@ -5,7 +5,7 @@
  */
 
 /*
- * Copyright (C) 2013 Genode Labs GmbH
+ * Copyright (C) 2013-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -131,27 +131,58 @@ class Block::Driver
 
 		static Driver& driver();
 
-		void io(bool write, sector_t nr, Genode::size_t cnt, void* addr,
-		        Block_dispatcher &dispatcher, Packet_descriptor& cli)
+		void io(Packet_descriptor::Opcode op, sector_t nr, Genode::size_t cnt,
+		        unsigned flags, void* addr, Block_dispatcher &dispatcher,
+		        Packet_descriptor& cli)
 		{
 			if (!_session.tx()->ready_to_submit())
 				throw Block::Session::Tx::Source::Packet_alloc_failed();
 
-			Block::Packet_descriptor::Opcode op = write
-			    ? Block::Packet_descriptor::WRITE
-			    : Block::Packet_descriptor::READ;
-			Genode::size_t size = _blk_size * cnt;
+			Genode::size_t size = op == Packet_descriptor::TRIM
+			                    ? 0 : _blk_size * cnt;
 			Packet_descriptor p(_session.dma_alloc_packet(size),
-			                    op,  nr, cnt);
+			                    op,  nr, cnt, flags);
 			Request *r = new (&_r_slab) Request(dispatcher, cli, p);
 			_r_list.insert(r);
 
-			if (write)
+			if (op == Packet_descriptor::WRITE)
 				Genode::memcpy(_session.tx()->packet_content(p),
 				               addr, size);
 
 			_session.tx()->submit_packet(p);
 		}
+
+		/**
+		 * Submit multi-range request
+		 *
+		 * \param ranges  translated block ranges
+		 * \param data    data of all ranges, for write requests
+		 */
+		void io(Packet_descriptor::Opcode op, Range const *ranges,
+		        unsigned num, unsigned flags, void* data,
+		        Block_dispatcher &dispatcher, Packet_descriptor& cli)
+		{
+			if (!_session.tx()->ready_to_submit())
+				throw Block::Session::Tx::Source::Packet_alloc_failed();
+
+			Genode::size_t data_size = 0;
+			if (op != Packet_descriptor::TRIM)
+				for (unsigned i = 0; i < num; i++)
+					data_size += ranges[i].block_count * _blk_size;
+
+			Packet_descriptor const alloc = _session.dma_alloc_packet(
+				Packet_descriptor::RANGE_TABLE_SIZE + data_size);
+			char *content = _session.tx()->packet_content(alloc);
+
+			Packet_descriptor p(alloc, op, content, ranges, num, flags);
+			Request *r = new (&_r_slab) Request(dispatcher, cli, p);
+			_r_list.insert(r);
+
+			if (op == Packet_descriptor::WRITE)
+				Genode::memcpy(content + p.data_offset(), data, data_size);
+
+			_session.tx()->submit_packet(p);
+		}
 };
 
 #endif /* _PART_BLK__DRIVER_H_ */
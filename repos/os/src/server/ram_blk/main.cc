@@ -1,5 +1,5 @@
 /*
- * \brief  Provide a RAM dataspace as writable block device
+ * \brief  Provide RAM dataspaces as writable block device
  * \author Stefan Kalkowski
  * \author Sebastian Sumpf
  * \author Josef Soentgen
@@ -31,15 +31,73 @@ class Ram_blk : public Block::Driver
 {
 	private:
 
+		/*
+		 * The backing store is split into chunks of separate RAM dataspaces.
+		 * Chunks are allocated on the first write and released when they
+		 * are trimmed completely. Unallocated chunks read as zeros.
+		 */
+		enum { CHUNK_SIZE = 1024*1024 };
+
+		typedef Attached_ram_dataspace Chunk;
+
 		Env       &_env;
-		Allocator *_alloc { nullptr };
+		Allocator &_alloc;
+
+		size_t   _size;
+		size_t   _block_size;
+		size_t   _block_count;
+		size_t   _chunk_count;
+		Chunk  **_chunks;
+
+		size_t _chunk_size(size_t i) const {
+			return min((size_t)CHUNK_SIZE, _size - i*CHUNK_SIZE); }
+
+		Chunk &_chunk(size_t i)
+		{
+			if (!_chunks[i])
+				_chunks[i] = new (&_alloc)
+					Chunk(_env.ram(), _env.rm(), _chunk_size(i));
+
+			return *_chunks[i];
+		}
+
+		void _release(size_t i)
+		{
+			if (_chunks[i])
+				destroy(&_alloc, _chunks[i]);
+
+			_chunks[i] = nullptr;
+		}
+
+		/**
+		 * Call 'fn' for each chunk portion of the given byte range
+		 *
+		 * The arguments of 'fn' are the chunk index, the offset within the
+		 * chunk, the size of the portion, and the offset within the range.
+		 */
+		template <typename FN>
+		void _for_each_chunk(size_t offset, size_t size, FN const &fn)
+		{
+			for (size_t done = 0; done < size; ) {
+				size_t const i     = (offset + done) / CHUNK_SIZE;
+				size_t const local = (offset + done) % CHUNK_SIZE;
+				size_t const len   = min(size - done, _chunk_size(i) - local);
 
-		Attached_rom_dataspace *_rom_ds { nullptr };
-		size_t                  _size;
-		size_t                  _block_size;
-		size_t                  _block_count;
-		Attached_ram_dataspace  _ram_ds;
-		addr_t                  _ram_addr;
+				fn(i, local, len, done);
+				done += len;
+			}
+		}
+
+		bool _range_valid(Block::sector_t block_number, size_t block_count)
+		{
+			/* sanity check block number */
+			if (block_number + block_count > _block_count) {
+				Genode::warning("requested blocks ", block_number, "-",
+				                block_number + block_count," out of range!");
+				return false;
+			}
+			return true;
+		}
 
 		void _io(Block::sector_t           block_number,
 		         size_t                    block_count,
@@ -47,58 +105,93 @@ class Ram_blk : public Block::Driver
 		         Block::Packet_descriptor &packet,
 		         bool                      read)
 		{
-			/* sanity check block number */
-			if (block_number + block_count > _block_count) {
-				Genode::warning("requested blocks ", block_number, "-",
-				                block_number + block_count," out of range!");
+			if (!_range_valid(block_number, block_count))
 				return;
-			}
 
 			size_t offset = (size_t) block_number * _block_size;
 			size_t size   = block_count  * _block_size;
 
-			void *src = read ? (void *)(_ram_addr + offset) : (void *)buffer;
-			void *dst = read ? (void *)buffer : (void *)(_ram_addr + offset);
-			/* copy file content to packet payload */
-			memcpy(dst, src, size);
+			try {
+				_for_each_chunk(offset, size, [&] (size_t i, size_t local,
+				                                   size_t len, size_t done) {
+					if (read && !_chunks[i]) {
+						memset(buffer + done, 0, len);
+						return;
+					}
+
+					char *chunk = _chunk(i).local_addr<char>() + local;
+
+					/* copy file content to packet payload */
+					if (read)
+						memcpy(buffer + done, chunk, len);
+					else
+						memcpy(chunk, buffer + done, len);
+				});
+			} catch (...) {
+				Genode::error("could not allocate backing store");
+				ack_packet(packet, false);
+				return;
+			}
 
 			ack_packet(packet);
 		}
 
+		void _init(size_t size)
+		{
+			_chunk_count = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+			if (!_alloc.alloc(_chunk_count*sizeof(Chunk *), &_chunks))
+				throw Allocator::Out_of_memory();
+
+			for (size_t i = 0; i < _chunk_count; i++)
+				_chunks[i] = nullptr;
+		}
+
 	public:
 
 		/**
-		 * Construct populated RAM dataspace
+		 * Construct backing store populated by ROM module
 		 */
 		Ram_blk(Env &env, Allocator &alloc,
 		        const char *name, size_t block_size)
 		:
-			_env(env), _alloc(&alloc),
-			_rom_ds(new (_alloc) Attached_rom_dataspace(_env, name)),
-			_size(_rom_ds->size()),
+			_env(env), _alloc(alloc),
+			_size(0),
 			_block_size(block_size),
-			_block_count(_size/_block_size),
-			_ram_ds(_env.ram(), _env.rm(), _size),
-			_ram_addr((addr_t)_ram_ds.local_addr<addr_t>())
+			_block_count(0)
 		{
+			Attached_rom_dataspace rom(_env, name);
+
+			_size        = rom.size();
+			_block_count = _size/_block_size;
+			_init(_size);
+
 			/* populate backing store from file */
-			memcpy(_ram_ds.local_addr<void>(), _rom_ds->local_addr<void>(), _size);
+			char const *src = rom.local_addr<char const>();
+			for (size_t i = 0; i < _chunk_count; i++)
+				memcpy(_chunk(i).local_addr<void>(), src + i*CHUNK_SIZE,
+				       _chunk_size(i));
 		}
 
 		/**
-		 * Construct empty RAM dataspace
+		 * Construct empty backing store
 		 */
-		Ram_blk(Env &env, size_t size, size_t block_size)
+		Ram_blk(Env &env, Allocator &alloc, size_t size, size_t block_size)
 		:
-			_env(env),
+			_env(env), _alloc(alloc),
 			_size(size),
 			_block_size(block_size),
-			_block_count(_size/_block_size),
-			_ram_ds(_env.ram(), _env.rm(), _size),
-			_ram_addr((addr_t)_ram_ds.local_addr<addr_t>())
-		{ }
+			_block_count(_size/_block_size)
+		{
+			_init(_size);
+		}
 
-		~Ram_blk() { destroy(_alloc, _rom_ds); }
+		~Ram_blk()
+		{
+			for (size_t i = 0; i < _chunk_count; i++)
+				_release(i);
+
+			_alloc.free(_chunks, _chunk_count*sizeof(Chunk *));
+		}
 
 
 		/****************************
@@ -113,6 +206,7 @@ class Ram_blk : public Block::Driver
 			Block::Session::Operations o;
 			o.set_operation(Block::Packet_descriptor::READ);
 			o.set_operation(Block::Packet_descriptor::WRITE);
+			o.set_operation(Block::Packet_descriptor::TRIM);
 			return o;
 		}
 
@@ -131,6 +225,26 @@ class Ram_blk : public Block::Driver
 		{
 			_io(block_number, block_count, const_cast<char *>(buffer), packet, false);
 		}
+
+		void trim(Block::sector_t           block_number,
+		          size_t                    block_count,
+		          Block::Packet_descriptor &packet)
+		{
+			if (!_range_valid(block_number, block_count))
+				return;
+
+			/* release chunks trimmed completely, zero partially trimmed ones */
+			_for_each_chunk((size_t)block_number * _block_size,
+			                block_count * _block_size,
+			                [&] (size_t i, size_t local, size_t len, size_t) {
+				if (len == _chunk_size(i))
+					_release(i);
+				else if (_chunks[i])
+					memset(_chunks[i]->local_addr<char>() + local, 0, len);
+			});
+
+			ack_packet(packet);
+		}
 };
 
 
@@ -183,7 +297,7 @@ struct Main
 				} else {
 					Genode::log("Creating RAM-based block device with size ",
 					            size, " and block size ", block_size);
-					return new (&alloc) Ram_blk(env, size, block_size);
+					return new (&alloc) Ram_blk(env, alloc, size, block_size);
 				}
 			} catch (...) {
 				throw Root::Unavailable();
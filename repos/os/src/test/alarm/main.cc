@@ -2,10 +2,14 @@
  * \brief  Test for alarm library
  * \author Norman Feske
  * \date   2008-11-05
+ *
+ * Before exercising the alarms with real time, the test measures the costs
+ * of scheduling, discarding, and handling alarms for different numbers of
+ * concurrently scheduled alarms.
  */
 
 /*
- * Copyright (C) 2008-2013 Genode Labs GmbH
+ * Copyright (C) 2008-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -15,7 +19,9 @@
 #include <base/thread.h>
 #include <base/sleep.h>
 #include <base/printf.h>
+#include <base/log.h>
 #include <timer_session/connection.h>
+#include <trace/timestamp.h>
 
 using namespace Genode;
 
@@ -103,8 +109,107 @@ class Periodic_alarm : public Alarm
 };
 
 
+/***************
+ ** Benchmark **
+ ***************/
+
+struct Bench_alarm : Alarm
+{
+	unsigned long triggered = 0;
+
+	bool on_alarm(unsigned) override
+	{
+		triggered++;
+		return false;
+	}
+};
+
+
+enum { MAX_BENCH_ALARMS = 16*1024 };
+
+/*
+ * The alarms are reused by each benchmark round. After a round, each alarm
+ * is discarded such that it no longer refers to the round's scheduler.
+ */
+static Bench_alarm bench_alarms[MAX_BENCH_ALARMS];
+
+
+static bool benchmark(unsigned const num)
+{
+	using Genode::Trace::timestamp;
+	using Genode::Trace::Timestamp;
+
+	Alarm_scheduler scheduler;
+
+	/* let the deadlines wrap around during the round */
+	Alarm::Time const start = ~0UL - 2*num;
+	Alarm::Time const range = 4*num;
+	scheduler.handle(start);
+
+	unsigned long seed = 1;
+	auto random = [&] () {
+		seed = seed*1103515245 + 12345;
+		return (seed >> 16) % range; };
+
+	Timestamp const t0 = timestamp();
+
+	for (unsigned i = 0; i < num; i++)
+		scheduler.schedule_absolute(&bench_alarms[i], start + 1 + random());
+
+	Timestamp const t1 = timestamp();
+
+	for (unsigned i = 1; i < num; i += 2)
+		scheduler.discard(&bench_alarms[i]);
+
+	Timestamp const t2 = timestamp();
+
+	for (Alarm::Time t = 1; t <= range + 1; t++)
+		scheduler.handle(start + t);
+
+	Timestamp const t3 = timestamp();
+
+	/* same number of 'handle' calls without any pending alarm */
+	for (Alarm::Time t = 1; t <= range + 1; t++)
+		scheduler.handle(start + range + 1 + t);
+
+	Timestamp const t4 = timestamp();
+
+	unsigned long triggered = 0;
+	for (unsigned i = 0; i < num; i++) {
+		triggered += bench_alarms[i].triggered;
+		bench_alarms[i].triggered = 0;
+		scheduler.discard(&bench_alarms[i]);
+	}
+
+	if (triggered != num - num/2 || scheduler.next_deadline(nullptr)) {
+		Genode::error(num, " alarms: ", triggered, " triggered, "
+		              "expected ", num - num/2);
+		return false;
+	}
+
+	/* cost of triggering without the cost of the empty 'handle' calls */
+	Timestamp const handle_cycles  = t3 - t2;
+	Timestamp const idle_cycles    = t4 - t3;
+	Timestamp const trigger_cycles = handle_cycles > idle_cycles
+	                               ? handle_cycles - idle_cycles : 0;
+
+	Genode::log("alarms: ", num, " "
+	            "cycles/schedule: ", (t1 - t0)/num, " "
+	            "cycles/discard: ",  (t2 - t1)/(num/2), " "
+	            "cycles/trigger: ",  trigger_cycles/(num - num/2), " "
+	            "cycles/idle-handle: ", idle_cycles/(range + 1));
+	return true;
+}
+
+
 int main(int, char **)
 {
+	for (unsigned num = 16; num <= MAX_BENCH_ALARMS; num *= 4)
+		if (!benchmark(num))
+			return -1;
+
+	Genode::log("--- alarm benchmark finished ---");
+
 	static Alarm_thread alarm_thread;
 
 	static Periodic_alarm pa1("Period_1s",   &alarm_thread, 1000);
@@ -373,6 +373,128 @@ struct Violation_test : Test
 };
 
 
+/**
+ * Multi-range write with barrier and FUA, read back, and trim
+ */
+template <unsigned NUM_RANGES>
+struct Multi_range_test : Test
+{
+	enum { MAX_BLOCKS = NUM_RANGES*4 };
+
+	struct Request_failed : Block_exception
+	{
+		Request_failed(Block::Packet_descriptor &p)
+		: Block_exception(p.block_number(), p.block_count(),
+		                  p.operation() != Block::Packet_descriptor::READ) {}
+	};
+
+	struct Integrity_exception : Block_exception
+	{
+		Integrity_exception(Block::sector_t nr)
+		: Block_exception(nr, 1, false) {}
+
+		void print_error()
+		{
+			Genode::error("multi-range integrity check failed: block ", _nr);
+		}
+	};
+
+	Block::Range             ranges[NUM_RANGES];
+	Block::Packet_descriptor reply;
+	bool                     replied = false;
+
+	Multi_range_test(Genode::Entrypoint &ep, Genode::Heap &heap, unsigned timeo)
+	:
+		Test(ep, heap, 2*(Block::Packet_descriptor::RANGE_TABLE_SIZE
+		                  + MAX_BLOCKS*blk_sz), timeo)
+	{
+		/* disjoint ranges of 1 to 4 blocks, one range per 8 blocks */
+		for (unsigned i = 0; i < NUM_RANGES; i++) {
+			ranges[i].block_number = i*8 + (i % 2);
+			ranges[i].block_count  = 1 + (i % 4);
+		}
+	}
+
+	Block::Packet_descriptor submit(Block::Packet_descriptor::Opcode op,
+	                                unsigned flags, signed char val)
+	{
+		Genode::size_t const size = Block::Packet_descriptor::RANGE_TABLE_SIZE
+		                          + MAX_BLOCKS*blk_sz;
+		Block::Packet_descriptor const alloc = _session.dma_alloc_packet(size);
+		char *content = _session.tx()->packet_content(alloc);
+
+		Block::Packet_descriptor p(alloc, op, content, ranges, NUM_RANGES,
+		                           flags);
+
+		/* fill each block with its block number plus 'val' */
+		signed char *data = (signed char *)content + p.data_offset();
+		for (unsigned i = 0; i < NUM_RANGES; i++)
+			for (Block::sector_t nr = ranges[i].block_number;
+			     nr < ranges[i].block_number + ranges[i].block_count;
+			     nr++, data += blk_sz)
+				Genode::memset(data, (signed char)(nr + val), blk_sz);
+
+		replied = false;
+		_session.tx()->submit_packet(p);
+		while (!replied)
+			_handle_signal();
+
+		if (!reply.succeeded())
+			throw Request_failed(reply);
+
+		return reply;
+	}
+
+	void perform()
+	{
+		if (!blk_ops.supported(Block::Packet_descriptor::WRITE)
+		 || !blk_ops.multi_range() || test_cnt < NUM_RANGES*8)
+			return;
+
+		Genode::log("multi-range write/read/compare of ", (int)NUM_RANGES,
+		            " ranges");
+
+		using Block::Packet_descriptor;
+
+		signed char const val = 3;
+
+		Packet_descriptor w = submit(Packet_descriptor::WRITE,
+		                             Packet_descriptor::FUA |
+		                             Packet_descriptor::BARRIER, val);
+		_session.tx()->release_packet(w);
+
+		Packet_descriptor r = submit(Packet_descriptor::READ, 0, 0);
+		signed char const *data = (signed char const *)
+			_session.tx()->packet_content(r) + r.data_offset();
+		for (unsigned i = 0; i < NUM_RANGES; i++)
+			for (Block::sector_t nr = ranges[i].block_number;
+			     nr < ranges[i].block_number + ranges[i].block_count;
+			     nr++, data += blk_sz)
+				for (Genode::size_t j = 0; j < blk_sz; j++)
+					if (data[j] != (signed char)(nr + val))
+						throw Integrity_exception(nr);
+		_session.tx()->release_packet(r);
+
+		if (!blk_ops.supported(Packet_descriptor::TRIM))
+			return;
+
+		Genode::log("multi-range trim");
+		Packet_descriptor t = submit(Packet_descriptor::TRIM, 0, 0);
+		_session.tx()->release_packet(t);
+	}
+
+	void ack_avail()
+	{
+		 _handle = false;
+
+		while (_session.tx()->ack_avail()) {
+			reply   = _session.tx()->get_acked_packet();
+			replied = true;
+		}
+	}
+};
+
+
 template <typename TEST>
 void perform(Genode::Entrypoint &ep, Genode::Heap &heap, unsigned timeo_ms = 0)
 {
@@ -424,6 +546,9 @@ void Component::construct(Genode::Env &env)
 		perform<Read_test<Block::Session::TX_QUEUE_SIZE, 1> >(env.ep(), heap);
 		perform<Write_test<Block::Session::TX_QUEUE_SIZE, 8, 16> >(env.ep(), heap);
 		perform<Violation_test>(env.ep(), heap, 1000);
+		perform<Multi_range_test<4> >(env.ep(), heap, 1000);
+		perform<Multi_range_test<Block::Packet_descriptor::MAX_RANGES> >(
+			env.ep(), heap, 1000);
 
 		log("Tests finished successfully!");
 	} catch(Genode::Parent::Service_denied) {
@@ -64,6 +64,7 @@ class Driver : public Block::Driver
 			Block::Session::Operations ops;
 			ops.set_operation(Block::Packet_descriptor::READ);
 			ops.set_operation(Block::Packet_descriptor::WRITE);
+			ops.set_operation(Block::Packet_descriptor::TRIM);
 			return ops;
 		}
 
@@ -91,6 +92,17 @@ class Driver : public Block::Driver
 			               (void*)buffer, block_count * _size);
 			_packets.add(packet);
 		}
+
+		void trim(Block::sector_t           block_number,
+		          Genode::size_t            block_count,
+		          Block::Packet_descriptor &packet)
+		{
+			if (!_packets.avail_capacity())
+				throw Block::Driver::Request_congestion();
+			Genode::memset(&_blk_buf[block_number*_size], 0,
+			               block_count * _size);
+			_packets.add(packet);
+		}
 };
 
 
@@ -0,0 +1,63 @@
+/*
+ * \brief  Benchmark for the session routing of init
+ * \author Genode Labs
+ * \date   2016-08-30
+ *
+ * The component opens and closes a number of LOG sessions with distinct
+ * labels. Each session request is resolved by init according to the
+ * routing rules of the component, which makes the session-setup throughput
+ * depend on the routing of init.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <base/snprintf.h>
+#include <log_session/connection.h>
+#include <base/attached_rom_dataspace.h>
+#include <trace/timestamp.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Attached_rom_dataspace config { env, "config" };
+
+	unsigned const sessions = config.xml().attribute_value("sessions", 64U);
+	unsigned const labels   = config.xml().attribute_value("labels",   16U);
+
+	Main(Env &env) : env(env)
+	{
+		Trace::Timestamp const start = Trace::timestamp();
+
+		for (unsigned i = 0; i < sessions; i++) {
+			char label[32];
+			snprintf(label, sizeof(label), "session-%u", i % labels);
+
+			Log_connection log(env, Session_label(label));
+		}
+
+		Trace::Timestamp const cycles = Trace::timestamp() - start;
+
+		log("sessions: ", sessions, " cycles: ", cycles,
+		    " cycles/session: ", cycles/sessions);
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
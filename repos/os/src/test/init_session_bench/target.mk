@@ -0,0 +1,3 @@
+TARGET = test-init_session_bench
+SRC_CC = main.cc
+LIBS  += base
@@ -0,0 +1,290 @@
+/*
+ * \brief  Benchmark for the packet allocator
+ * \author Genode Labs
+ * \date   2016-09-03
+ *
+ * The benchmark keeps a number of packets allocated and repeatedly replaces
+ * a randomly chosen packet by a new one of a random size. It compares the
+ * 'Genode::Packet_allocator' with its former implementation, which searched
+ * the bit array for each allocation.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <os/packet_allocator.h>
+#include <trace/timestamp.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	class Legacy_packet_allocator;
+	struct Workload;
+	struct Main;
+}
+
+
+/**
+ * Former packet allocator, searching the bit array for each allocation
+ */
+class Test::Legacy_packet_allocator
+{
+	private:
+
+		Allocator      &_md_alloc;
+		size_t const    _block_size;
+		size_t const    _block_cnt;
+		void           *_bits;
+		Bit_array_base  _array;
+		addr_t const    _base;
+		addr_t          _next = 0;
+
+	public:
+
+		Legacy_packet_allocator(Allocator &md_alloc, size_t block_size,
+		                        addr_t base, size_t size)
+		:
+			_md_alloc(md_alloc), _block_size(block_size),
+			_block_cnt((size/block_size) - (size/block_size) % (sizeof(addr_t)*8)),
+			_bits(_md_alloc.alloc(_block_cnt/8)),
+			_array(_block_cnt, (addr_t *)_bits, true),
+			_base(base)
+		{ }
+
+		~Legacy_packet_allocator() { _md_alloc.free(_bits, _block_cnt/8); }
+
+		bool alloc(size_t size, void **out_addr)
+		{
+			addr_t const cnt = (size % _block_size) ? size / _block_size + 1
+			                                        : size / _block_size;
+			addr_t max = ~0UL;
+
+			do {
+				try {
+					for (addr_t i = _next & ~(cnt - 1); i < max; i += cnt) {
+						if (_array.get(i, cnt))
+							continue;
+
+						_array.set(i, cnt);
+						_next = i + cnt;
+						*out_addr = reinterpret_cast<void *>(i * _block_size
+						                                     + _base);
+						return true;
+					}
+				} catch (Bit_array_base::Invalid_index_access) { }
+
+				max = _next;
+				_next = 0;
+
+			} while (max != 0);
+
+			return false;
+		}
+
+		void free(void *addr, size_t size)
+		{
+			addr_t i   = (((addr_t)addr) - _base) / _block_size;
+			size_t cnt = (size % _block_size) ? size / _block_size + 1
+			                                  : size / _block_size;
+			try { _array.clear(i, cnt); } catch(...) { }
+			_next = i;
+		}
+};
+
+
+/**
+ * Allocation pattern of a typical packet-stream user
+ */
+struct Test::Workload
+{
+	char const *name;
+	size_t      block_size;
+	size_t      buffer_size;
+	unsigned    in_flight;
+	size_t      sizes[3];
+};
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	enum { OPS = 200*1000, BASE = 0x1000 };
+
+	struct Packet { void *addr; size_t size; };
+
+	unsigned long seed = 1;
+
+	unsigned random(unsigned range)
+	{
+		seed = seed*1103515245 + 12345;
+		return (seed >> 16) % range;
+	}
+
+	/**
+	 * Run workload and return the number of failed allocations
+	 *
+	 * \param owner  if not 0, array of flags per block used to detect
+	 *               overlapping allocations
+	 */
+	template <typename ALLOC>
+	unsigned run(ALLOC &alloc, Workload const &w, Packet *packets,
+	             bool *owner, bool &overlap)
+	{
+		unsigned failed = 0;
+		seed = 1;
+
+		auto mark = [&] (Packet const &p, bool used) {
+			if (!owner || !p.addr) return;
+			addr_t const first = ((addr_t)p.addr - BASE) / w.block_size;
+			addr_t const last  = ((addr_t)p.addr - BASE + p.size - 1) / w.block_size;
+			for (addr_t b = first; b <= last; b++) {
+				if (used && owner[b])
+					overlap = true;
+				owner[b] = used;
+			}
+		};
+
+		auto replace = [&] (Packet &p) {
+			if (p.addr) {
+				mark(p, false);
+				alloc.free(p.addr, p.size);
+			}
+			p.size = w.sizes[random(3)];
+			if (!alloc.alloc(p.size, &p.addr)) {
+				p.addr = nullptr;
+				failed++;
+			}
+			mark(p, true);
+		};
+
+		for (unsigned i = 0; i < w.in_flight; i++)
+			replace(packets[i]);
+
+		for (unsigned i = 0; i < OPS; i++)
+			replace(packets[random(w.in_flight)]);
+
+		for (unsigned i = 0; i < w.in_flight; i++)
+			if (packets[i].addr) {
+				mark(packets[i], false);
+				alloc.free(packets[i].addr, packets[i].size);
+				packets[i].addr = nullptr;
+			}
+
+		return failed;
+	}
+
+	template <typename ALLOC>
+	bool measure(char const *name, ALLOC &alloc, Workload const &w)
+	{
+		Allocator &md_alloc = heap;
+
+		Packet *packets = (Packet *)md_alloc.alloc(w.in_flight*sizeof(Packet));
+		for (unsigned i = 0; i < w.in_flight; i++)
+			packets[i] = Packet { nullptr, 0 };
+
+		size_t const blocks = w.buffer_size / w.block_size;
+		bool *owner = (bool *)md_alloc.alloc(blocks*sizeof(bool));
+		for (size_t i = 0; i < blocks; i++)
+			owner[i] = false;
+
+		/* validate the allocations, and warm up */
+		bool overlap = false;
+		run(alloc, w, packets, owner, overlap);
+
+		Trace::Timestamp const start = Trace::timestamp();
+		unsigned const failed = run(alloc, w, packets, nullptr, overlap);
+		Trace::Timestamp const cycles = Trace::timestamp() - start;
+
+		heap.free(owner, blocks*sizeof(bool));
+		heap.free(packets, w.in_flight*sizeof(Packet));
+
+		if (overlap) {
+			error(name, " allocator returned overlapping packets");
+			return false;
+		}
+
+		log("workload: ", w.name, " allocator: ", name, " "
+		    "failed: ", failed, " cycles/op: ", cycles/(OPS + w.in_flight));
+		return true;
+	}
+
+	/**
+	 * Check that releasing a packet twice does not corrupt the free lists
+	 */
+	bool double_free()
+	{
+		enum { BLOCK_SIZE = 512, BUFFER_SIZE = 64*BLOCK_SIZE, SIZE = 1514 };
+
+		Packet_allocator alloc(&heap, BLOCK_SIZE);
+		alloc.add_range(BASE, BUFFER_SIZE);
+
+		void *a = nullptr, *b = nullptr, *c = nullptr;
+		alloc.alloc(SIZE, &a);
+		alloc.free(a, SIZE);
+		alloc.free(a, SIZE);
+
+		bool const ok = alloc.alloc(SIZE, &b) && alloc.alloc(SIZE, &c)
+		             && b != c;
+
+		alloc.remove_range(BASE, BUFFER_SIZE);
+
+		if (!ok)
+			error("double release of a packet corrupted the allocator");
+		return ok;
+	}
+
+	bool benchmark(Workload const &w)
+	{
+		{
+			Legacy_packet_allocator alloc(heap, w.block_size, BASE, w.buffer_size);
+			if (!measure("legacy", alloc, w))
+				return false;
+		}
+		{
+			Packet_allocator alloc(&heap, w.block_size);
+			alloc.add_range(BASE, w.buffer_size);
+			bool const ok = measure("size-class", alloc, w);
+			alloc.remove_range(BASE, w.buffer_size);
+			return ok;
+		}
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- packet-allocator benchmark ---");
+
+		static Workload const workloads[] = {
+			{ "nic",   1600, 1024*1600,       512, {   60,   590,  1514 } },
+			{ "block",  512, 4*1024*1024,     256, { 4096,  4096,  4096 } },
+			{ "fs",     512, 8*1024*1024,      64, {  512,  4096, 65536 } },
+		};
+
+		if (!double_free()) {
+			env.parent().exit(-1);
+			return;
+		}
+
+		for (Workload const &w : workloads)
+			if (!benchmark(w)) {
+				env.parent().exit(-1);
+				return;
+			}
+
+		log("--- packet-allocator benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
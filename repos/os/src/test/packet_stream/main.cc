@@ -2,10 +2,13 @@
  * \brief  Test for the packet-streaming interface
  * \author Norman Feske
  * \date   2009-11-11
+ *
+ * After the functional tests, the test measures the packet throughput
+ * between a source thread and a sink thread for different batch sizes.
  */
 
 /*
- * Copyright (C) 2009-2013 Genode Labs GmbH
+ * Copyright (C) 2009-2016 Genode Labs GmbH
  *
  * This file is part of the Genode OS framework, which is distributed
  * under the terms of the GNU General Public License version 2.
@@ -301,6 +304,135 @@ void test_2_flood_submit(Timer::Session *timer, Source *source, Sink *sink)
 }
 
 
+/***************
+ ** Benchmark **
+ ***************/
+
+typedef Genode::Packet_stream_policy<Genode::Packet_descriptor, 256, 256, char>
+        Bench_packet_stream_policy;
+
+enum {
+	BENCH_MAX_BATCH   = 64,
+	BENCH_IN_FLIGHT   = 128, /* smaller than the ack-queue size */
+	BENCH_PACKET_SIZE = 64,
+};
+
+
+class Bench_source : public  Genode::Thread_deprecated<STACK_SIZE>,
+                     private Genode::Allocator_avl,
+                     public  Genode::Packet_stream_source<Bench_packet_stream_policy>
+{
+	private:
+
+		unsigned const _total;
+		unsigned const _batch;
+
+		void entry()
+		{
+			Packet_descriptor packets[BENCH_MAX_BATCH];
+
+			unsigned submitted = 0, acked = 0;
+			while (acked < _total) {
+
+				while (submitted < _total
+				    && submitted - acked + _batch <= BENCH_IN_FLIGHT) {
+
+					unsigned const n = Genode::min(_batch, _total - submitted);
+					for (unsigned i = 0; i < n; i++)
+						packets[i] = alloc_packet(BENCH_PACKET_SIZE);
+
+					submit_packets(packets, n);
+					submitted += n;
+				}
+
+				unsigned const n = get_acked_packets(packets, BENCH_MAX_BATCH);
+				for (unsigned i = 0; i < n; i++)
+					release_packet(packets[i]);
+
+				acked += n;
+			}
+		}
+
+	public:
+
+		Bench_source(Genode::Dataspace_capability ds_cap,
+		             unsigned total, unsigned batch)
+		:
+			Thread_deprecated("bench_source"),
+			Genode::Allocator_avl(Genode::env()->heap()),
+			Packet_stream_source<Bench_packet_stream_policy>(this, ds_cap),
+			_total(total), _batch(batch)
+		{ }
+};
+
+
+class Bench_sink : public Genode::Thread_deprecated<STACK_SIZE>,
+                   public Genode::Packet_stream_sink<Bench_packet_stream_policy>
+{
+	private:
+
+		unsigned const _total;
+		unsigned const _batch;
+
+		void entry()
+		{
+			Packet_descriptor packets[BENCH_MAX_BATCH];
+
+			for (unsigned processed = 0; processed < _total; ) {
+
+				unsigned const n = get_packets(packets, _batch);
+
+				acknowledge_packets(packets, n);
+				processed += n;
+			}
+		}
+
+	public:
+
+		Bench_sink(Genode::Dataspace_capability ds_cap,
+		           unsigned total, unsigned batch)
+		:
+			Thread_deprecated("bench_sink"),
+			Packet_stream_sink<Bench_packet_stream_policy>(ds_cap),
+			_total(total), _batch(batch)
+		{ }
+};
+
+
+void test_3_benchmark(Timer::Connection &timer, unsigned batch)
+{
+	using namespace Genode;
+
+	enum { TOTAL = 64*1024, TRANSPORT_DS_SIZE = 64*1024 };
+
+	Dataspace_capability ds_cap = env()->ram_session()->alloc(TRANSPORT_DS_SIZE);
+
+	{
+		Bench_source source(ds_cap, TOTAL, batch);
+		Bench_sink   sink(ds_cap, TOTAL, batch);
+
+		source.register_sigh_packet_avail(sink.sigh_packet_avail());
+		source.register_sigh_ready_to_ack(sink.sigh_ready_to_ack());
+		sink.register_sigh_ready_to_submit(source.sigh_ready_to_submit());
+		sink.register_sigh_ack_avail(source.sigh_ack_avail());
+
+		uint64_t const start_us = timer.now_us();
+
+		source.start();
+		sink.start();
+		source.join();
+		sink.join();
+
+		uint64_t const us = max(timer.now_us() - start_us, (uint64_t)1);
+
+		log("batch: ", batch, " packets: ", (unsigned)TOTAL, " "
+		    "us: ", us, " packets/s: ", (uint64_t)TOTAL*1000*1000/us);
+	}
+
+	env()->ram_session()->free(static_cap_cast<Ram_dataspace>(ds_cap));
+}
+
+
 using namespace Genode;
 
 int main(int, char **)
@@ -332,6 +464,10 @@ int main(int, char **)
 	log("waiting to settle down");
 	timer.msleep(2*1000);
 
+	log("\n-- test 3: packet throughput --");
+	for (unsigned batch = 1; batch <= BENCH_MAX_BATCH; batch *= 4)
+		test_3_benchmark(timer, batch);
+
 	log("--- end of packet stream test ---");
 	return 0;
 }
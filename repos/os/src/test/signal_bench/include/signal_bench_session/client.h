@@ -0,0 +1,39 @@
+/*
+ * \brief  Client-side interface of the signal-throughput benchmark
+ * \author Genode Labs
+ * \date   2016-08-27
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _SIGNAL_BENCH_SESSION__CLIENT_H_
+#define _SIGNAL_BENCH_SESSION__CLIENT_H_
+
+/* Genode includes */
+#include <base/rpc_client.h>
+
+/* local includes */
+#include <signal_bench_session/signal_bench_session.h>
+
+namespace Signal_bench { struct Session_client; }
+
+
+struct Signal_bench::Session_client : Genode::Rpc_client<Session>
+{
+	explicit Session_client(Genode::Capability<Session> session)
+	: Genode::Rpc_client<Session>(session) { }
+
+	Genode::Signal_context_capability context() override {
+		return call<Rpc_context>(); }
+
+	unsigned long received() override { return call<Rpc_received>(); }
+
+	unsigned long activations() override { return call<Rpc_activations>(); }
+};
+
+#endif /* _SIGNAL_BENCH_SESSION__CLIENT_H_ */
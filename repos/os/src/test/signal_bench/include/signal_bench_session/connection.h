@@ -0,0 +1,35 @@
+/*
+ * \brief  Connection to the receiver of the signal-throughput benchmark
+ * \author Genode Labs
+ * \date   2016-08-27
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _SIGNAL_BENCH_SESSION__CONNECTION_H_
+#define _SIGNAL_BENCH_SESSION__CONNECTION_H_
+
+/* Genode includes */
+#include <base/connection.h>
+
+/* local includes */
+#include <signal_bench_session/client.h>
+
+namespace Signal_bench { struct Connection; }
+
+
+struct Signal_bench::Connection : Genode::Connection<Session>, Session_client
+{
+	Connection(Genode::Env &env)
+	:
+		Genode::Connection<Session>(env, session(env.parent(), "ram_quota=4K")),
+		Session_client(cap())
+	{ }
+};
+
+#endif /* _SIGNAL_BENCH_SESSION__CONNECTION_H_ */
@@ -0,0 +1,56 @@
+/*
+ * \brief  Session interface of the signal-throughput benchmark
+ * \author Genode Labs
+ * \date   2016-08-27
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+#ifndef _SIGNAL_BENCH_SESSION__SIGNAL_BENCH_SESSION_H_
+#define _SIGNAL_BENCH_SESSION__SIGNAL_BENCH_SESSION_H_
+
+/* Genode includes */
+#include <session/session.h>
+#include <base/signal.h>
+#include <base/rpc.h>
+
+namespace Signal_bench { struct Session; }
+
+
+struct Signal_bench::Session : Genode::Session
+{
+	static const char *service_name() { return "Signal_bench"; }
+
+	/**
+	 * Return signal context served by the receiver
+	 */
+	virtual Genode::Signal_context_capability context() = 0;
+
+	/**
+	 * Return number of signals received so far
+	 */
+	virtual unsigned long received() = 0;
+
+	/**
+	 * Return number of signal-handler activations so far
+	 */
+	virtual unsigned long activations() = 0;
+
+
+	/*******************
+	 ** RPC interface **
+	 *******************/
+
+	GENODE_RPC(Rpc_context, Genode::Signal_context_capability, context);
+	GENODE_RPC(Rpc_received, unsigned long, received);
+	GENODE_RPC(Rpc_activations, unsigned long, activations);
+
+	GENODE_RPC_INTERFACE(Rpc_context, Rpc_received, Rpc_activations);
+};
+
+#endif /* _SIGNAL_BENCH_SESSION__SIGNAL_BENCH_SESSION_H_ */
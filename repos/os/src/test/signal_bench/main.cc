@@ -0,0 +1,86 @@
+/*
+ * \brief  Benchmark for the signal throughput between two components
+ * \author Genode Labs
+ * \date   2016-08-27
+ *
+ * The sender submits bursts of signals to a context provided by the
+ * receiver component and measures the time until the receiver has seen
+ * all signals. The ratio between submitted signals and activations of the
+ * receiver's signal handler shows how many submissions were coalesced.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+
+/* local includes */
+#include <signal_bench_session/connection.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	enum { ROUNDS = 5, SIGNALS_PER_ROUND = 100000 };
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Signal_bench::Connection receiver { env };
+
+	Signal_transmitter transmitter { receiver.context() };
+
+	void measure(unsigned round)
+	{
+		unsigned long const received_before    = receiver.received();
+		unsigned long const activations_before = receiver.activations();
+
+		unsigned long const start_ms = timer.elapsed_ms();
+
+		for (unsigned i = 0; i < SIGNALS_PER_ROUND; i++)
+			transmitter.submit();
+
+		unsigned long const submitted_ms = timer.elapsed_ms();
+
+		/* wait until the receiver has seen all signals */
+		while (receiver.received() - received_before < SIGNALS_PER_ROUND)
+			timer.usleep(100);
+
+		unsigned long const duration_ms = max(timer.elapsed_ms() - start_ms, 1UL);
+		unsigned long const activations = receiver.activations()
+		                                - activations_before;
+
+		log("round ", round, ": ", (unsigned)SIGNALS_PER_ROUND, " signals, "
+		    "submitted in ", submitted_ms - start_ms, " ms, "
+		    "received in ", duration_ms, " ms "
+		    "(", (SIGNALS_PER_ROUND*1000UL)/duration_ms, " signals/s), ",
+		    activations, " handler activations");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- signal benchmark started ---");
+
+		for (unsigned i = 0; i < ROUNDS; i++)
+			measure(i);
+
+		log("--- signal benchmark finished ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,84 @@
+/*
+ * \brief  Receiver of the signal-throughput benchmark
+ * \author Genode Labs
+ * \date   2016-08-27
+ *
+ * The receiver provides one signal context per session and counts the
+ * received signals as well as the activations of its signal handler.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <root/component.h>
+
+/* local includes */
+#include <signal_bench_session/signal_bench_session.h>
+
+namespace Signal_bench {
+
+	using namespace Genode;
+
+	struct Session_component;
+	struct Root;
+}
+
+
+struct Signal_bench::Session_component : Rpc_object<Session>,
+                                         Signal_dispatcher_base
+{
+	Entrypoint &ep;
+
+	Signal_context_capability const cap = ep.manage(*this);
+
+	unsigned long num_received    = 0;
+	unsigned long num_activations = 0;
+
+	Session_component(Entrypoint &ep) : ep(ep) { }
+
+	~Session_component() { ep.dissolve(*this); }
+
+	/**
+	 * Signal_dispatcher_base interface
+	 */
+	void dispatch(unsigned num) override
+	{
+		num_received += num;
+		num_activations++;
+	}
+
+	/**
+	 * Session interface
+	 */
+	Signal_context_capability context() override { return cap; }
+	unsigned long received()            override { return num_received; }
+	unsigned long activations()         override { return num_activations; }
+};
+
+
+struct Signal_bench::Root : Root_component<Session_component>
+{
+	Entrypoint &ep;
+
+	Session_component *_create_session(const char *) override {
+		return new (md_alloc()) Session_component(ep); }
+
+	Root(Entrypoint &ep, Allocator &md_alloc)
+	: Root_component<Session_component>(&ep.rpc_ep(), &md_alloc), ep(ep) { }
+};
+
+
+void Component::construct(Genode::Env &env)
+{
+	static Genode::Sliced_heap sliced_heap { env.ram(), env.rm() };
+	static Signal_bench::Root  root { env.ep(), sliced_heap };
+
+	env.parent().announce(env.ep().manage(root));
+}
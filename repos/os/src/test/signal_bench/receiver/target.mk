@@ -0,0 +1,4 @@
+TARGET   = test-signal_bench_receiver
+SRC_CC   = main.cc
+INC_DIR += $(PRG_DIR)/../include
+LIBS     = base
@@ -162,6 +162,36 @@ int main(int argc, char **argv)
 		i = 0, period_us /= 2, periods = PTEST_TIME_US / period_us;
 	}
 
+	/*
+	 * Check that the time obtained from the clock page is monotonic and
+	 * consistent with the time reported by the timer driver
+	 */
+	log("check clock page");
+	{
+		Genode::uint64_t last_us = main_timer.now_us();
+		for (unsigned j = 0; j < 20; j++) {
+			for (unsigned k = 0; k < 1000; k++) {
+				Genode::uint64_t const us = main_timer.now_us();
+				if (us < last_us) {
+					error("clock went backwards: ", last_us, " us -> ", us, " us");
+					return -1;
+				}
+				last_us = us;
+			}
+			main_timer.msleep(100);
+		}
+
+		enum { MAX_ERR_MS = 10 };
+		unsigned long const ms = main_timer.elapsed_ms();
+		unsigned long const clock_ms = main_timer.now_us() / 1000;
+		if (clock_ms + MAX_ERR_MS < ms || clock_ms > ms + MAX_ERR_MS) {
+			error("clock page deviates: ", clock_ms, " ms "
+			      "(elapsed ", ms, " ms)");
+			return -1;
+		}
+		log("clock page: ", clock_ms, " ms (elapsed ", ms, " ms)");
+	}
+
 	/* create timer clients with different periods */
 	for (unsigned period_msec = 1; period_msec < 28; period_msec++) {
 		Timer_client *tc = new (env()->heap()) Timer_client(period_msec);
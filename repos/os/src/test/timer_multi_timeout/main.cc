@@ -0,0 +1,144 @@
+/*
+ * \brief  Test for multiple timeouts within one timer session
+ * \author Genode Labs
+ * \date   2016-09-02
+ *
+ * The test programs a number of one-shot and periodic timeouts with a
+ * single request to the timer driver and checks that each timeout
+ * triggers as expected. Timeouts that trigger at the same time are
+ * signalled at once, which is reflected by the number of received signals.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/log.h>
+#include <timer_session/connection.h>
+#include <timer_session/multi_timeout.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Main;
+}
+
+
+struct Test::Main
+{
+	enum {
+		NUM_ONE_SHOT = 100,
+		NUM_PERIODIC = 4,
+		END_ID       = NUM_ONE_SHOT + NUM_PERIODIC,
+		STEP_US      = 1000,
+		PERIOD_US    = 10*1000,
+		DURATION_US  = 300*1000,
+
+		/* tolerated deviation of the local clock from the driver time */
+		SLACK_US     = 2000,
+	};
+
+	Env &env;
+
+	Timer::Connection timer { env };
+
+	Signal_handler<Main> handler { env.ep(), *this, &Main::handle };
+
+	Timer::Multi_timeout timeouts { env.rm(), timer, handler };
+
+	uint64_t const start_us = timer.now_us();
+
+	unsigned fired[Timer::Timeout_table::MAX_TIMEOUTS] { };
+	unsigned signals   = 0;
+	unsigned triggered = 0;
+
+	void fail()
+	{
+		error("test failed");
+		env.parent().exit(-1);
+	}
+
+	void handle()
+	{
+		signals++;
+
+		uint64_t const now_us = timer.now_us() - start_us;
+
+		bool early = false, end = false;
+		timeouts.for_each_fired([&] (unsigned id) {
+
+			triggered++;
+			fired[id]++;
+
+			if (id < NUM_ONE_SHOT && now_us + SLACK_US < (id + 1)*STEP_US) {
+				error("timeout ", id, " triggered early at ", now_us, " us");
+				early = true;
+			}
+
+			if (id == END_ID)
+				end = true;
+		});
+
+		if (early) {
+			fail();
+			return;
+		}
+
+		if (end)
+			finish();
+	}
+
+	void finish()
+	{
+		for (unsigned i = 0; i < NUM_PERIODIC; i++)
+			timeouts.discard(NUM_ONE_SHOT + i);
+		timeouts.apply();
+
+		for (unsigned i = 0; i < NUM_ONE_SHOT; i++) {
+			if (fired[i] != 1) {
+				error("one-shot timeout ", i, " triggered ", fired[i], " times");
+				fail();
+				return;
+			}
+		}
+
+		unsigned const min_periods = DURATION_US/PERIOD_US/2;
+		for (unsigned i = 0; i < NUM_PERIODIC; i++) {
+			unsigned const n = fired[NUM_ONE_SHOT + i];
+			if (n < min_periods) {
+				error("periodic timeout ", i, " triggered ", n, " times "
+				      "(min ", min_periods, ")");
+				fail();
+				return;
+			}
+		}
+
+		log("timeouts triggered: ", triggered, " signals: ", signals);
+		log("--- timer multi-timeout test finished ---");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- timer multi-timeout test ---");
+
+		for (unsigned i = 0; i < NUM_ONE_SHOT; i++)
+			timeouts.trigger_once(i, (i + 1)*STEP_US);
+
+		for (unsigned i = 0; i < NUM_PERIODIC; i++)
+			timeouts.trigger_periodic(NUM_ONE_SHOT + i, PERIOD_US);
+
+		timeouts.trigger_once(END_ID, DURATION_US);
+
+		/* pass all timeouts to the timer driver at once */
+		timeouts.apply();
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -0,0 +1,3 @@
+TARGET = test-timer_multi_timeout
+SRC_CC = main.cc
+LIBS  += base
@@ -0,0 +1,167 @@
+/*
+ * \brief  Benchmark for parsing and iterating XML nodes
+ * \author Genode Labs
+ * \date   2016-08-29
+ *
+ * The benchmark generates init-like configurations with a varying number of
+ * '<start>' nodes and measures typical access patterns once with plain
+ * 'Xml_node' objects and once with nodes obtained from an 'Xml_index'.
+ */
+
+/*
+ * Copyright (C) 2016 Genode Labs GmbH
+ *
+ * This file is part of the Genode OS framework, which is distributed
+ * under the terms of the GNU General Public License version 2.
+ */
+
+/* Genode includes */
+#include <base/component.h>
+#include <base/heap.h>
+#include <base/log.h>
+#include <base/snprintf.h>
+#include <util/xml_node.h>
+#include <util/xml_generator.h>
+#include <trace/timestamp.h>
+
+namespace Test {
+
+	using namespace Genode;
+
+	struct Config;
+	struct Main;
+}
+
+
+/**
+ * Generated configuration with a given number of '<start>' nodes
+ */
+struct Test::Config
+{
+	Allocator &alloc;
+	size_t const size;
+	char * const buf = (char *)alloc.alloc(size);
+
+	Config(Allocator &alloc, unsigned num_start_nodes)
+	:
+		alloc(alloc), size(256*num_start_nodes + 4096)
+	{
+		Xml_generator xml(buf, size, "config", [&] () {
+			xml.node("parent-provides", [&] () {
+				xml.node("service", [&] () { xml.attribute("name", "LOG"); });
+				xml.node("service", [&] () { xml.attribute("name", "ROM"); });
+			});
+			for (unsigned i = 0; i < num_start_nodes; i++) {
+				char name[32];
+				snprintf(name, sizeof(name), "component-%u", i);
+				xml.node("start", [&] () {
+					xml.attribute("name", name);
+					xml.attribute("priority", -1);
+					xml.attribute("caps", 100 + i);
+					xml.node("resource", [&] () {
+						xml.attribute("name", "RAM");
+						xml.attribute("quantum", 1024*1024 + i);
+					});
+					xml.node("route", [&] () {
+						xml.node("any-service", [&] () {
+							xml.node("parent"); });
+					});
+				});
+			}
+		});
+	}
+
+	~Config() { alloc.free(buf, size); }
+
+	Xml_node xml() const { return Xml_node(buf, size); }
+};
+
+
+struct Test::Main
+{
+	Env &env;
+
+	Heap heap { env.ram(), env.rm() };
+
+	unsigned long checksum = 0;
+
+	/**
+	 * Access sub nodes by index, attributes and sub nodes by type
+	 */
+	void _visit_by_index(Xml_node config)
+	{
+		unsigned const num = config.num_sub_nodes();
+		for (unsigned i = 0; i < num; i++) {
+			Xml_node const node = config.sub_node(i);
+			if (!node.has_type("start"))
+				continue;
+
+			checksum += node.attribute_value("caps", 0UL);
+			checksum += node.sub_node("resource")
+			                .attribute_value("quantum", 0UL);
+		}
+	}
+
+	/**
+	 * Walk the sub nodes via 'next' as done by 'for_each_sub_node'
+	 */
+	void _visit_by_iteration(Xml_node config)
+	{
+		config.for_each_sub_node("start", [&] (Xml_node node) {
+			checksum += node.attribute_value("caps", 0UL); });
+	}
+
+	template <typename FN>
+	Trace::Timestamp _measure(FN const &fn)
+	{
+		Trace::Timestamp const start = Trace::timestamp();
+		fn();
+		return Trace::timestamp() - start;
+	}
+
+	void _bench(unsigned num_start_nodes)
+	{
+		Config config(heap, num_start_nodes);
+
+		Trace::Timestamp const plain_index = _measure([&] () {
+			_visit_by_index(config.xml()); });
+
+		Trace::Timestamp const plain_iter = _measure([&] () {
+			_visit_by_iteration(config.xml()); });
+
+		Trace::Timestamp build = 0, indexed_index = 0, indexed_iter = 0;
+		{
+			Xml_node const xml = config.xml();
+
+			build = _measure([&] () { Xml_index index(heap, xml); });
+
+			Xml_index index(heap, xml);
+
+			indexed_index = _measure([&] () {
+				_visit_by_index(index.xml()); });
+
+			indexed_iter = _measure([&] () {
+				_visit_by_iteration(index.xml()); });
+		}
+
+		log(num_start_nodes, " start nodes: "
+		    "by index ", plain_index / num_start_nodes, " -> ",
+		    indexed_index / num_start_nodes, " cycles/node, "
+		    "iteration ", plain_iter / num_start_nodes, " -> ",
+		    indexed_iter / num_start_nodes, " cycles/node, "
+		    "index build ", build / num_start_nodes, " cycles/node");
+	}
+
+	Main(Env &env) : env(env)
+	{
+		log("--- XML-node benchmark started ---");
+
+		for (unsigned num = 16; num <= 2048; num *= 2)
+			_bench(num);
+
+		log("--- XML-node benchmark finished (checksum ", checksum, ") ---");
+	}
+};
+
+
+void Component::construct(Genode::Env &env) { static Test::Main main(env); }
@@ -93,6 +93,12 @@ class Gdb_monitor::Pd_session_component : public Rpc_object<Pd_session>
 		void submit(Capability<Signal_context> context, unsigned cnt) override {
 			_pd.submit(context, cnt); }
 
+		bool signal_page(Capability<Dataspace> page) override {
+			return _pd.signal_page(page); }
+
+		unsigned signal_slot(Capability<Signal_context> context) override {
+			return _pd.signal_slot(context); }
+
 		Native_capability alloc_rpc_cap(Native_capability ep) override {
 			return _pd.alloc_rpc_cap(ep); }
 